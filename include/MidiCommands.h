@@ -160,6 +160,18 @@
 #define CMD_UART_CONFIRMATION_ANIMATION 0xA5
 #define CMD_LED_GRID_UPDATE_14 0xA6
 #define CMD_LED_PAD_UPDATE_14  0xA7
+#define CMD_BATCH              0xA8  // Container: [CMD][LEN][PAYLOAD...] repeated (UART links)
+#define CMD_LED_GRID_DELTA     0xA9  // [mask0..mask3 LSB first][R,G,B 8-bit per set bit, ascending pad]
+#define CMD_LINK_BAUD          0xAB  // [BAUD_CODE] switch request / echo (UART links; 0xAA is SYNC)
+#define CMD_STATS              0xAC  // Empty: poll. Reply: LinkHealth blocks (see shared/LinkHealth.h)
+#define CMD_PROFILE            0xAD  // GUI link. Empty: poll. Reply: Live ingest profile frames (LiveCommandProfiler.h)
+#define CMD_METER_FRAME        0xAE  // GUI link: [first_track, count] + count × [level, peak] (LiveMeterStage.h)
+#define CMD_POSITION_FRAME     0xAF  // GUI link: count × [track|0x7F song, scene, hi, lo] (ClipPositionEstimator.h)
+#define CMD_NAME_DEFINE        0xB4  // GUI link (CAP_NAME_IDS): [id_hi, id_lo, name...] (NamePool.h)
+#define CMD_NAME_REF           0xB5  // GUI link (CAP_NAME_IDS): [kind 0 track/1 clip/2 scene, index, scene, id_hi, id_lo]
+#define CMD_LED_PAD_FULL       0xB6  // M4 link (CAP_LED_PAD_FULL): [pad, state, R, G, B 8-bit]
+#define CMD_LED_PAD_FULL_BULK  0xB7  // M4 link (CAP_LED_PAD_FULL): [mask0..mask3 LSB first][state, R, G, B per set bit]
+#define LED_PAD_STATE_KEEP     0x7F  // State byte of a color-only change: the M4 keeps the pad's state
 #define CMD_LED_CLIP_STATE     0x80
 #define CMD_LED_TRACK_STATE    0x81
 #define CMD_LED_TRANSPORT_STATE 0x82
@@ -200,6 +212,21 @@
 #define CMD_SESSION_RING_METADATA 0x9A  // Bulk session ring metadata (tracks/scenes names+colors) (Live → Hardware)
 #define CMD_SESSION_RING_CLIPS    0x9B  // Bulk session ring clips (32 clips states+colors) (Live → Hardware)
 
+// === RESYNC ===
+// Hardware → Live: resend only the areas in [areas] after lost frames
+// (0x01 grid, 0x02 names, 0x04 mixer, 0x08 transport). Shares its ID with
+// CMD_VIEW_STATE, which only flows Live → Hardware: IDs towards Live are 7-bit.
+#define CMD_RESYNC_REQUEST        CMD_VIEW_STATE
+
+// === CLIP PREFETCH ===
+// Hardware → Live: clip states of a window of the set outside the ring,
+// [track_msb, track_lsb, scene_msb, scene_lsb, width, height]. Shares its ID
+// with CMD_SESSION_OVERVIEW_GRID, which only flows Live → Hardware.
+#define CMD_CLIP_WINDOW_REQUEST   CMD_SESSION_OVERVIEW_GRID
+// Live → Hardware: the same 6-byte header + width*height × [state, R, G, B]
+// (7-bit colors), column-major like CMD_SESSION_RING_CLIPS
+#define CMD_CLIP_WINDOW           0x9C
+
 // === NAVEGACIÓN DE GRID (para GUI) ===
 #define CMD_GRID_SHIFT_LEFT    0xB0
 #define CMD_GRID_SHIFT_RIGHT   0xB1
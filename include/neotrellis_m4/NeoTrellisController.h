@@ -33,6 +33,7 @@ public:
     void applyPadColor7bit(int pad, uint8_t r7, uint8_t g7, uint8_t b7, bool pushNow = true);
     void applyGridColors14bit(const uint8_t* rgb14, int length);
     void applyPadColor8bit(int pad, uint8_t r8, uint8_t g8, uint8_t b8, bool pushNow = true);
+    void showPixels() { pixels.show(); }
 
     void setGridInitialized(bool v) { gridInitialized = v; }
 
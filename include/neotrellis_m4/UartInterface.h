@@ -2,22 +2,35 @@
 
 #include <Arduino.h>
 #include "shared/Config.h"
+#include "shared/BinaryProtocol.h"
+#include "shared/FrameParser.h"
+#include "shared/LinkBaud.h"
+#include "shared/LinkHealth.h"
 
 class UartInterface {
 public:
     void begin();
     void read();
     void sendToTeensy(uint8_t command, uint8_t* data, int length);
+    LinkHealth getHealth() const;
 
 private:
-    static const int BUFFER_SIZE = 256;
-    uint8_t rxBuffer[BUFFER_SIZE];
-    int rxIndex;
-    bool messageComplete;
+    FrameParser<BinaryProtocol::MAX_EXT_FRAME_SIZE> parser;
     bool everReceived = false;
     unsigned long beginMs = 0;
-    uint16_t expectedPacketLength = 0;
+    BinaryProtocol::LinkMode linkMode;
+    LinkBaud baud;
+    LinkRateMeter meter;
+    uint32_t framesSent = 0;
+    uint32_t bytesSent = 0;
+    uint32_t txDropped = 0;
+    bool inBatch = false; // Pad updates defer pixels.show() until the batch ends
     
-    void parseMessage();
+    void handleFrame(const FrameView& frame);
+    bool acceptsSyncFrame(uint8_t command, const uint8_t* payload, uint16_t length) const;
+    void handleHandshake(const uint8_t* data, int length);
+    void handleLinkBaud(const uint8_t* data, int length);
+    void sendStats();
+    void handleBatch(uint8_t* data, int length);
     void handleTeensyCommand(uint8_t command, uint8_t* data, int length);
 };
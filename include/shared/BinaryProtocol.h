@@ -2,52 +2,581 @@
 
 #include <Arduino.h>
 #include <cstring>
+#include "MidiCommands.h"
 
 // Simple binary framing used between Teensy ↔ NeoTrellis over UART:
 // [SYNC][CMD][LEN][PAYLOAD...][CHECKSUM]
 // SYNC is fixed (0xAA) so receivers can resync quickly.
 // The checksum is an XOR of CMD, LEN and each payload byte.
+//
+// COBS framing (negotiated at handshake) carries the same body
+// [CMD][LEN][PAYLOAD...][CHECKSUM] COBS-encoded between 0x00 delimiters:
+// [0x00][COBS(body)][0x00]. Encoded bytes are never 0x00, so payload data can
+// not fake a frame start and a receiver resyncs at the very next delimiter.
+// The leading delimiter flushes any garbage left by a peer that still talks
+// SYNC framing, so no COBS frame is lost after a mode change.
+//
+// The CHECKSUM trailer is negotiated too: XOR (1 byte, legacy), CRC-8
+// (poly 0x07, 1 byte) or CRC-16/CCITT-FALSE (poly 0x1021, 2 bytes MSB first).
+// Both CRCs cover CMD, LEN and the payload and are table-driven.
+//
+// CMD_BATCH frames (negotiated) pack several small messages into one payload:
+// [CMD][LEN][PAYLOAD...] repeated. The outer checksum covers every entry;
+// batches never nest and never carry link-control commands.
+//
+// Payloads over 254 bytes (negotiated) use an extended length field:
+// LEN = 0xFF followed by a 16-bit length, MSB first. Shorter payloads always
+// use the 1-byte form, so every length has exactly one encoding. Checksums
+// cover the length bytes as sent. FrameEncoder streams a frame in chunks, so
+// a large payload never needs one contiguous buffer.
+//
+// Payloads can also be given as a list of Slices (scatter-gather): a small
+// header array plus a view into a received SysEx frame or a cached name is
+// framed without first copying them into one payload buffer.
+//
+// The capability block also carries each side's fastest UART rate; after
+// the handshake the link moves to the lower of the two with CMD_LINK_BAUD
+// (see LinkBaud.h).
 // All functions here are header-only to avoid linking issues on both targets.
 class BinaryProtocol {
 public:
     static constexpr uint8_t BINARY_SYNC_BYTE = 0xAA;
     static constexpr uint8_t HEADER_SIZE = 4; // SYNC + CMD + LEN + CHECKSUM
+    static constexpr uint8_t COBS_DELIMITER = 0x00;
+    static constexpr uint8_t MAX_PAYLOAD_SIZE = 254;  // Largest 1-byte LEN
+    static constexpr uint8_t EXT_LEN_MARKER = 0xFF;   // LEN value announcing a 16-bit length
+    static constexpr uint16_t MAX_EXT_PAYLOAD_SIZE = 1024;
+    static constexpr uint8_t MAX_TRAILER_SIZE = 2;
+    static constexpr uint16_t FRAME_SIZE_INVALID = 0xFFFF;
+
+    enum class Framing : uint8_t {
+        SYNC = 0, // [0xAA][CMD][LEN][PAYLOAD...][CHECKSUM]
+        COBS = 1  // [0x00][COBS(CMD LEN PAYLOAD... CHECKSUM)][0x00]
+    };
+
+    enum class Integrity : uint8_t {
+        XOR = 0,   // 1-byte XOR (legacy)
+        CRC8 = 1,  // 1-byte CRC-8
+        CRC16 = 2  // 2-byte CRC-16
+    };
+
+    // Per-link mode, settled during the handshake.
+    struct LinkMode {
+        Framing framing = Framing::SYNC;
+        Integrity integrity = Integrity::XOR;
+        bool batch = false;    // Peer unpacks CMD_BATCH frames
+        bool ledDelta = false; // Peer applies CMD_LED_GRID_DELTA frames
+        bool extLength = false; // Peer parses extended-length frames
+        bool nameIds = false;   // Peer resolves names sent as pool IDs (GUI link)
+        bool padFull = false;   // Peer applies combined state + color pad frames (M4 link)
+        uint16_t maxPayload = MAX_PAYLOAD_SIZE; // Largest payload the peer accepts
+        uint32_t maxBaud = 0;   // Fastest UART rate both sides offer (0: base rate only)
+    };
+
+    // Capability block appended to CMD_HANDSHAKE / CMD_HANDSHAKE_REPLY payloads:
+    // [ID string...][CAPS_SEPARATOR][CAPS][BAUD_CODE][MAX_LEN_MSB][MAX_LEN_LSB][CAPS2].
+    // ID strings are ASCII, so the first 0x00 marks the block. Every field is
+    // 7-bit; MAX_LEN is the largest payload accepted, 14 bits. CAPS holds
+    // flags 0x0001-0x0040 and CAPS2 flags 0x0080-0x2000. Peers that predate
+    // negotiation send no block and stay on SYNC framing; peers that send
+    // only [CAPS] stay on the base baud rate; peers that stop at MAX_LEN
+    // offer no CAPS2 flag.
+    static constexpr uint8_t CAPS_SEPARATOR = 0x00;
+    static constexpr uint8_t CAPS_BLOCK_SIZE = 6;
+    static constexpr uint8_t CAPS_BLOCK_SIZE_V1 = 5; // Without CAPS2
+    static constexpr uint16_t CAP_COBS = 0x0001;
+    static constexpr uint16_t CAP_CRC8 = 0x0002;
+    static constexpr uint16_t CAP_CRC16 = 0x0004;
+    static constexpr uint16_t CAP_BATCH = 0x0008;
+    static constexpr uint16_t CAP_LED_DELTA = 0x0010;
+    static constexpr uint16_t CAP_EXT_LEN = 0x0020;
+    static constexpr uint16_t CAP_NAME_IDS = 0x0040;     // GUI link: names by CMD_NAME_DEFINE / CMD_NAME_REF
+    static constexpr uint16_t CAP_LED_PAD_FULL = 0x0080; // M4 link: CMD_LED_PAD_FULL(_BULK) frames (CAPS2)
+
+    // What one side offers in its capability block.
+    struct LinkCaps {
+        uint16_t flags = 0;
+        uint32_t maxBaud = 0; // 0: no baud field, stay on the base rate
+        uint16_t maxPayload = MAX_PAYLOAD_SIZE;
+    };
+
+    // Rates a link may switch to after the handshake, by BAUD_CODE.
+    // CMD_LINK_BAUD carries one code.
+    static constexpr uint8_t BAUD_RATE_COUNT = 6;
+    static constexpr uint8_t BAUD_CODE_NONE = 0x7F;
+
+    static uint32_t baudRate(uint8_t code) {
+        static const uint32_t rates[BAUD_RATE_COUNT] = {
+            115200, 230400, 460800, 1000000, 2000000, 3000000
+        };
+        return code < BAUD_RATE_COUNT ? rates[code] : 0;
+    }
+
+    static uint8_t baudCode(uint32_t baud) {
+        for (uint8_t code = 0; code < BAUD_RATE_COUNT; ++code) {
+            if (baudRate(code) == baud) {
+                return code;
+            }
+        }
+        return BAUD_CODE_NONE;
+    }
+
+    static constexpr uint8_t BATCH_ENTRY_HEADER = 2; // CMD + LEN
+
+    // Link-control frames always travel SYNC-framed with an XOR checksum,
+    // whatever the link negotiated, so a peer that restarted is always heard.
+    static constexpr bool isLinkControl(uint8_t command) {
+        return command == CMD_HANDSHAKE ||
+               command == CMD_HANDSHAKE_REPLY ||
+               command == CMD_DISCONNECT;
+    }
+
+    static LinkMode modeFor(uint8_t command, const LinkMode& link) {
+        return isLinkControl(command) ? LinkMode() : link;
+    }
+
+    // What both sides can do: common flags, the slower maximum rate and the
+    // smaller maximum payload.
+    static LinkCaps agreeCaps(const LinkCaps& local, const LinkCaps& peer) {
+        LinkCaps agreed;
+        agreed.flags = local.flags & peer.flags;
+        agreed.maxBaud = (local.maxBaud && peer.maxBaud)
+            ? (local.maxBaud < peer.maxBaud ? local.maxBaud : peer.maxBaud) : 0;
+        agreed.maxPayload = local.maxPayload < peer.maxPayload ? local.maxPayload : peer.maxPayload;
+        return agreed;
+    }
+
+    // Strongest mode both sides advertised.
+    static LinkMode modeFromCaps(const LinkCaps& agreed) {
+        const uint16_t agreedCaps = agreed.flags;
+        LinkMode mode;
+        mode.framing = (agreedCaps & CAP_COBS) ? Framing::COBS : Framing::SYNC;
+        if (agreedCaps & CAP_CRC16) {
+            mode.integrity = Integrity::CRC16;
+        } else if (agreedCaps & CAP_CRC8) {
+            mode.integrity = Integrity::CRC8;
+        }
+        mode.batch = (agreedCaps & CAP_BATCH) != 0;
+        mode.ledDelta = (agreedCaps & CAP_LED_DELTA) != 0;
+        mode.extLength = (agreedCaps & CAP_EXT_LEN) != 0;
+        mode.nameIds = (agreedCaps & CAP_NAME_IDS) != 0;
+        mode.padFull = (agreedCaps & CAP_LED_PAD_FULL) != 0;
+        const uint16_t frameLimit = mode.extLength ? MAX_EXT_PAYLOAD_SIZE : MAX_PAYLOAD_SIZE;
+        mode.maxPayload = agreed.maxPayload < frameLimit ? agreed.maxPayload : frameLimit;
+        mode.maxBaud = agreed.maxBaud;
+        return mode;
+    }
+
+    // A rate change mid-batch would split it across two baud rates
+    static constexpr bool isBatchable(uint8_t command) {
+        return !isLinkControl(command) && command != CMD_BATCH && command != CMD_LINK_BAUD;
+    }
+
+    // One piece of a payload that lives in someone else's memory.
+    struct Slice {
+        const uint8_t* data;
+        uint16_t length;
+    };
+
+    // Total payload length of a slice list, or FRAME_SIZE_INVALID if it
+    // exceeds the largest extended payload.
+    static uint16_t sliceLength(const Slice* slices, uint8_t count) {
+        uint32_t total = 0;
+        for (uint8_t i = 0; slices && i < count; ++i) {
+            total += slices[i].length;
+        }
+        return total > MAX_EXT_PAYLOAD_SIZE ? FRAME_SIZE_INVALID : static_cast<uint16_t>(total);
+    }
+
+    // Batch payload under construction. depth lets nested begin/end pairs
+    // share one batch; the owner flushes when the outermost pair closes.
+    struct Batch {
+        uint8_t payload[MAX_PAYLOAD_SIZE];
+        uint8_t length = 0;
+        uint8_t count = 0;
+        uint8_t depth = 0;
+
+        bool active() const { return depth > 0; }
+
+        bool fits(uint8_t payloadLen) const {
+            return static_cast<uint16_t>(length) + BATCH_ENTRY_HEADER + payloadLen <= MAX_PAYLOAD_SIZE;
+        }
+
+        bool add(uint8_t command, const uint8_t* data, uint8_t dataLen) {
+            const Slice slice = {data, dataLen};
+            return add(command, &slice, 1);
+        }
+
+        bool add(uint8_t command, const Slice* slices, uint8_t sliceCount) {
+            const uint16_t dataLen = sliceLength(slices, sliceCount);
+            if (dataLen > MAX_PAYLOAD_SIZE || !fits(static_cast<uint8_t>(dataLen))) {
+                return false;
+            }
+            for (uint8_t i = 0; i < sliceCount; ++i) {
+                if (slices[i].length > 0 && slices[i].data == nullptr) {
+                    return false;
+                }
+            }
+            payload[length++] = command;
+            payload[length++] = static_cast<uint8_t>(dataLen);
+            for (uint8_t i = 0; i < sliceCount; ++i) {
+                if (slices[i].length > 0) {
+                    memcpy(&payload[length], slices[i].data, slices[i].length);
+                    length += slices[i].length;
+                }
+            }
+            count++;
+            return true;
+        }
+
+        void clear() {
+            length = 0;
+            count = 0;
+        }
+    };
+
+    // Walk the entries of a CMD_BATCH payload. offset starts at 0; returns
+    // false at the end or on a truncated entry.
+    static bool nextBatchEntry(const uint8_t* batch,
+                               uint16_t batchLen,
+                               uint16_t& offset,
+                               uint8_t& command,
+                               const uint8_t*& payload,
+                               uint8_t& payloadLen) {
+        if (!batch || static_cast<uint32_t>(offset) + BATCH_ENTRY_HEADER > batchLen) {
+            return false;
+        }
+        const uint8_t entryLen = batch[offset + 1];
+        const uint32_t end = static_cast<uint32_t>(offset) + BATCH_ENTRY_HEADER + entryLen;
+        if (end > batchLen) {
+            return false;
+        }
+        command = batch[offset];
+        payloadLen = entryLen;
+        payload = entryLen ? &batch[offset + BATCH_ENTRY_HEADER] : nullptr;
+        offset = static_cast<uint16_t>(end);
+        return true;
+    }
+
+    static const char* framingName(Framing framing) {
+        return framing == Framing::COBS ? "COBS" : "SYNC";
+    }
+
+    static const char* integrityName(Integrity integrity) {
+        switch (integrity) {
+            case Integrity::CRC8: return "CRC8";
+            case Integrity::CRC16: return "CRC16";
+            default: return "XOR";
+        }
+    }
+
+    static constexpr uint8_t getTrailerSize(Integrity integrity) {
+        return integrity == Integrity::CRC16 ? 2 : 1;
+    }
+
+    // Size of the LEN field: 1 byte, or the marker plus a 16-bit length.
+    static constexpr uint8_t getLengthFieldSize(uint16_t payloadLen) {
+        return payloadLen > MAX_PAYLOAD_SIZE ? 3 : 1;
+    }
+
+    // Frame body without SYNC or delimiters: CMD + LEN field + payload + trailer.
+    static constexpr uint16_t getBodySize(uint16_t payloadLen, Integrity integrity = Integrity::XOR) {
+        return static_cast<uint16_t>(payloadLen + 1 + getLengthFieldSize(payloadLen) + getTrailerSize(integrity));
+    }
 
     // Compute the total message size for a payload of payloadLen bytes.
-    static constexpr uint16_t getMessageSize(uint8_t payloadLen) {
-        return static_cast<uint16_t>(payloadLen) + HEADER_SIZE;
+    static constexpr uint16_t getMessageSize(uint16_t payloadLen, Integrity integrity = Integrity::XOR) {
+        return static_cast<uint16_t>(getBodySize(payloadLen, integrity) + 1);
     }
 
-    // Build a framed message into outBuffer. Returns total bytes written or 0 on error.
-    static uint16_t buildMessage(uint8_t command,
-                                 const uint8_t* payload,
-                                 uint8_t payloadLen,
-                                 uint8_t* outBuffer,
-                                 uint16_t bufferSize) {
-        if (!outBuffer) {
+    // Worst-case COBS frame size: body, one overhead byte per 254 body bytes
+    // (plus one), and both delimiters.
+    static constexpr uint16_t getCobsMessageSize(uint16_t payloadLen, Integrity integrity = Integrity::XOR) {
+        return static_cast<uint16_t>(getBodySize(payloadLen, integrity) +
+                                     getBodySize(payloadLen, integrity) / 254 + 1 + 2);
+    }
+
+    // Worst-case wire size of a frame in the given link mode.
+    static uint16_t getFrameSize(const LinkMode& mode, uint16_t payloadLen) {
+        return mode.framing == Framing::COBS ? getCobsMessageSize(payloadLen, mode.integrity)
+                                             : getMessageSize(payloadLen, mode.integrity);
+    }
+
+    // Largest short frame any mode can produce (COBS + CRC-16 with a 254-byte
+    // payload); size TX/RX buffers with this.
+    static constexpr uint16_t MAX_FRAME_SIZE = (MAX_PAYLOAD_SIZE + 2 + MAX_TRAILER_SIZE) +
+                                               (MAX_PAYLOAD_SIZE + 2 + MAX_TRAILER_SIZE) / 254 + 1 + 2;
+
+    // Same for extended-length frames; receivers that accept them need this much.
+    static constexpr uint16_t MAX_EXT_FRAME_SIZE = (MAX_EXT_PAYLOAD_SIZE + 4 + MAX_TRAILER_SIZE) +
+                                                   (MAX_EXT_PAYLOAD_SIZE + 4 + MAX_TRAILER_SIZE) / 254 + 1 + 2;
+
+    static constexpr bool isValidExtLength(uint16_t payloadLen) {
+        return payloadLen > MAX_PAYLOAD_SIZE && payloadLen <= MAX_EXT_PAYLOAD_SIZE;
+    }
+
+    // Write the LEN field for payloadLen into out (3 bytes of room). Returns its size.
+    static uint8_t writeLength(uint16_t payloadLen, uint8_t* out) {
+        if (payloadLen <= MAX_PAYLOAD_SIZE) {
+            out[0] = static_cast<uint8_t>(payloadLen);
+            return 1;
+        }
+        out[0] = EXT_LEN_MARKER;
+        out[1] = static_cast<uint8_t>(payloadLen >> 8);
+        out[2] = static_cast<uint8_t>(payloadLen & 0xFF);
+        return 3;
+    }
+
+    // Read the LEN field at field, of which available bytes are present.
+    // Returns its size, or 0 when truncated or not canonical.
+    static uint8_t readLength(const uint8_t* field, uint16_t available, uint16_t& payloadLen) {
+        if (available < 1) {
             return 0;
         }
-        if (payloadLen > 0 && payload == nullptr) {
+        if (field[0] != EXT_LEN_MARKER) {
+            payloadLen = field[0];
+            return 1;
+        }
+        if (available < 3) {
             return 0;
         }
+        payloadLen = static_cast<uint16_t>((field[1] << 8) | field[2]);
+        return isValidExtLength(payloadLen) ? 3 : 0;
+    }
 
-        const uint16_t totalLen = getMessageSize(payloadLen);
-        if (bufferSize < totalLen) {
+    // Total size of the SYNC frame whose first received bytes sit in frame.
+    // 0 while the LEN field is incomplete, FRAME_SIZE_INVALID when malformed.
+    static uint16_t expectedMessageSize(const uint8_t* frame, uint16_t received, Integrity integrity) {
+        if (received < 3) {
+            return 0;
+        }
+        if (frame[2] != EXT_LEN_MARKER) {
+            return getMessageSize(frame[2], integrity);
+        }
+        if (received < 5) {
             return 0;
         }
+        uint16_t payloadLen = 0;
+        if (!readLength(&frame[2], 3, payloadLen)) {
+            return FRAME_SIZE_INVALID;
+        }
+        return getMessageSize(payloadLen, integrity);
+    }
+
+    // Incremental checksum in any integrity mode; feed CMD, the LEN field and
+    // the payload in as many slices as convenient.
+    class Checksum {
+    public:
+        explicit Checksum(Integrity integrity)
+            : integrity(integrity), crc(integrity == Integrity::CRC16 ? CRC16_INIT : CRC8_INIT) {}
+
+        void update(uint8_t value) { update(&value, 1); }
+
+        void update(const uint8_t* data, uint16_t length) {
+            switch (integrity) {
+                case Integrity::CRC8:
+                    crc = crc8Update(static_cast<uint8_t>(crc), data, length);
+                    break;
+                case Integrity::CRC16:
+                    crc = crc16Update(crc, data, length);
+                    break;
+                case Integrity::XOR:
+                default:
+                    for (uint16_t i = 0; data && i < length; ++i) {
+                        crc ^= data[i];
+                    }
+                    break;
+            }
+        }
+
+        uint16_t value() const { return crc; }
+
+    private:
+        Integrity integrity;
+        uint16_t crc;
+    };
+
+    // Sink that fills a caller buffer; flags overflow instead of writing past it.
+    struct BufferSink {
+        BufferSink(uint8_t* out, uint16_t capacity) : out(out), capacity(capacity) {}
+
+        void put(uint8_t value) {
+            if (length < capacity) {
+                out[length++] = value;
+            } else {
+                overflow = true;
+            }
+        }
+
+        void write(const uint8_t* data, uint16_t count) {
+            if (count == 0) {
+                return; // Empty slice: data may be null
+            }
+            if (count > capacity - length) {
+                overflow = true;
+                return;
+            }
+            memcpy(&out[length], data, count);
+            length += count;
+        }
+
+        uint8_t* out;
+        uint16_t capacity;
+        uint16_t length = 0;
+        bool overflow = false;
+    };
+
+    // Sink that hands bytes to a Print in fixed-size chunks, so a frame of any
+    // length goes out without a full-frame buffer. Small pieces are staged,
+    // slices of a chunk or more are written straight through. Call flush()
+    // at the end.
+    template <uint16_t ChunkSize>
+    class PrintSink {
+    public:
+        explicit PrintSink(Print& out) : out(out) {}
+
+        void put(uint8_t value) {
+            chunk[used++] = value;
+            if (used == ChunkSize) {
+                flush();
+            }
+        }
 
-        outBuffer[0] = BINARY_SYNC_BYTE;
-        outBuffer[1] = command;
-        outBuffer[2] = payloadLen;
+        void write(const uint8_t* data, uint16_t count) {
+            if (count >= ChunkSize) {
+                // Big slices go to the port as they are, no staging copy
+                flush();
+                out.write(data, count);
+                return;
+            }
+            while (count > 0) {
+                uint16_t room = ChunkSize - used;
+                if (room > count) room = count;
+                memcpy(&chunk[used], data, room);
+                used += room;
+                data += room;
+                count -= room;
+                if (used == ChunkSize) {
+                    flush();
+                }
+            }
+        }
 
-        uint8_t checksum = computeChecksum(command, payloadLen, payload);
+        void flush() {
+            if (used > 0) {
+                out.write(chunk, used);
+                used = 0;
+            }
+        }
+
+    private:
+        Print& out;
+        uint8_t chunk[ChunkSize];
+        uint16_t used = 0;
+    };
+
+    // Streams one frame into a sink: begin(), write() payload slices adding up
+    // to the announced length, then finish(). A sink provides put(uint8_t) and
+    // write(const uint8_t*, uint16_t). SYNC bytes pass straight through; COBS
+    // holds back at most one block (254 bytes) until its code byte is known.
+    template <typename Sink>
+    class FrameEncoder {
+    public:
+        FrameEncoder(Sink& sink, Framing framing, Integrity integrity)
+            : sink(sink), framing(framing), integrity(integrity), checksum(integrity) {}
 
-        if (payloadLen > 0) {
-            memcpy(&outBuffer[3], payload, payloadLen);
+        FrameEncoder(Sink& sink, const LinkMode& mode)
+            : FrameEncoder(sink, mode.framing, mode.integrity) {}
+
+        bool begin(uint8_t command, uint16_t payloadLen) {
+            if (payloadLen > MAX_EXT_PAYLOAD_SIZE) {
+                return false;
+            }
+            remaining = payloadLen;
+            sink.put(framing == Framing::COBS ? COBS_DELIMITER : BINARY_SYNC_BYTE);
+            uint8_t header[1 + 3] = {command};
+            const uint8_t headerLen = 1 + writeLength(payloadLen, &header[1]);
+            checksum.update(header, headerLen);
+            emit(header, headerLen);
+            return true;
+        }
+
+        // Append the next payload slice; slices past the announced length are refused.
+        bool write(const uint8_t* data, uint16_t length) {
+            if (length > remaining || (length > 0 && data == nullptr)) {
+                failed = true;
+                return false;
+            }
+            remaining -= length;
+            checksum.update(data, length);
+            emit(data, length);
+            return true;
+        }
+
+        bool write(const Slice* slices, uint8_t count) {
+            for (uint8_t i = 0; i < count; ++i) {
+                if (!write(slices[i].data, slices[i].length)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Close the frame. Returns false if the payload did not match the
+        // announced length (the frame then fails the receiver's checks).
+        bool finish() {
+            uint8_t trailer[MAX_TRAILER_SIZE];
+            writeTrailer(integrity, checksum.value(), trailer);
+            emit(trailer, getTrailerSize(integrity));
+            if (framing == Framing::COBS) {
+                flushBlock();
+                sink.put(COBS_DELIMITER);
+            }
+            return !failed && remaining == 0;
+        }
+
+    private:
+        void emit(const uint8_t* data, uint16_t length) {
+            if (framing != Framing::COBS) {
+                sink.write(data, length);
+                return;
+            }
+            for (uint16_t i = 0; i < length; ++i) {
+                if (data[i] == COBS_DELIMITER) {
+                    flushBlock();
+                    continue;
+                }
+                block[blockLen++] = data[i];
+                if (blockLen == sizeof(block)) {
+                    flushBlock();
+                }
+            }
         }
 
-        outBuffer[totalLen - 1] = checksum;
-        return totalLen;
+        void flushBlock() {
+            sink.put(static_cast<uint8_t>(blockLen + 1));
+            sink.write(block, blockLen);
+            blockLen = 0;
+        }
+
+        Sink& sink;
+        Framing framing;
+        Integrity integrity;
+        Checksum checksum;
+        uint16_t remaining = 0;
+        bool failed = false;
+        uint8_t block[254];
+        uint8_t blockLen = 0;
+    };
+
+    // Build a framed message into outBuffer. Returns total bytes written or 0 on error.
+    static uint16_t buildMessage(uint8_t command,
+                                 const uint8_t* payload,
+                                 uint16_t payloadLen,
+                                 uint8_t* outBuffer,
+                                 uint16_t bufferSize,
+                                 Integrity integrity = Integrity::XOR) {
+        return encodeInto(Framing::SYNC, integrity, command, payload, payloadLen, outBuffer, bufferSize);
     }
 
     // Parse a framed message from buffer. Returns true when the frame validates.
@@ -55,7 +584,8 @@ public:
                              uint16_t length,
                              uint8_t& command,
                              const uint8_t*& payload,
-                             uint8_t& payloadLen) {
+                             uint16_t& payloadLen,
+                             Integrity integrity = Integrity::XOR) {
         if (!buffer || length < HEADER_SIZE) {
             return false;
         }
@@ -64,29 +594,264 @@ public:
         }
 
         command = buffer[1];
-        payloadLen = buffer[2];
+        const uint8_t lengthSize = readLength(&buffer[2], length - 2, payloadLen);
+        if (lengthSize == 0 || length != getMessageSize(payloadLen, integrity)) {
+            return false;
+        }
+
+        const uint16_t payloadStart = 2 + lengthSize;
+        payload = payloadLen ? &buffer[payloadStart] : nullptr;
+        const uint16_t computed = computeChecksum(integrity, command, payloadLen, payload);
+        return readTrailer(integrity, &buffer[payloadStart + payloadLen]) == computed;
+    }
+
+    // Build a COBS frame into outBuffer. Returns total bytes written (both
+    // delimiters included) or 0 on error.
+    static uint16_t buildCobsMessage(uint8_t command,
+                                     const uint8_t* payload,
+                                     uint16_t payloadLen,
+                                     uint8_t* outBuffer,
+                                     uint16_t bufferSize,
+                                     Integrity integrity = Integrity::XOR) {
+        return encodeInto(Framing::COBS, integrity, command, payload, payloadLen, outBuffer, bufferSize);
+    }
+
+    // Decode and validate one COBS frame (the bytes between two delimiters,
+    // delimiters excluded). Decodes in place, so payload points into buffer.
+    static bool parseCobsMessage(uint8_t* buffer,
+                                 uint16_t length,
+                                 uint8_t& command,
+                                 const uint8_t*& payload,
+                                 uint16_t& payloadLen,
+                                 Integrity integrity = Integrity::XOR) {
+        if (!buffer || length == 0) {
+            return false;
+        }
+        const uint16_t bodyLen = cobsDecode(buffer, length, buffer, length);
+        if (bodyLen < 2 + getTrailerSize(integrity)) {
+            return false;
+        }
+
+        command = buffer[0];
+        const uint8_t lengthSize = readLength(&buffer[1], bodyLen - 1, payloadLen);
+        if (lengthSize == 0 || bodyLen != getBodySize(payloadLen, integrity)) {
+            return false;
+        }
+
+        const uint16_t payloadStart = 1 + lengthSize;
+        payload = payloadLen ? &buffer[payloadStart] : nullptr;
+        const uint16_t computed = computeChecksum(integrity, command, payloadLen, payload);
+        return readTrailer(integrity, &buffer[payloadStart + payloadLen]) == computed;
+    }
+
+    // Frame with whichever mode the link negotiated.
+    static uint16_t buildFrame(const LinkMode& mode,
+                               uint8_t command,
+                               const uint8_t* payload,
+                               uint16_t payloadLen,
+                               uint8_t* outBuffer,
+                               uint16_t bufferSize) {
+        if (mode.framing == Framing::COBS) {
+            return buildCobsMessage(command, payload, payloadLen, outBuffer, bufferSize, mode.integrity);
+        }
+        return buildMessage(command, payload, payloadLen, outBuffer, bufferSize, mode.integrity);
+    }
+
+    // COBS-decode length bytes of in into out (may alias in). Returns the decoded
+    // length, or 0 when the input holds a 0x00 or a block runs past the end.
+    static uint16_t cobsDecode(const uint8_t* in, uint16_t length, uint8_t* out, uint16_t outSize) {
+        uint16_t readIndex = 0;
+        uint16_t writeIndex = 0;
+        while (readIndex < length) {
+            const uint8_t code = in[readIndex++];
+            if (code == COBS_DELIMITER) {
+                return 0;
+            }
+            for (uint8_t i = 1; i < code; ++i) {
+                if (readIndex >= length || writeIndex >= outSize) {
+                    return 0;
+                }
+                const uint8_t value = in[readIndex++];
+                if (value == COBS_DELIMITER) {
+                    return 0;
+                }
+                out[writeIndex++] = value;
+            }
+            if (code != 0xFF && readIndex < length) {
+                if (writeIndex >= outSize) {
+                    return 0;
+                }
+                out[writeIndex++] = 0x00;
+            }
+        }
+        return writeIndex;
+    }
+
+    // Append the capability block to a handshake ID. Returns the new payload length.
+    static uint8_t appendCaps(const uint8_t* id, uint8_t idLen, const LinkCaps& caps,
+                              uint8_t* outBuffer, uint8_t bufferSize) {
+        if (!outBuffer || bufferSize < idLen + CAPS_BLOCK_SIZE) {
+            return 0;
+        }
+        if (idLen > 0 && id) {
+            memcpy(outBuffer, id, idLen);
+        }
+        const uint16_t maxPayload = caps.maxPayload > 0x3FFF ? 0x3FFF : caps.maxPayload;
+        uint8_t* block = &outBuffer[idLen];
+        block[0] = CAPS_SEPARATOR;
+        block[1] = static_cast<uint8_t>(caps.flags & 0x7F);
+        block[2] = caps.maxBaud ? baudCode(caps.maxBaud) : BAUD_CODE_NONE;
+        block[3] = static_cast<uint8_t>((maxPayload >> 7) & 0x7F);
+        block[4] = static_cast<uint8_t>(maxPayload & 0x7F);
+        block[5] = static_cast<uint8_t>((caps.flags >> 7) & 0x7F);
+        return idLen + CAPS_BLOCK_SIZE;
+    }
 
-        const uint16_t expectedLen = getMessageSize(payloadLen);
-        if (length != expectedLen) {
+    // Extract the capability block from a handshake payload. Returns false when
+    // the peer sent no block (legacy firmware). A block with only the flags
+    // byte leaves the rate at base and the payload limit at the frame format's;
+    // one without CAPS2 offers none of its flags.
+    static bool findCaps(const uint8_t* payload, uint8_t payloadLen, LinkCaps& caps) {
+        if (!payload) {
             return false;
         }
+        for (uint8_t i = 0; i + 1 < payloadLen; ++i) {
+            if (payload[i] != CAPS_SEPARATOR) {
+                continue;
+            }
+            caps = LinkCaps();
+            caps.flags = payload[i + 1] & 0x7F;
+            if (i + CAPS_BLOCK_SIZE_V1 <= payloadLen) {
+                caps.maxBaud = baudRate(payload[i + 2]);
+                caps.maxPayload = static_cast<uint16_t>(((payload[i + 3] & 0x7F) << 7) |
+                                                        (payload[i + 4] & 0x7F));
+                if (i + CAPS_BLOCK_SIZE <= payloadLen) {
+                    caps.flags |= static_cast<uint16_t>((payload[i + 5] & 0x7F) << 7);
+                }
+            } else {
+                caps.maxPayload = (caps.flags & CAP_EXT_LEN) ? MAX_EXT_PAYLOAD_SIZE : MAX_PAYLOAD_SIZE;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Checksum over CMD, the LEN field and payload for the given integrity
+    // mode. CRC-8 and XOR results use the low byte only.
+    static uint16_t computeChecksum(Integrity integrity,
+                                    uint8_t command,
+                                    uint16_t payloadLen,
+                                    const uint8_t* payload) {
+        Checksum checksum(integrity);
+        uint8_t header[1 + 3] = {command};
+        checksum.update(header, 1 + writeLength(payloadLen, &header[1]));
+        checksum.update(payload, payloadLen);
+        return checksum.value();
+    }
 
-        payload = payloadLen ? &buffer[3] : nullptr;
-        const uint8_t expectedChecksum = buffer[length - 1];
-        const uint8_t computedChecksum = computeChecksum(command, payloadLen, payload);
-        return expectedChecksum == computedChecksum;
+    static uint8_t crc8Update(uint8_t crc, const uint8_t* data, uint16_t length) {
+        const Crc8Table& table = crc8Table();
+        for (uint16_t i = 0; data && i < length; ++i) {
+            crc = table.entries[crc ^ data[i]];
+        }
+        return crc;
+    }
+
+    static uint16_t crc16Update(uint16_t crc, const uint8_t* data, uint16_t length) {
+        const Crc16Table& table = crc16Table();
+        for (uint16_t i = 0; data && i < length; ++i) {
+            crc = static_cast<uint16_t>((crc << 8) ^ table.entries[(crc >> 8) ^ data[i]]);
+        }
+        return crc;
     }
 
 private:
-    static uint8_t computeChecksum(uint8_t command,
-                                   uint8_t payloadLen,
-                                   const uint8_t* payload) {
-        uint8_t checksum = command ^ payloadLen;
-        if (payload && payloadLen > 0) {
-            for (uint8_t i = 0; i < payloadLen; ++i) {
-                checksum ^= payload[i];
+    static constexpr uint8_t CRC8_POLY = 0x07;
+    static constexpr uint8_t CRC8_INIT = 0x00;
+    static constexpr uint16_t CRC16_POLY = 0x1021;
+    static constexpr uint16_t CRC16_INIT = 0xFFFF;
+
+    struct Crc8Table { uint8_t entries[256]; };
+    struct Crc16Table { uint16_t entries[256]; };
+
+    static constexpr Crc8Table makeCrc8Table() {
+        Crc8Table table{};
+        for (uint16_t i = 0; i < 256; ++i) {
+            uint8_t crc = static_cast<uint8_t>(i);
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ CRC8_POLY)
+                                   : static_cast<uint8_t>(crc << 1);
             }
+            table.entries[i] = crc;
         }
-        return checksum;
+        return table;
+    }
+
+    static constexpr Crc16Table makeCrc16Table() {
+        Crc16Table table{};
+        for (uint16_t i = 0; i < 256; ++i) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ CRC16_POLY)
+                                     : static_cast<uint16_t>(crc << 1);
+            }
+            table.entries[i] = crc;
+        }
+        return table;
+    }
+
+    // Tables are built at compile time and live in flash.
+    static const Crc8Table& crc8Table() {
+        static constexpr Crc8Table table = makeCrc8Table();
+        return table;
+    }
+
+    static const Crc16Table& crc16Table() {
+        static constexpr Crc16Table table = makeCrc16Table();
+        return table;
+    }
+
+    static void writeTrailer(Integrity integrity, uint16_t checksum, uint8_t* out) {
+        if (integrity == Integrity::CRC16) {
+            out[0] = static_cast<uint8_t>(checksum >> 8);
+            out[1] = static_cast<uint8_t>(checksum & 0xFF);
+        } else {
+            out[0] = static_cast<uint8_t>(checksum & 0xFF);
+        }
+    }
+
+    static uint16_t readTrailer(Integrity integrity, const uint8_t* in) {
+        if (integrity == Integrity::CRC16) {
+            return static_cast<uint16_t>((in[0] << 8) | in[1]);
+        }
+        return in[0];
+    }
+
+    static uint16_t encodeInto(Framing framing,
+                               Integrity integrity,
+                               uint8_t command,
+                               const uint8_t* payload,
+                               uint16_t payloadLen,
+                               uint8_t* outBuffer,
+                               uint16_t bufferSize) {
+        if (!outBuffer || payloadLen > MAX_EXT_PAYLOAD_SIZE) {
+            return 0;
+        }
+        if (payloadLen > 0 && payload == nullptr) {
+            return 0;
+        }
+        LinkMode mode;
+        mode.framing = framing;
+        mode.integrity = integrity;
+        if (bufferSize < getFrameSize(mode, payloadLen)) {
+            return 0;
+        }
+
+        BufferSink sink(outBuffer, bufferSize);
+        FrameEncoder<BufferSink> encoder(sink, mode);
+        encoder.begin(command, payloadLen);
+        encoder.write(payload, payloadLen);
+        encoder.finish();
+        return sink.length;
     }
 };
@@ -31,6 +31,11 @@
 // === UART COMMUNICATION ===
 // Tuned for reliability: 1 Mbps over jumper pads (SDA/SCL)
 #define UART_BAUD_RATE 1000000  // 1 Mbps - Reliable low-latency link
+// Fastest rate each side offers in the handshake; the link runs at the lower
+#define UART_MAX_BAUD_TEENSY 3000000 // LPUART, 24 MHz clock / 8
+#define UART_MAX_BAUD_M4 2000000     // SERCOM at 48 MHz tops out at 3 Mbps; keep margin
+#define GUI_BAUD_RATE 115200         // Serial2 GUI link before negotiation
+#define GUI_MAX_BAUD_RATE 2000000
 #define UART_BUFFER_SIZE 256
 // Heartbeat ping from Teensy to M4
 #define UART_PING_INTERVAL_MS 30000     // Send PING every 30 seconds
@@ -44,6 +49,43 @@
 // === ABLETON INTEGRATION ===
 #define ABLETON_MIDI_CHANNEL 1
 #define ABLETON_SYSEX_TIMEOUT 1000
+// USB MIDI drain per loop (Teensy): a time budget rather than a message count.
+// It shrinks towards the minimum while M4 pad events wait to be read or the
+// M4 TX queue backs up. At least one message is handled per loop.
+#define MIDI_DRAIN_BUDGET_US 1000
+#define MIDI_DRAIN_MIN_BUDGET_US 150
+#define MIDI_DRAIN_TX_BACKLOG_BYTES 2048 // M4 TX backlog at which the minimum applies
+// Lost Live frames (SEQ gaps, rejected SysEx) are answered with one
+// CMD_RESYNC_REQUEST for the affected areas once the loss has settled
+#define LIVE_RESYNC_HOLDOFF_MS 20       // Quiet time after the last loss
+#define LIVE_RESYNC_MIN_INTERVAL_MS 250 // Between two requests
+// Clip and mixer updates from Live are merged per pad/track/send and only
+// the newest value is forwarded, at these rates
+#define LIVE_GUI_FLUSH_HZ 60
+#define LIVE_LED_FLUSH_HZ 200
+// Clip states cached around the session ring (3 x 3 rings) so ring moves
+// redraw at once; neighbouring windows are prefetched from Live and asked
+// for again after the refresh time, since Live only pushes the ring itself
+#define LIVE_CLIP_CACHE_TRACKS 24
+#define LIVE_CLIP_CACHE_SCENES 12
+#define LIVE_CLIP_PREFETCH_REFRESH_MS 2000
+#define LIVE_CLIP_PREVIEW_TIMEOUT_MS 300 // Grid resync if Live does not confirm a move
+// Ring presses within this window go to Live as one absolute position
+#define LIVE_RING_NAV_MERGE_MS 40
+// Track meters: one frame with the ring's tracks at this rate, only when a
+// level or peak moved by the threshold (0-127 scale)
+#define LIVE_METER_HZ 30
+#define LIVE_METER_THRESHOLD 2
+#define LIVE_METER_DECAY 4            // Per frame
+#define LIVE_METER_PEAK_HOLD_MS 1000
+// Clip and song positions, run from the tempo between Live's anchors
+#define LIVE_POSITION_HZ 30
+#define LIVE_POSITION_TICKS_PER_BEAT 16   // Unit of the 14-bit positions
+#define LIVE_POSITION_TOLERANCE_TICKS 2   // Anchors closer than this leave the estimate alone
+#define LIVE_POSITION_TIMEOUT_MS 1000     // No anchor for this long: clip stopped
+// Ring names, each distinct string stored once (Live trims names to 12 bytes)
+#define LIVE_NAME_POOL_ENTRIES 64
+#define LIVE_NAME_POOL_BYTES 768
 
 // === DEBUG FLAGS ===
 // #define DEBUG_LIVE_LOG  // Enable Live command logging (disabled to reduce spam)
@@ -57,6 +99,9 @@
 // === ENCODERS CONFIGURATION (Teensy only) ===
 #define NUM_ENCODERS_ACTIVE 4          // Currently connected encoders
 #define NUM_ENCODERS_MAX 8             // Maximum encoders supported (future expansion)
+// An encoder starts from Live's value for its parameter unless it was turned
+// this recently: while turning, Live's echoes of earlier values lag behind
+#define ENCODER_FEEDBACK_HOLDOFF_MS 250
 // Format: {Enc1_A, Enc1_B, Enc2_A, Enc2_B, Enc3_A, Enc3_B, Enc4_A, Enc4_B}
 // CORRECTED: Pin 6-9 (not 6-7)
 #define ENCODER_PINS_ACTIVE {2, 3, 4, 5, 6, 9, 10, 11}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstring>
+#include "shared/BinaryProtocol.h"
+
+// One validated frame. payload points into the parser's buffer and stays
+// valid only until the handler returns.
+struct FrameView {
+    uint8_t command;
+    const uint8_t* payload;
+    uint16_t length;
+    BinaryProtocol::Framing framing; // How it arrived (SYNC frames in COBS mode are link control)
+};
+
+struct FrameParserStats {
+    uint32_t bytes = 0;
+    uint32_t frames = 0;
+    uint32_t badFrames = 0; // Failed checksum or format
+    uint32_t resyncs = 0;   // SYNC hunter skipped ahead to the next 0xAA
+    uint32_t overflows = 0; // Frame larger than the buffer
+};
+
+// Incremental receiver for BinaryProtocol frames, shared by every link.
+// Input arrives in bulk chunks; validated frames are handed to a callback as
+// views into the parser's buffer, never copied out.
+//
+// The SYNC parser always runs, so a restarted peer (back on SYNC framing) is
+// heard whatever the link negotiated. A 0xAA inside a payload no longer
+// aborts the frame in flight: a frame that fails validation, or stalls for
+// FRAME_GAP_MS, is rescanned from its second byte for the next 0xAA instead.
+// While the link runs COBS, SYNC candidates that are not link-control
+// commands are dropped at once so COBS traffic cannot hold the hunter.
+// COBS frames are collected alongside between 0x00 delimiters.
+template <uint16_t BufferSize>
+class FrameParser {
+public:
+    static constexpr uint16_t READ_CHUNK = 64;
+    static constexpr uint32_t FRAME_GAP_MS = 20;
+
+    // Drain everything the stream holds, READ_CHUNK bytes per readBytes().
+    // link is read on every byte, so a handshake applied by the handler takes
+    // effect for the rest of the chunk.
+    template <typename Handler>
+    uint16_t poll(Stream& in, const BinaryProtocol::LinkMode& link, Handler&& onFrame) {
+        uint8_t chunk[READ_CHUNK];
+        uint16_t total = 0;
+        int available = 0;
+        while ((available = in.available()) > 0) {
+            const size_t wanted = available < READ_CHUNK ? static_cast<size_t>(available) : READ_CHUNK;
+            const uint16_t got = static_cast<uint16_t>(in.readBytes(chunk, wanted));
+            if (got == 0) {
+                break;
+            }
+            feed(chunk, got, link, millis(), onFrame);
+            total += got;
+        }
+        return total;
+    }
+
+    template <typename Handler>
+    void feed(const uint8_t* data, uint16_t length, const BinaryProtocol::LinkMode& link,
+              uint32_t nowMs, Handler&& onFrame) {
+        if (length == 0) {
+            return;
+        }
+        if (syncLen > 0 && nowMs - lastByteMs > FRAME_GAP_MS) {
+            // The sender went quiet mid-frame: that frame is not coming
+            stats.resyncs++;
+            dropFront(1);
+            processSync(link, onFrame);
+        }
+        lastByteMs = nowMs;
+        stats.bytes += length;
+
+        for (uint16_t i = 0; i < length; ++i) {
+            const uint8_t byte = data[i];
+
+            if (link.framing != cobsFraming) {
+                cobsFraming = link.framing;
+                cobsLen = 0;
+                cobsOverflow = false;
+            }
+            if (link.framing == BinaryProtocol::Framing::COBS) {
+                feedCobs(byte, link, onFrame);
+            }
+
+            if (syncLen == 0 && byte != BinaryProtocol::BINARY_SYNC_BYTE) {
+                continue;
+            }
+            if (syncLen >= BufferSize) {
+                stats.overflows++;
+                dropFront(1);
+            }
+            syncBuffer[syncLen++] = byte;
+            processSync(link, onFrame);
+        }
+    }
+
+    void reset() {
+        syncLen = 0;
+        cobsLen = 0;
+        cobsOverflow = false;
+    }
+
+    const FrameParserStats& getStats() const { return stats; }
+    void resetStats() { stats = FrameParserStats(); }
+
+private:
+    template <typename Handler>
+    void processSync(const BinaryProtocol::LinkMode& link, Handler& onFrame) {
+        while (syncLen >= 2) {
+            const uint8_t command = syncBuffer[1];
+            if (link.framing == BinaryProtocol::Framing::COBS && !BinaryProtocol::isLinkControl(command)) {
+                dropFront(1); // A 0xAA inside COBS traffic, not a lost frame
+                continue;
+            }
+
+            const BinaryProtocol::Integrity integrity = BinaryProtocol::modeFor(command, link).integrity;
+            const uint16_t expected = BinaryProtocol::expectedMessageSize(syncBuffer, syncLen, integrity);
+            if (expected == 0 || (expected <= BufferSize && syncLen < expected)) {
+                return; // Need more bytes
+            }
+            if (expected > BufferSize) {
+                if (expected != BinaryProtocol::FRAME_SIZE_INVALID) {
+                    stats.overflows++;
+                }
+                stats.resyncs++;
+                dropFront(1);
+                continue;
+            }
+
+            uint8_t parsedCommand = 0;
+            const uint8_t* payload = nullptr;
+            uint16_t payloadLen = 0;
+            if (!BinaryProtocol::parseMessage(syncBuffer, expected, parsedCommand, payload, payloadLen, integrity)) {
+                stats.badFrames++;
+                stats.resyncs++;
+                dropFront(1);
+                continue;
+            }
+
+            stats.frames++;
+            const FrameView frame = {parsedCommand, payload, payloadLen, BinaryProtocol::Framing::SYNC};
+            onFrame(frame);
+            dropFront(expected);
+        }
+    }
+
+    template <typename Handler>
+    void feedCobs(uint8_t byte, const BinaryProtocol::LinkMode& link, Handler& onFrame) {
+        if (byte != BinaryProtocol::COBS_DELIMITER) {
+            if (cobsLen < BufferSize) {
+                cobsBuffer[cobsLen++] = byte;
+            } else if (!cobsOverflow) {
+                stats.overflows++;
+                cobsOverflow = true; // Discard until next delimiter
+            }
+            return;
+        }
+
+        // Delimiter: whatever was collected is one complete frame
+        const uint16_t length = cobsLen;
+        const bool overflowed = cobsOverflow;
+        cobsLen = 0;
+        cobsOverflow = false;
+        if (length == 0 || overflowed) {
+            return;
+        }
+
+        uint8_t command = 0;
+        const uint8_t* payload = nullptr;
+        uint16_t payloadLen = 0;
+        if (!BinaryProtocol::parseCobsMessage(cobsBuffer, length, command, payload, payloadLen, link.integrity)) {
+            stats.badFrames++;
+            return;
+        }
+        stats.frames++;
+        const FrameView frame = {command, payload, payloadLen, BinaryProtocol::Framing::COBS};
+        onFrame(frame);
+    }
+
+    // Drop count bytes, then everything up to the next SYNC byte.
+    void dropFront(uint16_t count) {
+        uint16_t start = count;
+        while (start < syncLen && syncBuffer[start] != BinaryProtocol::BINARY_SYNC_BYTE) {
+            ++start;
+        }
+        if (start >= syncLen) {
+            syncLen = 0;
+            return;
+        }
+        memmove(syncBuffer, &syncBuffer[start], syncLen - start);
+        syncLen -= start;
+    }
+
+    uint8_t syncBuffer[BufferSize];
+    uint16_t syncLen = 0;
+    uint8_t cobsBuffer[BufferSize];
+    uint16_t cobsLen = 0;
+    bool cobsOverflow = false;
+    BinaryProtocol::Framing cobsFraming = BinaryProtocol::Framing::SYNC;
+    uint32_t lastByteMs = 0;
+    FrameParserStats stats;
+};
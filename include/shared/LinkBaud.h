@@ -0,0 +1,214 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/BinaryProtocol.h"
+
+// Baud rate of one UART link after the handshake.
+//
+// Handshakes always settle at the base rate. The requesting side (the Teensy)
+// then asks for the fastest rate both ends offered with CMD_LINK_BAUD; the
+// peer echoes it at the old rate and both switch. The new rate is on
+// probation until a valid frame crosses it: after CONFIRM_MS without one,
+// each end falls back to its previous rate on its own. Above the base rate,
+// ERROR_LIMIT bad frames within ERROR_WINDOW_MS step the link down one rate,
+// and a rate that failed is not offered again until the next begin().
+//
+// A side that restarts comes back at the base rate, so the requester walks
+// the rate ladder on successive handshake attempts until it meets the peer.
+class LinkBaud {
+public:
+    static constexpr uint32_t CONFIRM_MS = 250;
+    static constexpr uint32_t ERROR_WINDOW_MS = 1000;
+    static constexpr uint8_t ERROR_LIMIT = 4;
+
+    enum class Action : uint8_t {
+        NONE,
+        REQUEST,  // Ask the peer for requestedBaud(), one step down
+        LINK_LOST // A request went unanswered above the base rate
+    };
+
+    void begin(HardwareSerial& serialPort, uint32_t baseRate, uint32_t maxRate) {
+        port = &serialPort;
+        baseBaud = baseRate;
+        maxBaud = maxRate > baseRate ? maxRate : baseRate;
+        ceiling = maxBaud;
+        fallbacks = 0;
+        reset();
+    }
+
+    // No rate control (USB serial): offer nothing, never switch.
+    void detach() {
+        port = nullptr;
+        currentBaud = 0;
+        state = State::IDLE;
+    }
+
+    // Back to the base rate, keeping what was learnt about faster ones.
+    void reset() {
+        state = State::IDLE;
+        windowValid = false;
+        setRate(baseBaud);
+    }
+
+    // Rate for the capability block (0: this link cannot switch).
+    uint32_t offered() const { return port ? ceiling : 0; }
+    uint32_t current() const { return currentBaud; }
+    uint32_t getFallbacks() const { return fallbacks; }
+    uint32_t requestedBaud() const { return pendingRate; }
+    bool awaitingEcho() const { return state == State::AWAIT_ECHO; }
+
+    // Handshake attempt n goes out at the base rate first, then at each
+    // faster rate in turn, so a peer left at a higher rate is found.
+    void hunt(uint8_t attempt) {
+        if (!port) {
+            return;
+        }
+        uint32_t rates[BinaryProtocol::BAUD_RATE_COUNT + 1];
+        const uint8_t count = ladder(rates);
+        state = State::IDLE;
+        setRate(rates[attempt % count]);
+    }
+
+    // Handshake completed: back to the base rate. Returns the rate to request
+    // next, or 0 to stay at base.
+    uint32_t afterHandshake(uint32_t agreedMax) {
+        reset();
+        const uint32_t rate = agreedMax < ceiling ? agreedMax : ceiling;
+        return port && rate > baseBaud ? rate : 0;
+    }
+
+    // Requester: CMD_LINK_BAUD for rate is on its way.
+    void requested(uint32_t rate, uint32_t nowMs) {
+        pendingRate = rate;
+        state = State::AWAIT_ECHO;
+        stateMs = nowMs;
+    }
+
+    // Requester: the peer echoed. Switches now; false if it was not the rate asked for.
+    bool echoed(uint32_t rate, uint32_t nowMs) {
+        if (state != State::AWAIT_ECHO || rate != pendingRate) {
+            return false;
+        }
+        switchTo(rate, nowMs);
+        return true;
+    }
+
+    // Responder: whether a requested rate is one this side can run.
+    bool accepts(uint32_t rate) const {
+        return port && rate >= baseBaud && rate <= maxBaud &&
+               (rate == baseBaud || BinaryProtocol::baudCode(rate) != BinaryProtocol::BAUD_CODE_NONE);
+    }
+
+    // Move to rate now and hold it on probation.
+    void switchTo(uint32_t rate, uint32_t nowMs) {
+        previousRate = currentBaud;
+        pendingRate = rate;
+        setRate(rate);
+        state = State::PROBATION;
+        stateMs = nowMs;
+        windowValid = false;
+    }
+
+    // A valid frame arrived at the current rate.
+    void frameReceived() {
+        if (state == State::PROBATION) {
+            state = State::IDLE;
+        }
+    }
+
+    // Call from the link's update with the receiver's bad-frame counter.
+    Action update(uint32_t nowMs, uint32_t badFrames) {
+        if (!port) {
+            return Action::NONE;
+        }
+        if (state == State::AWAIT_ECHO && nowMs - stateMs > CONFIRM_MS) {
+            state = State::IDLE;
+            lowerCeiling(pendingRate);
+            return currentBaud > baseBaud ? Action::LINK_LOST : Action::NONE;
+        }
+        if (state == State::PROBATION && nowMs - stateMs > CONFIRM_MS) {
+            state = State::IDLE;
+            lowerCeiling(pendingRate);
+            setRate(previousRate);
+            windowValid = false;
+            return Action::NONE;
+        }
+
+        if (!windowValid || nowMs - windowStartMs >= ERROR_WINDOW_MS) {
+            windowValid = true;
+            windowStartMs = nowMs;
+            windowBadFrames = badFrames;
+            return Action::NONE;
+        }
+        if (state == State::IDLE && currentBaud > baseBaud &&
+            badFrames - windowBadFrames >= ERROR_LIMIT) {
+            windowValid = false;
+            pendingRate = stepDown(currentBaud);
+            lowerCeiling(currentBaud);
+            return Action::REQUEST;
+        }
+        return Action::NONE;
+    }
+
+private:
+    enum class State : uint8_t { IDLE, AWAIT_ECHO, PROBATION };
+
+    // Base rate, then every table rate above it up to maxBaud.
+    uint8_t ladder(uint32_t* rates) const {
+        uint8_t count = 0;
+        rates[count++] = baseBaud;
+        for (uint8_t code = 0; code < BinaryProtocol::BAUD_RATE_COUNT; ++code) {
+            const uint32_t rate = BinaryProtocol::baudRate(code);
+            if (rate > baseBaud && rate <= maxBaud) {
+                rates[count++] = rate;
+            }
+        }
+        return count;
+    }
+
+    uint32_t stepDown(uint32_t rate) const {
+        uint32_t rates[BinaryProtocol::BAUD_RATE_COUNT + 1];
+        const uint8_t count = ladder(rates);
+        uint32_t lower = baseBaud;
+        for (uint8_t i = 0; i < count; ++i) {
+            if (rates[i] < rate && rates[i] > lower) {
+                lower = rates[i];
+            }
+        }
+        return lower;
+    }
+
+    void lowerCeiling(uint32_t failedRate) {
+        const uint32_t lower = stepDown(failedRate);
+        if (lower < ceiling) {
+            ceiling = lower;
+        }
+        fallbacks++;
+    }
+
+    void setRate(uint32_t rate) {
+        if (!port || rate == 0) {
+            return;
+        }
+        if (rate != currentBaud) {
+            port->flush(); // Let the last frame at the old rate finish
+            port->end();
+            port->begin(rate);
+        }
+        currentBaud = rate;
+    }
+
+    HardwareSerial* port = nullptr;
+    uint32_t baseBaud = 0;
+    uint32_t maxBaud = 0;
+    uint32_t ceiling = 0;
+    uint32_t currentBaud = 0;
+    uint32_t previousRate = 0;
+    uint32_t pendingRate = 0;
+    State state = State::IDLE;
+    uint32_t stateMs = 0;
+    bool windowValid = false;
+    uint32_t windowStartMs = 0;
+    uint32_t windowBadFrames = 0;
+    uint32_t fallbacks = 0;
+};
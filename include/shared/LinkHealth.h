@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fixed-size health counters for one end of a link. Every link end fills
+// one; CMD_STATS carries them as
+// [STATS_VERSION][block...], block = [LinkId][FIELD_COUNT][FIELD_COUNT × uint32 LSB first]
+// in the field order below, so a reader can skip fields it does not know.
+struct LinkHealth {
+    enum LinkId : uint8_t {
+        LINK_TEENSY_M4 = 0,  // Teensy's end of the M4 UART
+        LINK_TEENSY_GUI = 1, // Teensy's end of the GUI link
+        LINK_M4_TEENSY = 2   // M4's end of the Teensy UART
+    };
+
+    static constexpr uint8_t STATS_VERSION = 1;
+    static constexpr uint8_t FIELD_COUNT = 11;
+    static constexpr uint8_t BLOCK_SIZE = 2 + FIELD_COUNT * 4;
+
+    uint32_t framesSent = 0;
+    uint32_t bytesSent = 0;
+    uint32_t txDropped = 0;      // Frames that never reached the wire
+    uint32_t framesReceived = 0;
+    uint32_t bytesReceived = 0;
+    uint32_t badFrames = 0;      // Checksum or format failures
+    uint32_t resyncs = 0;
+    uint32_t overflows = 0;      // Frames larger than the receive buffer
+    uint32_t txBytesPerSec = 0;  // Over the last full second
+    uint32_t rxBytesPerSec = 0;
+    uint32_t baud = 0;           // 0: not a UART (USB serial)
+
+    // Wire time used, in tenths of a percent (8N1: 10 bits per byte).
+    static uint16_t utilizationPermille(uint32_t bytesPerSec, uint32_t baud) {
+        if (baud == 0) {
+            return 0;
+        }
+        const uint64_t permille = static_cast<uint64_t>(bytesPerSec) * 10 * 1000 / baud;
+        return permille > 1000 ? 1000 : static_cast<uint16_t>(permille);
+    }
+
+    uint16_t txUtilization() const { return utilizationPermille(txBytesPerSec, baud); }
+    uint16_t rxUtilization() const { return utilizationPermille(rxBytesPerSec, baud); }
+
+    // Writes one block; returns BLOCK_SIZE.
+    uint8_t encode(uint8_t linkId, uint8_t* out) const {
+        const uint32_t fields[FIELD_COUNT] = {
+            framesSent, bytesSent, txDropped, framesReceived, bytesReceived,
+            badFrames, resyncs, overflows, txBytesPerSec, rxBytesPerSec, baud
+        };
+        out[0] = linkId;
+        out[1] = FIELD_COUNT;
+        for (uint8_t i = 0; i < FIELD_COUNT; ++i) {
+            for (uint8_t b = 0; b < 4; ++b) {
+                out[2 + i * 4 + b] = static_cast<uint8_t>(fields[i] >> (8 * b));
+            }
+        }
+        return BLOCK_SIZE;
+    }
+
+    // Reads the block at offset and advances it. Fields beyond FIELD_COUNT are
+    // skipped, missing ones stay 0.
+    bool decode(const uint8_t* data, uint16_t length, uint16_t& offset, uint8_t& linkId) {
+        if (offset + 2 > length) {
+            return false;
+        }
+        const uint8_t count = data[offset + 1];
+        if (offset + 2 + count * 4 > length) {
+            return false;
+        }
+        linkId = data[offset];
+        uint32_t fields[FIELD_COUNT] = {};
+        for (uint8_t i = 0; i < count && i < FIELD_COUNT; ++i) {
+            const uint8_t* field = &data[offset + 2 + i * 4];
+            fields[i] = static_cast<uint32_t>(field[0]) |
+                        (static_cast<uint32_t>(field[1]) << 8) |
+                        (static_cast<uint32_t>(field[2]) << 16) |
+                        (static_cast<uint32_t>(field[3]) << 24);
+        }
+        framesSent = fields[0];
+        bytesSent = fields[1];
+        txDropped = fields[2];
+        framesReceived = fields[3];
+        bytesReceived = fields[4];
+        badFrames = fields[5];
+        resyncs = fields[6];
+        overflows = fields[7];
+        txBytesPerSec = fields[8];
+        rxBytesPerSec = fields[9];
+        baud = fields[10];
+        offset += 2 + count * 4;
+        return true;
+    }
+};
+
+// Bytes per second in each direction over the last full second, from running
+// byte totals sampled every loop.
+class LinkRateMeter {
+public:
+    static constexpr uint32_t WINDOW_MS = 1000;
+
+    void sample(uint32_t nowMs, uint32_t txTotal, uint32_t rxTotal) {
+        if (!started) {
+            started = true;
+            restart(nowMs, txTotal, rxTotal);
+            return;
+        }
+        const uint32_t elapsed = nowMs - windowStartMs;
+        if (elapsed < WINDOW_MS) {
+            return;
+        }
+        txPerSec = static_cast<uint32_t>(static_cast<uint64_t>(txTotal - txAtStart) * 1000 / elapsed);
+        rxPerSec = static_cast<uint32_t>(static_cast<uint64_t>(rxTotal - rxAtStart) * 1000 / elapsed);
+        restart(nowMs, txTotal, rxTotal);
+    }
+
+    uint32_t txBytesPerSec() const { return txPerSec; }
+    uint32_t rxBytesPerSec() const { return rxPerSec; }
+
+private:
+    void restart(uint32_t nowMs, uint32_t txTotal, uint32_t rxTotal) {
+        windowStartMs = nowMs;
+        txAtStart = txTotal;
+        rxAtStart = rxTotal;
+    }
+
+    bool started = false;
+    uint32_t windowStartMs = 0;
+    uint32_t txAtStart = 0;
+    uint32_t rxAtStart = 0;
+    uint32_t txPerSec = 0;
+    uint32_t rxPerSec = 0;
+};
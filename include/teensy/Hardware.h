@@ -1,6 +1,9 @@
 #pragma once
 
+#include <stdint.h>
+
 void setupHardware();
 void loopHardware();
 void setSelectedTrack(int trackIndex); // Update selected track for encoders
 void handleMixerBankChangeFromGUI(int bank); // Handle mixer bank change from GUI
+uint32_t getEncoderResyncs(); // Encoder turns that started from a newer value sent by Live
@@ -9,6 +9,7 @@ extern LiveController liveController;
 Faders::Faders()
     : currentBankOffset(0)
     , paramMode(FaderParamMode::VOLUME_PAN)
+    , syncedVolumeVersion(0)
     , onVolumeChange(nullptr)
     , onPickupStateChange(nullptr)
 {
@@ -66,6 +67,23 @@ void Faders::setTrackBank(int bankOffset) {
         Serial.printf("  Fader %d → Track %d (needs pickup)\n",
                      i, pickupStates[i].assignedTrackIndex);
     }
+
+    // Los nuevos tracks ya tienen volumen conocido en el estado de Live
+    syncVolumeTargets();
+}
+
+void Faders::syncVolumeTargets() {
+    const LiveStateModel& state = liveController.getState();
+    syncedVolumeVersion = state.version(LiveStateModel::TRACK_VOLUME);
+
+    for (int i = 0; i < NUM_FADERS; i++) {
+        int trackIndex = pickupStates[i].assignedTrackIndex;
+        if (trackIndex < LiveStateModel::TRACKS &&
+            state.isValid(LiveStateModel::TRACK_VOLUME, static_cast<uint8_t>(trackIndex))) {
+            // 14-bit → 7-bit, la escala del fader
+            onTrackVolumeUpdate(trackIndex, state.volume(static_cast<uint8_t>(trackIndex)) >> 7);
+        }
+    }
 }
 
 void Faders::onTrackVolumeUpdate(int trackIndex, int volume) {
@@ -101,6 +119,11 @@ void Faders::read() {
     static int maxRawValues[NUM_FADERS] = {0};  // Track max values seen
     static unsigned long lastPickupLog[NUM_FADERS] = {0};  // Rate limit pickup logs
 
+    // Live cambió algún volumen desde la última lectura → actualizar targets
+    if (liveController.getState().version(LiveStateModel::TRACK_VOLUME) != syncedVolumeVersion) {
+        syncVolumeTargets();
+    }
+
     for (int i = 0; i < NUM_FADERS; i++) {
         // Leer ADC 12-bit y convertir a 7-bit MIDI (0-127)
         int rawValue = analogRead(pins[i]);
@@ -43,6 +43,7 @@ private:
     int currentBankOffset;              // Offset del banco actual (0, 4, 8...)
     FaderParamMode paramMode;            // Modo de parámetros (Volume/Pan, Sends, etc.)
     FaderPickupState pickupStates[NUM_FADERS];
+    uint16_t syncedVolumeVersion;        // Versión de volúmenes del LiveStateModel ya aplicada
 
 public:
     // Callbacks (moved after private members to match initialization order)
@@ -52,6 +53,7 @@ public:
 private:
 
     bool checkPickup(int faderIndex, int physicalValue, int targetValue);
+    void syncVolumeTargets();  // Targets de pickup desde el estado de Live
     void sendVolumeCommand(int trackIndex, int volume);
     void sendParamCommand(int trackIndex, uint8_t paramType, int value);
 };
@@ -7,6 +7,14 @@
 
 extern NeoTrellisController controller;
 
+namespace {
+const uint8_t HANDSHAKE_ID[] = {'P','U','S','H','C','L','O','N','E'};
+constexpr uint16_t LINK_CAPS = BinaryProtocol::CAP_COBS | BinaryProtocol::CAP_CRC8 |
+                               BinaryProtocol::CAP_CRC16 | BinaryProtocol::CAP_BATCH |
+                               BinaryProtocol::CAP_LED_DELTA | BinaryProtocol::CAP_EXT_LEN |
+                               BinaryProtocol::CAP_LED_PAD_FULL;
+}
+
 // Use built-in Serial1 (SERCOM4) on pins 22 (RX) and 21 (TX)
 
 void UartInterface::begin() {
@@ -17,16 +25,15 @@ void UartInterface::begin() {
     Serial.print(UART_BAUD_RATE);
     Serial.println(" bps");
     
-    // Initialize built-in Serial1
-    Serial1.begin(UART_BAUD_RATE);
+    // Initialize built-in Serial1 (LinkBaud starts it at the base rate)
+    baud.begin(Serial1, UART_BAUD_RATE, UART_MAX_BAUD_M4);
     
     // Small delay to ensure initialization
     delay(200);
     
-    rxIndex = 0;
-    messageComplete = false;
+    parser.reset();
+    linkMode = BinaryProtocol::LinkMode();
     everReceived = false;
-    expectedPacketLength = 0;
     beginMs = millis();
     
     Serial.println("NeoTrellis M4: Serial1 initialized successfully!");
@@ -39,7 +46,17 @@ void UartInterface::begin() {
     Serial.println("  GND -> GND");
     Serial.println("Waiting for data from Teensy (Serial1)...");
 
+    // The Teensy may still be at a rate negotiated before this reset:
+    // announce it at every rate, ending back at the base one
     Serial.println("NeoTrellis M4: Notifying Teensy of reset/disconnect state");
+    for (uint8_t attempt = 1; attempt < BinaryProtocol::BAUD_RATE_COUNT + 1; ++attempt) {
+        baud.hunt(attempt);
+        if (baud.current() == UART_BAUD_RATE) {
+            break;
+        }
+        sendToTeensy(CMD_DISCONNECT, nullptr, 0);
+    }
+    baud.reset();
     sendToTeensy(CMD_DISCONNECT, nullptr, 0);
 }
 
@@ -55,82 +72,141 @@ void UartInterface::read() {
         debugPrinted = (millis() > 30000);
     }
 
-    while (Serial1.available()) {
-        if (!everReceived) {
-            Serial.println("NeoTrellis M4: First UART byte received from Teensy!");
-            everReceived = true;
-        }
+    if (!everReceived && Serial1.available()) {
+        Serial.println("NeoTrellis M4: First UART byte received from Teensy!");
+        everReceived = true;
+    }
 
-        uint8_t byte = Serial1.read();
+    const uint32_t badBefore = parser.getStats().badFrames;
+    parser.poll(Serial1, linkMode, [this](const FrameView& frame) { handleFrame(frame); });
+    if (parser.getStats().badFrames != badBefore) {
+        Serial.println("NeoTrellis M4: Invalid binary message (bad checksum/format)");
+    }
 
-        if (byte == BinaryProtocol::BINARY_SYNC_BYTE) {
-            rxIndex = 0;
-            expectedPacketLength = 0;
-            messageComplete = false;
-            rxBuffer[rxIndex++] = byte;
-            continue;
+    if (baud.update(millis(), parser.getStats().badFrames) == LinkBaud::Action::REQUEST) {
+        // Only the Teensy switches rates; ask it to step down
+        uint8_t code = BinaryProtocol::baudCode(baud.requestedBaud());
+        if (code != BinaryProtocol::BAUD_CODE_NONE) {
+            Serial.println("NeoTrellis M4: UART errors at the upgraded rate, proposing a slower one");
+            sendToTeensy(CMD_LINK_BAUD, &code, 1);
         }
+    }
+    meter.sample(millis(), bytesSent, parser.getStats().bytes);
+}
 
-        if (rxIndex == 0) {
-            continue;
-        }
+LinkHealth UartInterface::getHealth() const {
+    LinkHealth health;
+    health.framesSent = framesSent;
+    health.bytesSent = bytesSent;
+    health.txDropped = txDropped;
+    const FrameParserStats& rx = parser.getStats();
+    health.framesReceived = rx.frames;
+    health.bytesReceived = rx.bytes;
+    health.badFrames = rx.badFrames;
+    health.resyncs = rx.resyncs;
+    health.overflows = rx.overflows;
+    health.txBytesPerSec = meter.txBytesPerSec();
+    health.rxBytesPerSec = meter.rxBytesPerSec();
+    health.baud = baud.current();
+    return health;
+}
 
-        if (rxIndex < BUFFER_SIZE) {
-            rxBuffer[rxIndex++] = byte;
-        } else {
-            Serial.println("NeoTrellis M4: UART message too long, dropping");
-            rxIndex = 0;
-            expectedPacketLength = 0;
-            continue;
-        }
+// Reply to the Teensy's CMD_STATS poll with this end's counters.
+void UartInterface::sendStats() {
+    uint8_t payload[1 + LinkHealth::BLOCK_SIZE];
+    payload[0] = LinkHealth::STATS_VERSION;
+    const uint8_t length = 1 + getHealth().encode(LinkHealth::LINK_M4_TEENSY, &payload[1]);
+    sendToTeensy(CMD_STATS, payload, length);
+}
 
-        if (rxIndex >= 3 && expectedPacketLength == 0) {
-            uint8_t payloadLen = rxBuffer[2];
-            expectedPacketLength = BinaryProtocol::getMessageSize(payloadLen);
-            if (expectedPacketLength > BUFFER_SIZE) {
-                Serial.println("NeoTrellis M4: Binary packet too large");
-                rxIndex = 0;
-                expectedPacketLength = 0;
-                continue;
-            }
-        }
+void UartInterface::handleFrame(const FrameView& frame) {
+    if (frame.framing == BinaryProtocol::Framing::SYNC &&
+        linkMode.framing == BinaryProtocol::Framing::COBS &&
+        !acceptsSyncFrame(frame.command, frame.payload, frame.length)) {
+        return;
+    }
+    baud.frameReceived();
+    handleTeensyCommand(frame.command, const_cast<uint8_t*>(frame.payload), frame.length);
+}
 
-        if (expectedPacketLength != 0) {
-            if (rxIndex == expectedPacketLength) {
-                messageComplete = true;
-                parseMessage();
-                rxIndex = 0;
-                expectedPacketLength = 0;
-            } else if (rxIndex > expectedPacketLength) {
-                Serial.println("NeoTrellis M4: Invalid message length, dropping");
-                rxIndex = 0;
-                expectedPacketLength = 0;
-            }
-        }
+// While in COBS mode the SYNC parser only lets through link-control frames
+// that a restarted Teensy would send: its handshake and a bare disconnect.
+bool UartInterface::acceptsSyncFrame(uint8_t command, const uint8_t* payload, uint16_t length) const {
+    if (command == CMD_DISCONNECT) {
+        return length == 0;
     }
+    if (command == CMD_HANDSHAKE) {
+        return payload && length >= sizeof(HANDSHAKE_ID) &&
+               memcmp(payload, HANDSHAKE_ID, sizeof(HANDSHAKE_ID)) == 0;
+    }
+    return false;
 }
 
-void UartInterface::parseMessage() {
-    uint8_t command;
-    const uint8_t* payload;
-    uint8_t payloadLen;
+void UartInterface::handleHandshake(const uint8_t* data, int length) {
+    BinaryProtocol::LinkCaps local;
+    local.flags = LINK_CAPS;
+    local.maxBaud = baud.offered();
+    local.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    BinaryProtocol::LinkCaps peer;
+    if (!BinaryProtocol::findCaps(data, static_cast<uint8_t>(length), peer)) {
+        peer = BinaryProtocol::LinkCaps(); // Legacy Teensy firmware: no capability block
+    }
+    const BinaryProtocol::LinkCaps agreed = BinaryProtocol::agreeCaps(local, peer);
 
-    bool valid = BinaryProtocol::parseMessage(
-        rxBuffer,
-        rxIndex,
-        command,
-        payload,
-        payloadLen
-    );
+    // Reply goes out SYNC-framed at the rate the request came in on; switch
+    // mode and go back to the base rate only once it is on the wire
+    linkMode = BinaryProtocol::LinkMode();
+    uint8_t reply[BinaryProtocol::CAPS_BLOCK_SIZE];
+    uint8_t replyLen = BinaryProtocol::appendCaps(nullptr, 0, agreed, reply, sizeof(reply));
+    sendToTeensy(CMD_HANDSHAKE_REPLY, reply, replyLen);
 
-    if (!valid) {
-        Serial.println("NeoTrellis M4: Invalid binary message (bad checksum/format)");
-        messageComplete = false;
+    linkMode = BinaryProtocol::modeFromCaps(agreed);
+    baud.reset();
+    Serial.print("NeoTrellis M4: Link mode -> ");
+    Serial.print(BinaryProtocol::framingName(linkMode.framing));
+    Serial.print("/");
+    Serial.println(BinaryProtocol::integrityName(linkMode.integrity));
+}
+
+// Echo the requested rate at the current one, then switch. Without a valid
+// frame at the new rate within LinkBaud::CONFIRM_MS the old rate comes back.
+void UartInterface::handleLinkBaud(const uint8_t* data, int length) {
+    if (length < 1) {
+        return;
+    }
+    const uint32_t rate = BinaryProtocol::baudRate(data[0]);
+    if (!baud.accepts(rate)) {
+        Serial.print("NeoTrellis M4: Ignoring unsupported baud code ");
+        Serial.println(data[0]);
         return;
     }
+    uint8_t code = data[0];
+    sendToTeensy(CMD_LINK_BAUD, &code, 1);
+    baud.switchTo(rate, millis());
+    Serial.print("NeoTrellis M4: UART -> ");
+    Serial.print(rate);
+    Serial.println(" bps");
+}
 
-    handleTeensyCommand(command, const_cast<uint8_t*>(payload), payloadLen);
-    messageComplete = false;
+// Unpack a CMD_BATCH payload in place; entries point into the frame buffer.
+void UartInterface::handleBatch(uint8_t* data, int length) {
+    uint16_t offset = 0;
+    uint8_t command;
+    const uint8_t* payload;
+    uint8_t payloadLen;
+    inBatch = true;
+    while (BinaryProtocol::nextBatchEntry(data, static_cast<uint16_t>(length), offset,
+                                          command, payload, payloadLen)) {
+        if (!BinaryProtocol::isBatchable(command)) {
+            continue;
+        }
+        handleTeensyCommand(command, const_cast<uint8_t*>(payload), payloadLen);
+    }
+    inBatch = false;
+    controller.showPixels();
+    if (offset != length) {
+        Serial.println("NeoTrellis M4: Truncated batch entry, dropping remainder");
+    }
 }
 
 void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int length) {
@@ -138,7 +214,7 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
         case CMD_HANDSHAKE:
             Serial.println("NeoTrellis M4: Handshake request received from Teensy.");
             Serial.println("NeoTrellis M4: Sending handshake reply...");
-            sendToTeensy(CMD_HANDSHAKE_REPLY, nullptr, 0);
+            handleHandshake(data, length);
             break;
         case CMD_UART_CONFIRMATION_ANIMATION:
             Serial.println("NeoTrellis M4: Received request for connection animation.");
@@ -154,7 +230,7 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
                 uint8_t r7 = data[1];
                 uint8_t g7 = data[2];
                 uint8_t b7 = data[3];
-                controller.applyPadColor7bit(padIndex, r7, g7, b7);
+                controller.applyPadColor7bit(padIndex, r7, g7, b7, !inBatch);
                 Serial.print("NeoTrellis M4: Set RGB pad ");
                 Serial.print(padIndex);
                 Serial.print(" -> ");
@@ -165,6 +241,11 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
                 Serial.println(b7);
             }
             break;
+        case CMD_LED_PAD_UPDATE:
+            if (length >= 4) {
+                controller.applyPadColor8bit(data[0], data[1], data[2], data[3], !inBatch);
+            }
+            break;
         case CMD_LED_CLIP_STATE:
             if (length >= 2) {
                 int padIndex = data[0];
@@ -197,6 +278,66 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
             }
             break;
 
+        case CMD_LED_GRID_DELTA:
+            // [mask0..mask3][R,G,B per set bit]: applied without the per-pad
+            // flicker suppression, the Teensy only sends pads that changed
+            if (length >= 4) {
+                uint32_t mask = static_cast<uint32_t>(data[0]) |
+                                (static_cast<uint32_t>(data[1]) << 8) |
+                                (static_cast<uint32_t>(data[2]) << 16) |
+                                (static_cast<uint32_t>(data[3]) << 24);
+                int offset = 4;
+                for (int pad = 0; pad < TOTAL_KEYS && offset + 3 <= length; ++pad) {
+                    if (!((mask >> pad) & 1UL)) continue;
+                    controller.applyPadColor8bit(pad, data[offset], data[offset + 1], data[offset + 2], false);
+                    offset += 3;
+                }
+                if (!inBatch) {
+                    controller.showPixels();
+                }
+                controller.setGridInitialized(true);
+            } else {
+                Serial.print("NeoTrellis M4: Invalid grid delta length: ");
+                Serial.println(length);
+            }
+            break;
+
+        case CMD_LED_PAD_FULL:
+            // [pad, state, R, G, B]: state and colour of one pad, one show()
+            if (length >= 5) {
+                if (data[1] != LED_PAD_STATE_KEEP) {
+                    controller.setClipStateCache(data[0], data[1]);
+                }
+                controller.applyPadColor8bit(data[0], data[2], data[3], data[4], !inBatch);
+            }
+            break;
+
+        case CMD_LED_PAD_FULL_BULK:
+            // [mask0..mask3][state, R, G, B per set bit]
+            if (length >= 4) {
+                uint32_t mask = static_cast<uint32_t>(data[0]) |
+                                (static_cast<uint32_t>(data[1]) << 8) |
+                                (static_cast<uint32_t>(data[2]) << 16) |
+                                (static_cast<uint32_t>(data[3]) << 24);
+                int offset = 4;
+                for (int pad = 0; pad < TOTAL_KEYS && offset + 4 <= length; ++pad) {
+                    if (!((mask >> pad) & 1UL)) continue;
+                    if (data[offset] != LED_PAD_STATE_KEEP) {
+                        controller.setClipStateCache(pad, data[offset]);
+                    }
+                    controller.applyPadColor8bit(pad, data[offset + 1], data[offset + 2], data[offset + 3], false);
+                    offset += 4;
+                }
+                if (!inBatch) {
+                    controller.showPixels();
+                }
+                controller.setGridInitialized(true);
+            } else {
+                Serial.print("NeoTrellis M4: Invalid pad bulk length: ");
+                Serial.println(length);
+            }
+            break;
+
         case CMD_LED_TRANSPORT_STATE:
             Serial.println("NeoTrellis M4: Transport state update received");
             break;
@@ -211,7 +352,7 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
                 uint8_t r = (uint8_t)(((data[1] & 0x7F) << 7) | (data[2] & 0x7F));
                 uint8_t g = (uint8_t)(((data[3] & 0x7F) << 7) | (data[4] & 0x7F));
                 uint8_t b = (uint8_t)(((data[5] & 0x7F) << 7) | (data[6] & 0x7F));
-                controller.applyPadColor8bit(padIndex, r, g, b);
+                controller.applyPadColor8bit(padIndex, r, g, b, !inBatch);
                 Serial.print("NeoTrellis M4: Set 14-bit RGB pad ");
                 Serial.print(padIndex);
                 Serial.print(" -> ");
@@ -232,11 +373,25 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
             controller.disableKeyScanning();
             break;
 
+        case CMD_BATCH:
+            handleBatch(data, length);
+            break;
+
+        case CMD_LINK_BAUD:
+            handleLinkBaud(data, length);
+            break;
+
+        case CMD_STATS:
+            sendStats();
+            break;
+
         case CMD_DISCONNECT:
             Serial.println("NeoTrellis M4: Teensy requested disconnect/reset, clearing grid");
             controller.disableKeyScanning();
             controller.allOff();
             controller.setGridInitialized(false);
+            linkMode = BinaryProtocol::LinkMode();
+            baud.reset();
             break;
 
         default:
@@ -247,20 +402,23 @@ void UartInterface::handleTeensyCommand(uint8_t command, uint8_t* data, int leng
 }
 
 void UartInterface::sendToTeensy(uint8_t command, uint8_t* data, int length) {
-    // Use BinaryProtocol to build message
-    uint8_t txBuffer[BUFFER_SIZE];
-    uint16_t messageLen = BinaryProtocol::buildMessage(
+    // Use BinaryProtocol to build message in the negotiated link mode
+    uint8_t txBuffer[BinaryProtocol::MAX_FRAME_SIZE];
+    uint16_t messageLen = BinaryProtocol::buildFrame(
+        BinaryProtocol::modeFor(command, linkMode),
         command,
         data,
         length,
         txBuffer,
-        BUFFER_SIZE
+        sizeof(txBuffer)
     );
 
     if (messageLen > 0) {
         // Send message via Serial1
         Serial1.write(txBuffer, messageLen);
         Serial1.flush(); // Ensure data is sent immediately
+        framesSent++;
+        bytesSent += messageLen;
 
         Serial.print("NeoTrellis M4: Sent command 0x");
         Serial.print(command, HEX);
@@ -270,6 +428,7 @@ void UartInterface::sendToTeensy(uint8_t command, uint8_t* data, int length) {
         Serial.print(messageLen);
         Serial.println(" bytes");
     } else {
+        txDropped++;
         Serial.println("NeoTrellis M4: ERROR - Failed to build message (buffer too small)");
     }
 }
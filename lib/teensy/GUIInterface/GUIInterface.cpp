@@ -1,6 +1,8 @@
 #include "GUIInterface/GUIInterface.h"
 #include "../UIBridge.h"
 #include "../LiveController/LiveController.h"
+#include "../UartHandler/UartHandler.h"
+#include "shared/Config.h"
 #include <math.h>
 #include <cstring>
 
@@ -12,22 +14,39 @@ constexpr unsigned long GUI_HANDSHAKE_RETRY_MS = 2000;
 const uint8_t GUI_HANDSHAKE_PAYLOAD[] = {
     'P','U','S','H','C','L','O','N','E','_','G','U','I'
 };
+constexpr uint16_t GUI_LINK_CAPS = BinaryProtocol::CAP_COBS | BinaryProtocol::CAP_CRC8 |
+                                   BinaryProtocol::CAP_CRC16 | BinaryProtocol::CAP_BATCH |
+                                   BinaryProtocol::CAP_EXT_LEN | BinaryProtocol::CAP_NAME_IDS;
+constexpr uint16_t GUI_TX_CHUNK_SIZE = 64; // Frames reach the port in pieces this size
 }
 
 extern UIBridge uiBridge;
 extern LiveController liveController;
+extern UartHandler uartHandler;
 
 void GUIInterface::begin(Stream& serialPort) {
     io = &serialPort;
+    baud.detach();
+    start();
+}
+
+void GUIInterface::begin(HardwareSerial& serialPort, uint32_t baseBaud) {
+    io = &serialPort;
+    baud.begin(serialPort, baseBaud, GUI_MAX_BAUD_RATE);
+    start();
+}
+
+void GUIInterface::start() {
     lastHeartbeatMs = millis();
-    rxIndex = 0;
-    expectedLength = 0;
+    parser.reset();
+    linkMode = BinaryProtocol::LinkMode();
     lastPingMs = 0;
     lastPongMs = 0;
     guiConnected = false;
     handshakePending = false;
     disconnectNotified = false;
     everConnected = false;
+    handshakeAttempts = 0;
     if (io) {
         sendDisconnectEvent();
         sendHandshake();
@@ -45,36 +64,51 @@ void GUIInterface::update() {
             sendHandshake();
         }
     } else {
+        const bool wasAwaitingEcho = baud.awaitingEcho();
+        switch (baud.update(now, parser.getStats().badFrames)) {
+            case LinkBaud::Action::REQUEST:
+                Serial.println("GUIInterface: Errores UART, bajando la velocidad");
+                requestBaud(baud.requestedBaud());
+                break;
+            case LinkBaud::Action::LINK_LOST:
+                Serial.println("GUIInterface: La GUI no responde a la velocidad negociada");
+                dropLink();
+                return;
+            default:
+                break;
+        }
+        if (wasAwaitingEcho && !baud.awaitingEcho()) {
+            finishBaudChange(); // No echo: still at the old rate
+        }
         if (now - lastPingMs > GUI_PING_INTERVAL_MS) {
             sendBinary(CMD_PING, nullptr, 0);
             lastPingMs = now;
         }
         if (lastPongMs != 0 && (now - lastPongMs) > GUI_TIMEOUT_MS) {
             Serial.println("GUIInterface: Ping timeout tras 3 intentos sin respuesta");
-            sendDisconnectEvent();
-            guiConnected = false;
-            handshakePending = false;
-            lastPongMs = 0;
+            dropLink();
         }
     }
 
+    meter.sample(now, bytesSent, parser.getStats().bytes);
+
     if (now - lastHeartbeatMs >= HEARTBEAT_INTERVAL_MS) {
         lastHeartbeatMs = now;
     }
 }
 
 void GUIInterface::sendGridColors7bit(const uint8_t* data, int length) {
-    if (!io || !data || length <= 0 || length > 255) {
+    if (!io || !data || length <= 0 || length > BinaryProtocol::MAX_EXT_PAYLOAD_SIZE) {
         return;
     }
-    sendBinary(CMD_LED_GRID_UPDATE, data, static_cast<uint8_t>(length));
+    sendBinary(CMD_LED_GRID_UPDATE, data, static_cast<uint16_t>(length));
 }
 
 void GUIInterface::sendGridColors14bit(const uint8_t* data, int length) {
-    if (!io || !data || length <= 0 || length > 255) {
+    if (!io || !data || length <= 0 || length > BinaryProtocol::MAX_EXT_PAYLOAD_SIZE) {
         return;
     }
-    sendBinary(CMD_LED_GRID_UPDATE_14, data, static_cast<uint8_t>(length));
+    sendBinary(CMD_LED_GRID_UPDATE_14, data, static_cast<uint16_t>(length));
 }
 
 void GUIInterface::sendPadColor14bit(int padIndex,
@@ -108,24 +142,64 @@ void GUIInterface::sendClipState(uint8_t track, uint8_t scene, uint8_t state,
 }
 
 void GUIInterface::sendClipName(uint8_t track, uint8_t scene, const char* name) {
+    if (!name) return;
+    sendClipName(track, scene, name, strnlen(name, 240));
+}
+
+void GUIInterface::sendClipName(uint8_t track, uint8_t scene, const char* name, size_t len) {
     if (!io || !name) return;
-    size_t len = strnlen(name, 240);
     if (len > 240) len = 240;
-    uint8_t payload[242];
-    payload[0] = track & 0x7F;
-    payload[1] = scene & 0x7F;
-    memcpy(&payload[2], name, len);
-    sendBinary(CMD_CLIP_NAME, payload, static_cast<uint8_t>(len + 2));
+    const uint8_t header[] = {
+        static_cast<uint8_t>(track & 0x7F),
+        static_cast<uint8_t>(scene & 0x7F)
+    };
+    const BinaryProtocol::Slice slices[] = {
+        {header, sizeof(header)},
+        {reinterpret_cast<const uint8_t*>(name), static_cast<uint16_t>(len)}
+    };
+    sendSlices(CMD_CLIP_NAME, slices, 2);
 }
 
 void GUIInterface::sendTrackName(uint8_t track, const char* name) {
+    if (!name) return;
+    sendTrackName(track, name, strnlen(name, 250));
+}
+
+void GUIInterface::sendTrackName(uint8_t track, const char* name, size_t len) {
     if (!io || !name) return;
-    size_t len = strnlen(name, 250);
     if (len > 250) len = 250;
-    uint8_t payload[251];
-    payload[0] = track & 0x7F;
-    memcpy(&payload[1], name, len);
-    sendBinary(CMD_TRACK_NAME, payload, static_cast<uint8_t>(len + 1));
+    const uint8_t header = track & 0x7F;
+    const BinaryProtocol::Slice slices[] = {
+        {&header, 1},
+        {reinterpret_cast<const uint8_t*>(name), static_cast<uint16_t>(len)}
+    };
+    sendSlices(CMD_TRACK_NAME, slices, 2);
+}
+
+void GUIInterface::sendNameDefine(uint16_t id, const char* name, size_t len) {
+    if (!io || !name) return;
+    if (len > 240) len = 240;
+    const uint8_t header[] = {
+        static_cast<uint8_t>((id >> 7) & 0x7F),
+        static_cast<uint8_t>(id & 0x7F)
+    };
+    const BinaryProtocol::Slice slices[] = {
+        {header, sizeof(header)},
+        {reinterpret_cast<const uint8_t*>(name), static_cast<uint16_t>(len)}
+    };
+    sendSlices(CMD_NAME_DEFINE, slices, 2);
+}
+
+void GUIInterface::sendNameRef(uint8_t kind, uint8_t index, uint8_t scene, uint16_t id) {
+    if (!io) return;
+    uint8_t payload[] = {
+        static_cast<uint8_t>(kind & 0x7F),
+        static_cast<uint8_t>(index & 0x7F),
+        static_cast<uint8_t>(scene & 0x7F),
+        static_cast<uint8_t>((id >> 7) & 0x7F),
+        static_cast<uint8_t>(id & 0x7F)
+    };
+    sendBinary(CMD_NAME_REF, payload, sizeof(payload));
 }
 
 void GUIInterface::sendTrackColor(uint8_t track, uint8_t r, uint8_t g, uint8_t b) {
@@ -140,13 +214,19 @@ void GUIInterface::sendTrackColor(uint8_t track, uint8_t r, uint8_t g, uint8_t b
 }
 
 void GUIInterface::sendSceneName(uint8_t scene, const char* name) {
+    if (!name) return;
+    sendSceneName(scene, name, strnlen(name, 250));
+}
+
+void GUIInterface::sendSceneName(uint8_t scene, const char* name, size_t len) {
     if (!io || !name) return;
-    size_t len = strnlen(name, 250);
     if (len > 250) len = 250;
-    uint8_t payload[251];
-    payload[0] = scene & 0x7F;
-    memcpy(&payload[1], name, len);
-    sendBinary(CMD_SCENE_NAME, payload, static_cast<uint8_t>(len + 1));
+    const uint8_t header = scene & 0x7F;
+    const BinaryProtocol::Slice slices[] = {
+        {&header, 1},
+        {reinterpret_cast<const uint8_t*>(name), static_cast<uint16_t>(len)}
+    };
+    sendSlices(CMD_SCENE_NAME, slices, 2);
 }
 
 void GUIInterface::sendSceneColor(uint8_t scene, uint8_t r, uint8_t g, uint8_t b) {
@@ -299,6 +379,16 @@ void GUIInterface::sendMixerArm(uint8_t track, uint8_t state) {
     sendBinary(CMD_MIXER_ARM, payload, sizeof(payload));
 }
 
+void GUIInterface::sendMeters(const uint8_t* frame, uint8_t length) {
+    if (!io) return;
+    sendBinary(CMD_METER_FRAME, frame, length);
+}
+
+void GUIInterface::sendPositions(const uint8_t* frame, uint8_t length) {
+    if (!io) return;
+    sendBinary(CMD_POSITION_FRAME, frame, length);
+}
+
 void GUIInterface::sendTag(const char* tag) {}
 
 void GUIInterface::printHexPreview(const uint8_t* data, int length, int maxBytes) {}
@@ -312,6 +402,14 @@ static const char* commandName(uint8_t cmd) {
         case CMD_LED_GRID_UPDATE: return "LED_GRID_UPDATE";
         case CMD_LED_GRID_UPDATE_14: return "LED_GRID_UPDATE_14";
         case CMD_LED_PAD_UPDATE_14: return "LED_PAD_UPDATE_14";
+        case CMD_BATCH: return "BATCH";
+        case CMD_LINK_BAUD: return "LINK_BAUD";
+        case CMD_STATS: return "STATS";
+        case CMD_PROFILE: return "PROFILE";
+        case CMD_METER_FRAME: return "METER_FRAME";
+        case CMD_POSITION_FRAME: return "POSITION_FRAME";
+        case CMD_NAME_DEFINE: return "NAME_DEFINE";
+        case CMD_NAME_REF: return "NAME_REF";
         case CMD_CLIP_NAME: return "CLIP_NAME";
         case CMD_TRACK_NAME: return "TRACK_NAME";
         case CMD_TRANSPORT_TEMPO: return "TRANSPORT_TEMPO";
@@ -323,38 +421,215 @@ static const char* commandName(uint8_t cmd) {
 }
 #endif
 
-void GUIInterface::sendBinary(uint8_t cmd, const uint8_t* payload, uint8_t len) {
+void GUIInterface::sendBinary(uint8_t cmd, const uint8_t* payload, uint16_t len) {
+    const BinaryProtocol::Slice slice = {payload, len};
+    sendSlices(cmd, &slice, 1);
+}
+
+void GUIInterface::sendSlices(uint8_t cmd, const BinaryProtocol::Slice* slices, uint8_t sliceCount) {
     if (!io) return;
-    uint8_t buffer[260];
-    uint16_t written = BinaryProtocol::buildMessage(cmd, payload, len, buffer, sizeof(buffer));
-    if (written > 0) {
-        io->write(buffer, written);
-#ifdef DEBUG_GUI_VERBOSE
-        if (cmd != CMD_PING) {
-            Serial.print("GUI TX ");
-            Serial.print(commandName(cmd));
-            Serial.print(" (0x");
-            Serial.print(cmd, HEX);
-            Serial.print(") len=");
-            Serial.print(len);
-            Serial.print(" frame: ");
-            for (uint16_t i = 0; i < written; ++i) {
-                if (i) Serial.print(' ');
-                Serial.print(buffer[i], HEX);
-            }
-            Serial.println();
+    const uint16_t len = BinaryProtocol::sliceLength(slices, sliceCount);
+    if (len > linkMode.maxPayload) {
+        txDropped++;
+        return; // Larger than the GUI accepts
+    }
+    if (batch.active() && linkMode.batch && BinaryProtocol::isBatchable(cmd) &&
+        len <= BinaryProtocol::MAX_PAYLOAD_SIZE - BinaryProtocol::BATCH_ENTRY_HEADER) {
+        if (!batch.fits(static_cast<uint8_t>(len))) {
+            flushBatch();
         }
-#endif
+        batch.add(cmd, slices, sliceCount);
+        return;
+    }
+
+    // Anything queued goes out first to keep ordering
+    flushBatch();
+    writeFrame(cmd, slices, sliceCount, len);
+}
+
+void GUIInterface::beginBatch() {
+    batch.depth++;
+}
+
+void GUIInterface::endBatch() {
+    if (batch.depth == 0) return;
+    if (--batch.depth == 0) {
+        flushBatch();
     }
 }
 
+void GUIInterface::flushBatch() {
+    if (batch.count == 0) return;
+
+    if (batch.count == 1 || !linkMode.batch) {
+        // Single entry (no container overhead) or the GUI renegotiated
+        // without batching while entries were queued: send them one by one
+        uint16_t offset = 0;
+        uint8_t cmd = 0;
+        const uint8_t* payload = nullptr;
+        uint8_t len = 0;
+        while (BinaryProtocol::nextBatchEntry(batch.payload, batch.length, offset, cmd, payload, len)) {
+            const BinaryProtocol::Slice slice = {payload, len};
+            writeFrame(cmd, &slice, 1, len);
+        }
+    } else {
+        const BinaryProtocol::Slice slice = {batch.payload, batch.length};
+        writeFrame(CMD_BATCH, &slice, 1, batch.length);
+    }
+    batch.clear();
+}
+
+// Header, payload slices and trailer go to the port as they are encoded;
+// slices of a chunk or more are written straight from the caller's memory.
+void GUIInterface::writeFrame(uint8_t cmd, const BinaryProtocol::Slice* slices, uint8_t sliceCount,
+                              uint16_t len) {
+    if (!io) return;
+    if (baud.awaitingEcho() && cmd != CMD_LINK_BAUD && !BinaryProtocol::isLinkControl(cmd)) {
+        txDropped++;
+        replayAfterBaud = true; // The GUI gets the whole state once the rate settles
+        return; // The GUI may already be at the new rate: this would arrive as noise
+    }
+    const BinaryProtocol::LinkMode mode = BinaryProtocol::modeFor(cmd, linkMode);
+    BinaryProtocol::PrintSink<GUI_TX_CHUNK_SIZE> sink(*io);
+    BinaryProtocol::FrameEncoder<BinaryProtocol::PrintSink<GUI_TX_CHUNK_SIZE>> encoder(sink, mode);
+    if (!encoder.begin(cmd, len)) {
+        txDropped++;
+        return;
+    }
+    encoder.write(slices, sliceCount);
+    encoder.finish();
+    sink.flush();
+    framesSent++;
+    bytesSent += BinaryProtocol::getFrameSize(mode, len);
+#ifdef DEBUG_GUI_VERBOSE
+    if (cmd != CMD_PING) {
+        Serial.print("GUI TX ");
+        Serial.print(commandName(cmd));
+        Serial.print(" (0x");
+        Serial.print(cmd, HEX);
+        Serial.print(") len=");
+        Serial.print(len);
+        Serial.print(" ");
+        Serial.print(BinaryProtocol::framingName(mode.framing));
+        Serial.print("/");
+        Serial.println(BinaryProtocol::integrityName(mode.integrity));
+    }
+#endif
+}
+
 void GUIInterface::sendHandshake() {
-    if (!io || handshakePending) return;
-    sendBinary(CMD_HANDSHAKE, GUI_HANDSHAKE_PAYLOAD, sizeof(GUI_HANDSHAKE_PAYLOAD));
+    if (!io) return;
+    // Retries walk the baud ladder in case the GUI is still at a faster rate
+    baud.hunt(handshakeAttempts++);
+    BinaryProtocol::LinkCaps caps;
+    caps.flags = GUI_LINK_CAPS;
+    caps.maxBaud = baud.offered();
+    caps.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    uint8_t payload[sizeof(GUI_HANDSHAKE_PAYLOAD) + BinaryProtocol::CAPS_BLOCK_SIZE];
+    uint8_t len = BinaryProtocol::appendCaps(GUI_HANDSHAKE_PAYLOAD, sizeof(GUI_HANDSHAKE_PAYLOAD),
+                                             caps, payload, sizeof(payload));
+    sendBinary(CMD_HANDSHAKE, payload, len);
     handshakePending = true;
     lastPingMs = millis();
 }
 
+// Ask the GUI to switch rate; it echoes the code at the current rate first.
+void GUIInterface::requestBaud(uint32_t rate) {
+    uint8_t code = BinaryProtocol::baudCode(rate);
+    if (code == BinaryProtocol::BAUD_CODE_NONE) {
+        return;
+    }
+    flushBatch();
+    sendBinary(CMD_LINK_BAUD, &code, 1);
+    baud.requested(rate, millis());
+}
+
+void GUIInterface::handleLinkBaud(const uint8_t* payload, uint16_t len) {
+    if (!payload || len < 1) {
+        return;
+    }
+    const uint32_t rate = BinaryProtocol::baudRate(payload[0]);
+    if (baud.echoed(rate, millis())) {
+        // The GUI has switched; its pong at the new rate confirms it
+        Serial.print("GUIInterface: UART -> ");
+        Serial.print(rate);
+        Serial.println(" bps");
+        sendBinary(CMD_PING, nullptr, 0);
+        lastPingMs = millis();
+        finishBaudChange();
+        return;
+    }
+    if (!baud.awaitingEcho() && rate != 0 && rate < baud.current()) {
+        requestBaud(rate); // The GUI proposes a slower rate
+    }
+}
+
+// The rate change is over (echo or timeout). Frames dropped meanwhile were
+// change-tracked as sent by their callers, so the GUI gets the whole state.
+void GUIInterface::finishBaudChange() {
+    if (replayAfterBaud) {
+        replayAfterBaud = false;
+        liveController.replayStateToGUI();
+    }
+}
+
+LinkHealth GUIInterface::getHealth() const {
+    LinkHealth health;
+    health.framesSent = framesSent;
+    health.bytesSent = bytesSent;
+    health.txDropped = txDropped;
+    const FrameParserStats& rx = parser.getStats();
+    health.framesReceived = rx.frames;
+    health.bytesReceived = rx.bytes;
+    health.badFrames = rx.badFrames;
+    health.resyncs = rx.resyncs;
+    health.overflows = rx.overflows;
+    health.txBytesPerSec = meter.txBytesPerSec();
+    health.rxBytesPerSec = meter.rxBytesPerSec();
+    health.baud = baud.current();
+    return health;
+}
+
+// Reply to a CMD_STATS poll: both Teensy link ends, plus the M4's own end
+// once it has reported. The M4 is asked again for the next poll.
+void GUIInterface::sendStats() {
+    uint8_t payload[1 + 3 * LinkHealth::BLOCK_SIZE];
+    uint8_t length = 0;
+    payload[length++] = LinkHealth::STATS_VERSION;
+    length += uartHandler.getHealth().encode(LinkHealth::LINK_TEENSY_M4, &payload[length]);
+    length += getHealth().encode(LinkHealth::LINK_TEENSY_GUI, &payload[length]);
+    if (uartHandler.hasPeerHealth()) {
+        length += uartHandler.getPeerHealth().encode(LinkHealth::LINK_M4_TEENSY, &payload[length]);
+    }
+    sendBinary(CMD_STATS, payload, length);
+    uartHandler.requestPeerHealth();
+}
+
+// Reply to a CMD_PROFILE poll: the Live ingest profile, in as many frames
+// as the negotiated payload size needs
+void GUIInterface::sendProfile() {
+    const LiveCommandProfiler& profiler = liveController.getProfiler();
+    const uint16_t capacity = linkMode.maxPayload < BinaryProtocol::MAX_PAYLOAD_SIZE
+        ? linkMode.maxPayload : BinaryProtocol::MAX_PAYLOAD_SIZE;
+    const uint8_t frames = profiler.frameCount(capacity);
+    uint8_t payload[BinaryProtocol::MAX_PAYLOAD_SIZE];
+    for (uint8_t frame = 0; frame < frames; ++frame) {
+        const uint16_t length = profiler.encode(frame, frames, payload, capacity,
+                                                static_cast<uint16_t>(F_CPU_ACTUAL / 1000000UL));
+        sendBinary(CMD_PROFILE, payload, length);
+    }
+}
+
+void GUIInterface::dropLink() {
+    sendDisconnectEvent();
+    guiConnected = false;
+    handshakePending = false;
+    lastPongMs = 0;
+    linkMode = BinaryProtocol::LinkMode();
+    baud.reset();
+    replayAfterBaud = false; // The next handshake replays everything
+}
+
 void GUIInterface::sendDisconnectEvent() {
     if (!io || disconnectNotified || !everConnected) return;
     sendBinary(CMD_DISCONNECT, nullptr, 0);
@@ -363,93 +638,127 @@ void GUIInterface::sendDisconnectEvent() {
 
 void GUIInterface::processIncoming() {
     if (!io) return;
-    while (io->available()) {
-        uint8_t byte = static_cast<uint8_t>(io->read());
-        if (byte == BinaryProtocol::BINARY_SYNC_BYTE) {
-            rxIndex = 0;
-            expectedLength = 0;
-            rxBuffer[rxIndex++] = byte;
-            continue;
-        }
-
-        if (rxIndex == 0) {
-            continue;
-        }
-
-        if (rxIndex < sizeof(rxBuffer)) {
-            rxBuffer[rxIndex++] = byte;
-        } else {
-            rxIndex = 0;
-            expectedLength = 0;
-            continue;
-        }
+    parser.poll(*io, linkMode, [this](const FrameView& frame) { handleFrame(frame); });
+}
 
-        if (rxIndex >= 3 && expectedLength == 0) {
-            uint8_t payloadLen = rxBuffer[2];
-            expectedLength = BinaryProtocol::getMessageSize(payloadLen);
-            if (expectedLength > sizeof(rxBuffer)) {
-                rxIndex = 0;
-                expectedLength = 0;
-                continue;
-            }
+void GUIInterface::handleFrame(const FrameView& frame) {
+    // In COBS mode only a restarted GUI's handshake/disconnect arrive SYNC-framed
+    if (frame.framing == BinaryProtocol::Framing::SYNC &&
+        linkMode.framing == BinaryProtocol::Framing::COBS &&
+        !(frame.command == CMD_HANDSHAKE || (frame.command == CMD_DISCONNECT && frame.length == 0))) {
+        return;
+    }
+#ifdef DEBUG_GUI_VERBOSE
+    if (frame.command != CMD_PING) {
+        Serial.print("GUI RX ");
+        Serial.print(commandName(frame.command));
+        Serial.print(" (0x");
+        Serial.print(frame.command, HEX);
+        Serial.print(") len=");
+        Serial.print(frame.length);
+        Serial.print(" payload: ");
+        for (uint16_t i = 0; i < frame.length; ++i) {
+            if (i) Serial.print(' ');
+            Serial.print(frame.payload[i], HEX);
         }
+        Serial.println();
+    }
+#endif
+    handleIncomingCommand(frame.command, const_cast<uint8_t*>(frame.payload), frame.length);
+}
 
-        if (expectedLength != 0 && rxIndex >= expectedLength) {
-            uint8_t cmd = 0;
-            const uint8_t* payload = nullptr;
-            uint8_t payloadLen = 0;
-            bool valid = BinaryProtocol::parseMessage(rxBuffer, expectedLength, cmd, payload, payloadLen);
-            if (valid) {
-                #ifdef DEBUG_GUI_VERBOSE
-                if (cmd != CMD_PING) {
-                    Serial.print("GUI RX ");
-                    Serial.print(commandName(cmd));
-                    Serial.print(" (0x");
-                    Serial.print(cmd, HEX);
-                    Serial.print(") len=");
-                    Serial.print(payloadLen);
-                    Serial.print(" frame: ");
-                    for (uint16_t i = 0; i < expectedLength; ++i) {
-                        if (i) Serial.print(' ');
-                        Serial.print(rxBuffer[i], HEX);
-                    }
-                    Serial.println();
-                }
-                #endif
-                handleIncomingCommand(cmd, const_cast<uint8_t*>(payload), payloadLen);
-            }
-            rxIndex = 0;
-            expectedLength = 0;
-        }
+// Pick the link mode from the GUI's capability block. A GUI-initiated handshake
+// carrying a block gets the agreed caps back; GUIs without a block stay on SYNC.
+void GUIInterface::applyPeerCaps(uint8_t cmd, const uint8_t* payload, uint16_t len) {
+    BinaryProtocol::LinkCaps peerCaps;
+    if (len > BinaryProtocol::MAX_PAYLOAD_SIZE ||
+        !BinaryProtocol::findCaps(payload, static_cast<uint8_t>(len), peerCaps)) {
+        linkMode = BinaryProtocol::LinkMode();
+        return;
+    }
+    BinaryProtocol::LinkCaps local;
+    local.flags = GUI_LINK_CAPS;
+    local.maxBaud = baud.offered();
+    local.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    const BinaryProtocol::LinkCaps agreed = BinaryProtocol::agreeCaps(local, peerCaps);
+    linkMode = BinaryProtocol::LinkMode();
+    if (cmd == CMD_HANDSHAKE) {
+        uint8_t reply[BinaryProtocol::CAPS_BLOCK_SIZE];
+        uint8_t replyLen = BinaryProtocol::appendCaps(nullptr, 0, agreed, reply, sizeof(reply));
+        sendBinary(CMD_HANDSHAKE_REPLY, reply, replyLen);
     }
+    linkMode = BinaryProtocol::modeFromCaps(agreed);
 }
 
-void GUIInterface::handleIncomingCommand(uint8_t cmd, uint8_t* payload, uint8_t len) {
+void GUIInterface::handleIncomingCommand(uint8_t cmd, uint8_t* payload, uint16_t len) {
     switch (cmd) {
         case CMD_HANDSHAKE:
         case CMD_HANDSHAKE_REPLY:
+            applyPeerCaps(cmd, payload, len);
             guiConnected = true;
             handshakePending = false;
+            handshakeAttempts = 0;
             lastPongMs = millis();
             if (cmd == CMD_HANDSHAKE_REPLY) {
                 Serial.println("GUIInterface: Handshake ACK from GUI");
             }
             disconnectNotified = false;
             everConnected = true;
-            liveController.resendCachedNamesToGUI();
+            {
+                // Back to the base rate (the GUI does the same after the
+                // handshake). With an upgrade to come, the Live state goes
+                // out once the rate settles; otherwise now
+                const uint32_t upgradeBaud = baud.afterHandshake(linkMode.maxBaud);
+                if (upgradeBaud) {
+                    requestBaud(upgradeBaud);
+                }
+                if (baud.awaitingEcho()) {
+                    replayAfterBaud = true;
+                } else {
+                    liveController.replayStateToGUI();
+                }
+            }
             break;
         case CMD_PING:
             guiConnected = true;
             lastPongMs = millis();
+            baud.frameReceived();
+            break;
+        case CMD_LINK_BAUD:
+            handleLinkBaud(payload, len);
+            break;
+        case CMD_STATS:
+            sendStats();
+            break;
+        case CMD_PROFILE:
+            sendProfile();
             break;
         case CMD_DISCONNECT:
             guiConnected = false;
             handshakePending = false;
             lastPongMs = 0;
             disconnectNotified = true;
+            linkMode = BinaryProtocol::LinkMode();
+            baud.reset();
+            replayAfterBaud = false;
             break;
+        case CMD_BATCH: {
+            uint16_t offset = 0;
+            uint8_t entryCmd = 0;
+            const uint8_t* entry = nullptr;
+            uint8_t entryLen = 0;
+            while (BinaryProtocol::nextBatchEntry(payload, len, offset, entryCmd, entry, entryLen)) {
+                if (BinaryProtocol::isBatchable(entryCmd)) {
+                    handleIncomingCommand(entryCmd, const_cast<uint8_t*>(entry), entryLen);
+                }
+            }
+            break;
+        }
         default:
-            uiBridge.handleUARTCommand(cmd, payload, len);
+            if (len > BinaryProtocol::MAX_PAYLOAD_SIZE) {
+                break; // No GUI command needs an extended frame yet
+            }
+            uiBridge.handleUARTCommand(cmd, payload, static_cast<uint8_t>(len));
             break;
     }
 }
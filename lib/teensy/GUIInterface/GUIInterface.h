@@ -3,6 +3,9 @@
 #include <Arduino.h>
 #include "MidiCommands.h"
 #include "shared/BinaryProtocol.h"
+#include "shared/FrameParser.h"
+#include "shared/LinkBaud.h"
+#include "shared/LinkHealth.h"
 
 // Lightweight bridge that mirrors Ableton/NeoTrellis state to a USB Serial GUI.
 // The on-board firmware compiles even if no desktop GUI is connected; the class
@@ -10,6 +13,8 @@
 class GUIInterface {
 public:
     void begin(Stream& serialPort = Serial);
+    // Hardware UART: starts it at baseBaud and negotiates a faster rate with the GUI
+    void begin(HardwareSerial& serialPort, uint32_t baseBaud);
     void update();
 
     void sendGridColors7bit(const uint8_t* data, int length);
@@ -23,9 +28,15 @@ public:
                        uint8_t gMsb, uint8_t gLsb,
                        uint8_t bMsb, uint8_t bLsb);
     void sendClipName(uint8_t track, uint8_t scene, const char* name);
+    void sendClipName(uint8_t track, uint8_t scene, const char* name, size_t len);
     void sendTrackName(uint8_t track, const char* name);
+    void sendTrackName(uint8_t track, const char* name, size_t len);
     void sendTrackColor(uint8_t track, uint8_t r, uint8_t g, uint8_t b);
     void sendSceneName(uint8_t scene, const char* name);
+    void sendSceneName(uint8_t scene, const char* name, size_t len);
+    // Names by NamePool ID (CAP_NAME_IDS): the string once, then references
+    void sendNameDefine(uint16_t id, const char* name, size_t len);
+    void sendNameRef(uint8_t kind, uint8_t index, uint8_t scene, uint16_t id);
     void sendSceneColor(uint8_t scene, uint8_t r, uint8_t g, uint8_t b);
     void sendSceneState(uint8_t scene, uint8_t flags);
     void sendSceneTriggered(uint8_t scene, uint8_t flag);
@@ -44,16 +55,39 @@ public:
     void sendMixerMute(uint8_t track, uint8_t state);
     void sendMixerSolo(uint8_t track, uint8_t state);
     void sendMixerArm(uint8_t track, uint8_t state);
+    void sendMeters(const uint8_t* frame, uint8_t length); // LiveMeterStage frame
+    void sendPositions(const uint8_t* frame, uint8_t length); // ClipPositionEstimator frame
+
+    // Messages sent between beginBatch()/endBatch() are packed into CMD_BATCH
+    // frames when the GUI negotiated it. Pairs may nest.
+    void beginBatch();
+    void endBatch();
 
     bool isConnected() const { return guiConnected; }
+    const BinaryProtocol::LinkMode& getLinkMode() const { return linkMode; }
+    const FrameParserStats& getParserStats() const { return parser.getStats(); }
+    const LinkBaud& getBaud() const { return baud; }
+    LinkHealth getHealth() const;
 
 private:
     void sendTag(const char* tag);
     void printHexPreview(const uint8_t* data, int length, int maxBytes = 16);
     void processIncoming();
-    void handleIncomingCommand(uint8_t cmd, uint8_t* payload, uint8_t len);
-    void sendBinary(uint8_t cmd, const uint8_t* payload, uint8_t len);
+    void handleFrame(const FrameView& frame);
+    void applyPeerCaps(uint8_t cmd, const uint8_t* payload, uint16_t len);
+    void handleIncomingCommand(uint8_t cmd, uint8_t* payload, uint16_t len);
+    void sendBinary(uint8_t cmd, const uint8_t* payload, uint16_t len);
+    void sendSlices(uint8_t cmd, const BinaryProtocol::Slice* slices, uint8_t sliceCount);
+    void writeFrame(uint8_t cmd, const BinaryProtocol::Slice* slices, uint8_t sliceCount, uint16_t len);
+    void flushBatch();
+    void start();
     void sendHandshake();
+    void requestBaud(uint32_t rate);
+    void handleLinkBaud(const uint8_t* payload, uint16_t len);
+    void finishBaudChange();
+    void dropLink();
+    void sendStats();
+    void sendProfile();
     void sendDisconnectEvent();
 
     Stream* io = nullptr;
@@ -64,7 +98,14 @@ private:
     bool guiConnected = false;
     bool disconnectNotified = false;
     bool everConnected = false;
-    uint8_t rxBuffer[256];
-    uint16_t rxIndex = 0;
-    uint16_t expectedLength = 0;
+    uint8_t handshakeAttempts = 0;
+    FrameParser<BinaryProtocol::MAX_EXT_FRAME_SIZE> parser;
+    BinaryProtocol::LinkMode linkMode;
+    LinkBaud baud;
+    LinkRateMeter meter;
+    uint32_t framesSent = 0;
+    uint32_t bytesSent = 0;
+    uint32_t txDropped = 0;
+    bool replayAfterBaud = false;   // Frames were dropped while a rate change was pending
+    BinaryProtocol::Batch batch;
 };
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include "shared/Config.h"
+
+// Playing positions of the clips (one per track) and of the song, run
+// locally from the tempo instead of relaying Live's position stream to the
+// GUI. Live's positions (CMD_CLIP_PLAYING_POSITION, CMD_TRANSPORT_POSITION)
+// are anchors: one within LIVE_POSITION_TOLERANCE_TICKS of the estimate is
+// only counted, a farther one (a jump, a relaunch, drift) moves it. Clip
+// positions wrap at the length from CMD_CLIP_LENGTH once Live has sent it;
+// nothing advances while the transport is stopped.
+//
+// Positions are 14-bit, in 1/LIVE_POSITION_TICKS_PER_BEAT beat. tick() runs
+// at LIVE_POSITION_HZ and packs the song and the visible tracks whose
+// position moved into one frame: count × [slot, scene, hi, lo], slot being
+// the track or SONG_SLOT.
+class ClipPositionEstimator {
+public:
+    static constexpr uint8_t TRACKS = 32;  // Absolute track index, as in LiveStateModel
+    static constexpr uint8_t SONG_SLOT = 0x7F;
+    static constexpr uint8_t MAX_VISIBLE = GRID_TRACKS;
+    static constexpr uint8_t MAX_FRAME = (MAX_VISIBLE + 1) * 4;
+
+    struct Stats {
+        uint32_t anchors = 0;      // Positions received from Live
+        uint32_t corrections = 0;  // Anchors that moved a running estimate
+        uint32_t frames = 0;       // Frames built (sent when the GUI is connected)
+    };
+
+    // slot: track, or SONG_SLOT (scene ignored)
+    void anchor(uint8_t slot, uint8_t scene, uint16_t ticks, uint32_t nowMs) {
+        Channel* channel = find(slot);
+        if (!channel) {
+            return;
+        }
+        stats.anchors++;
+        ticks &= 0x3FFF;
+        if (channel->active && channel->scene == scene &&
+            distance(*channel, estimate(*channel, nowMs), ticks) <= LIVE_POSITION_TOLERANCE_TICKS) {
+            channel->heardAt = nowMs;
+            return;
+        }
+        if (channel->active) {
+            stats.corrections++;
+        }
+        if (channel->scene != scene) {
+            channel->length = 0; // Another clip; its length comes with it
+        }
+        channel->active = true;
+        channel->scene = scene;
+        channel->anchorTicks = ticks;
+        channel->anchorAt = nowMs;
+        channel->heardAt = nowMs;
+    }
+
+    // Lengths of clips other than the one playing on the track are not kept
+    void setLength(uint8_t track, uint8_t scene, uint16_t ticks) {
+        if (track >= TRACKS || (channels[track].active && channels[track].scene != scene)) {
+            return;
+        }
+        channels[track].scene = scene;
+        channels[track].length = ticks & 0x3FFF;
+    }
+
+    // A new tempo changes the speed from the current positions on
+    void setTempo(uint16_t tenthsBpm, uint32_t nowMs) {
+        reanchorAll(nowMs);
+        ticksPerMs = static_cast<float>(tenthsBpm) * LIVE_POSITION_TICKS_PER_BEAT / 600000.0f;
+    }
+
+    void setRunning(bool on, uint32_t nowMs) {
+        reanchorAll(nowMs);
+        running = on;
+    }
+
+    // Tracks the frame covers (the session ring's)
+    void setVisible(uint8_t firstTrack, uint8_t count) {
+        if (count > MAX_VISIBLE) {
+            count = MAX_VISIBLE;
+        }
+        if (firstTrack != visibleFirst || count != visibleCount) {
+            visibleFirst = firstTrack;
+            visibleCount = count;
+            resend();
+        }
+    }
+
+    // Returns the frame length when some visible position moved to another
+    // tick, 0 otherwise. Channels Live has not confirmed for
+    // LIVE_POSITION_TIMEOUT_MS (clip or song stopped) end here.
+    uint8_t tick(uint32_t nowMs, uint8_t* out) {
+        for (Channel& channel : channels) {
+            if (channel.active && nowMs - channel.heardAt >= LIVE_POSITION_TIMEOUT_MS) {
+                channel.active = false;
+            }
+        }
+        uint8_t length = 0;
+        pack(SONG_SLOT, nowMs, out, length);
+        for (uint8_t i = 0; i < visibleCount; ++i) {
+            pack(visibleFirst + i, nowMs, out, length);
+        }
+        if (length) {
+            stats.frames++;
+        }
+        return length;
+    }
+
+    // The GUI lost its copy (reconnect)
+    void resend() {
+        for (Channel& channel : channels) {
+            channel.sentTicks = NOT_SENT;
+        }
+    }
+
+    // Live went away
+    void reset() {
+        for (Channel& channel : channels) {
+            channel = Channel();
+        }
+        running = false;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    static constexpr uint16_t NOT_SENT = 0xFFFF;
+
+    struct Channel {
+        float anchorTicks = 0;
+        uint32_t anchorAt = 0;
+        uint32_t heardAt = 0;
+        uint16_t length = 0;       // 0: not known yet
+        uint16_t sentTicks = NOT_SENT;
+        uint8_t scene = 0;
+        bool active = false;
+    };
+
+    Channel* find(uint8_t slot) {
+        if (slot == SONG_SLOT) {
+            return &channels[TRACKS];
+        }
+        return slot < TRACKS ? &channels[slot] : nullptr;
+    }
+
+    float estimate(const Channel& channel, uint32_t nowMs) const {
+        float ticks = channel.anchorTicks;
+        if (running) {
+            ticks += static_cast<float>(nowMs - channel.anchorAt) * ticksPerMs;
+        }
+        return fmodf(ticks, period(channel));
+    }
+
+    // Ticks between two positions, the short way round a looping clip
+    static float distance(const Channel& channel, float a, float b) {
+        const float d = fabsf(a - b);
+        return d > period(channel) / 2.0f ? period(channel) - d : d;
+    }
+
+    // Unknown lengths and the song wrap where the 14-bit position does
+    static float period(const Channel& channel) {
+        return channel.length ? channel.length : 0x4000;
+    }
+
+    void reanchorAll(uint32_t nowMs) {
+        for (Channel& channel : channels) {
+            channel.anchorTicks = estimate(channel, nowMs);
+            channel.anchorAt = nowMs;
+        }
+    }
+
+    void pack(uint8_t slot, uint32_t nowMs, uint8_t* out, uint8_t& length) {
+        Channel* channel = find(slot);
+        if (!channel || !channel->active) {
+            return;
+        }
+        const uint16_t ticks = static_cast<uint16_t>(estimate(*channel, nowMs));
+        if (ticks == channel->sentTicks) {
+            return;
+        }
+        channel->sentTicks = ticks;
+        out[length++] = slot;
+        out[length++] = channel->scene & 0x7F;
+        out[length++] = static_cast<uint8_t>((ticks >> 7) & 0x7F);
+        out[length++] = static_cast<uint8_t>(ticks & 0x7F);
+    }
+
+    Stats stats;
+    Channel channels[TRACKS + 1]; // Last one: the song
+    float ticksPerMs = 0;
+    bool running = false;
+    uint8_t visibleFirst = 0;
+    uint8_t visibleCount = MAX_VISIBLE;
+};
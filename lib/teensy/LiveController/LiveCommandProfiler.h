@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+#include "LiveCommandTable.h"
+
+// Traffic and CPU profile of Live SysEx ingest, one fixed entry per command
+// ID: how many messages arrived, their payload bytes, the largest payload and
+// the cycles spent in the handler. Recording is a few adds, cheap enough to
+// stay on in normal builds.
+//
+// CMD_PROFILE carries the non-empty entries, split over as many frames as
+// needed:
+// [VERSION][CPU_MHZ u16][FRAME][FRAMES][N] + N × [CMD][COUNT u32][BYTES u32][MAX u16][CYCLES u64]
+// (all LSB first).
+class LiveCommandProfiler {
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t HEADER_SIZE = 6;
+    static constexpr uint8_t ENTRY_SIZE = 1 + 4 + 4 + 2 + 8;
+
+    struct Entry {
+        uint32_t count;
+        uint32_t payloadBytes;
+        uint64_t cycles;     // Inside the handler
+        uint16_t maxPayload;
+    };
+
+    // Same ID space as the dispatch table (bulk IDs use the top bit)
+    static constexpr uint16_t ENTRIES = LiveCommand::COUNT;
+
+    void record(uint8_t command, uint16_t payloadLength, uint32_t cycles) {
+        Entry& entry = entries[command];
+        entry.count++;
+        entry.payloadBytes += payloadLength;
+        entry.cycles += cycles;
+        if (payloadLength > entry.maxPayload) {
+            entry.maxPayload = payloadLength;
+        }
+    }
+
+    const Entry& operator[](uint8_t command) const { return entries[command]; }
+
+    uint16_t activeCount() const {
+        uint16_t active = 0;
+        for (uint16_t i = 0; i < ENTRIES; ++i) {
+            active += entries[i].count ? 1 : 0;
+        }
+        return active;
+    }
+
+    void reset() { memset(entries, 0, sizeof(entries)); }
+
+    // Frames needed to export every non-empty entry with payloads of at most capacity bytes
+    uint8_t frameCount(uint16_t capacity) const {
+        const uint16_t perFrame = entriesPerFrame(capacity);
+        const uint16_t active = activeCount();
+        return static_cast<uint8_t>(active == 0 ? 1 : (active + perFrame - 1) / perFrame);
+    }
+
+    // Writes frame number `frame` of `frames`; returns its length.
+    uint16_t encode(uint8_t frame, uint8_t frames, uint8_t* out, uint16_t capacity, uint16_t cpuMhz) const {
+        const uint16_t perFrame = entriesPerFrame(capacity);
+        const uint16_t skip = static_cast<uint16_t>(frame * perFrame);
+        uint16_t length = HEADER_SIZE;
+        uint8_t written = 0;
+        uint16_t seen = 0;
+        for (uint16_t id = 0; id < ENTRIES && written < perFrame; ++id) {
+            const Entry& entry = entries[id];
+            if (!entry.count || seen++ < skip) {
+                continue;
+            }
+            out[length++] = static_cast<uint8_t>(id);
+            length += put(&out[length], entry.count, 4);
+            length += put(&out[length], entry.payloadBytes, 4);
+            length += put(&out[length], entry.maxPayload, 2);
+            length += put(&out[length], entry.cycles, 8);
+            written++;
+        }
+        out[0] = VERSION;
+        put(&out[1], cpuMhz, 2);
+        out[3] = frame;
+        out[4] = frames;
+        out[5] = written;
+        return length;
+    }
+
+private:
+    static uint16_t entriesPerFrame(uint16_t capacity) {
+        return capacity > HEADER_SIZE + ENTRY_SIZE ? (capacity - HEADER_SIZE) / ENTRY_SIZE : 1;
+    }
+
+    static uint8_t put(uint8_t* out, uint64_t value, uint8_t bytes) {
+        for (uint8_t b = 0; b < bytes; ++b) {
+            out[b] = static_cast<uint8_t>(value >> (8 * b));
+        }
+        return bytes;
+    }
+
+    Entry entries[ENTRIES] = {};
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Shared types for LiveCommandTable.
+struct LiveCommand {
+    static constexpr uint16_t COUNT = 256;         // Bulk IDs (0x9A-0x9C) use the top bit
+    static constexpr uint16_t ANY_LENGTH = 0x3FFF; // Largest 14-bit SysEx length field
+
+    enum Flags : uint8_t {
+        LOG_RECEIPT = 0x01, // Log every arrival (bulk commands)
+        KNOWN = 0x80        // Set on every entry, including ignored commands
+    };
+
+    enum class Result : uint8_t {
+        HANDLED,
+        IGNORED,    // Known command with no handler
+        BAD_LENGTH, // Payload outside the entry's [minLength, maxLength]
+        UNKNOWN     // No entry for this command ID
+    };
+
+    struct Stats {
+        uint32_t handled = 0;
+        uint32_t ignored = 0;
+        uint32_t badLength = 0;
+        uint32_t unknown = 0;
+
+        void count(Result result) {
+            switch (result) {
+                case Result::HANDLED: handled++; break;
+                case Result::IGNORED: ignored++; break;
+                case Result::BAD_LENGTH: badLength++; break;
+                case Result::UNKNOWN: unknown++; break;
+            }
+        }
+    };
+};
+
+// Compile-time dispatch table for Live SysEx commands, indexed by command ID.
+// Each entry holds the handler, the payload lengths it accepts and flags;
+// dispatch() validates the length once and calls the handler directly,
+// so handlers never re-check their minimum. Build one in a constexpr function
+// with on()/ignore() so the table is fixed at compile time.
+template <typename Target>
+class LiveCommandTable {
+public:
+    using Handler = void (Target::*)(uint8_t command, const uint8_t* payload, uint16_t length);
+
+    struct Entry {
+        Handler handler;
+        uint16_t minLength;
+        uint16_t maxLength;
+        uint8_t flags;
+    };
+
+    constexpr LiveCommandTable() : entries{} {}
+
+    constexpr void on(uint8_t command, Handler handler, uint16_t minLength,
+                      uint16_t maxLength = LiveCommand::ANY_LENGTH, uint8_t flags = 0) {
+        if (entries[command].flags & LiveCommand::KNOWN) {
+            duplicateCommand(); // Not constexpr: two entries for one ID fail the build
+        }
+        entries[command] = {handler, minLength, maxLength,
+                            static_cast<uint8_t>(flags | LiveCommand::KNOWN)};
+    }
+
+    // Known and deliberately dropped: informational or high-rate commands.
+    constexpr void ignore(uint8_t command) {
+        on(command, nullptr, 0);
+    }
+
+    constexpr const Entry& operator[](uint8_t command) const {
+        return entries[command];
+    }
+
+    LiveCommand::Result dispatch(Target& target, uint8_t command,
+                                 const uint8_t* payload, uint16_t length) const {
+        const Entry& entry = entries[command];
+        if (!(entry.flags & LiveCommand::KNOWN)) {
+            return LiveCommand::Result::UNKNOWN;
+        }
+        if (length < entry.minLength || length > entry.maxLength) {
+            return LiveCommand::Result::BAD_LENGTH;
+        }
+        if (!entry.handler) {
+            return LiveCommand::Result::IGNORED;
+        }
+        (target.*entry.handler)(command, payload, length);
+        return LiveCommand::Result::HANDLED;
+    }
+
+private:
+    static void duplicateCommand() {}
+
+    Entry entries[LiveCommand::COUNT];
+};
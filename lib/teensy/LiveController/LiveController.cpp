@@ -1,4 +1,5 @@
 #include "LiveController/LiveController.h"
+#include "LiveController/RingMetadataReader.h"
 #include "MidiCommands.h"
 #include "shared/Config.h"
 #include "LiveControllerStates.h"
@@ -9,7 +10,26 @@
 #include <cstring>
 #include <usb_midi.h>
 
+// Per-message logging: Serial.printf on every command stalls the loop while
+// Live floods a freshly loaded set, so it is compiled in only on request.
+#ifdef DEBUG_LIVE_LOG
+#define LIVE_LOG(...) Serial.printf(__VA_ARGS__)
+#else
+#define LIVE_LOG(...) do {} while (0)
+#endif
+
 namespace {
+// Two 7-bit bytes, MSB first
+uint16_t decode14(const uint8_t* data) {
+    return static_cast<uint16_t>(((data[0] & 0x7F) << 7) | (data[1] & 0x7F));
+}
+
+// 7-bit color to 8-bit, as the M4 expands it
+uint8_t expand7(uint8_t c) {
+    c &= 0x7F;
+    return static_cast<uint8_t>((c << 1) | (c >> 6));
+}
+
 bool parseLiveSysExFrame(const uint8_t* data,
                          uint16_t length,
                          uint8_t& command,
@@ -43,12 +63,21 @@ bool parseLiveSysExFrame(const uint8_t* data,
 }
 }
 
+// Reassembly buffer for USB SysEx: one Live frame at the 14-bit LEN limit
+DMAMEM static uint8_t sysexPool[LiveSysExAssembler::MAX_FRAME];
+
 // Constructor
-LiveController::LiveController() {
-    memset(trackNameCache, 0, sizeof(trackNameCache));
-    memset(trackNameValid, 0, sizeof(trackNameValid));
-    memset(clipNameCache, 0, sizeof(clipNameCache));
-    memset(clipNameValid, 0, sizeof(clipNameValid));
+LiveController::LiveController() : sysexAssembler(sysexPool, sizeof(sysexPool)) {
+    memset(nameId, 0xFF, sizeof(nameId)); // NamePool::NONE
+    memset(nameSentId, 0xFF, sizeof(nameSentId));
+
+    // Fields forwarded by the timed flushes rather than by their handlers
+    typedef LiveStateModel M;
+    const uint32_t clips = M::fieldBit(M::CLIP_STATE) | M::fieldBit(M::CLIP_COLOR);
+    state.subscribe(M::LEDS, clips);
+    state.subscribe(M::GUI, clips | M::fieldBit(M::TRACK_VOLUME) | M::fieldBit(M::TRACK_PAN) |
+                            M::fieldBit(M::TRACK_SEND_A) | M::fieldBit(M::TRACK_SEND_B) |
+                            M::fieldBit(M::TRACK_SEND_C) | M::fieldBit(M::TRACK_SEND_D));
 }
 
 // Destructor - nothing to free (global lifetime on MCU)
@@ -68,10 +97,49 @@ void LiveController::begin() {
     // The actual hardware (M4) is initialized via UART.
     // The I2C-based NeoTrellis initialization has been removed
     // to match the UART-based architecture.
+    // SysEx arrives through the handler in pieces, so Live frames are not
+    // limited to the USB stack's SysEx buffer
+    usbMIDI.setHandleSystemExclusive(handleUsbSysEx);
     Serial.println("LiveController class initialized (UART mode).");
 }
 
+void LiveController::handleUsbSysEx(const uint8_t* data, uint16_t length, bool last) {
+    liveController.feedSysEx(data, length, last);
+}
+
 void LiveController::read() {
+    // Ring presses merged over the window go to Live as one position
+    if (ringNav.takeDue(millis())) {
+        sendRingPosition();
+    }
+    if (ringNav.takeTimeout(millis())) {
+        // The grid may show a move Live never made: ask for the real one
+        previewCheck = false;
+        requestResync(LiveSequenceTracker::AREA_GRID);
+    }
+    if (pendingResync) {
+        flushResync(millis());
+    }
+
+    // Merged Live updates go out at each link's own rate
+    const uint32_t nowUs = micros();
+    if (nowUs - lastLedFlushUs >= 1000000UL / LIVE_LED_FLUSH_HZ) {
+        lastLedFlushUs = nowUs;
+        flushLeds();
+    }
+    if (nowUs - lastGuiFlushUs >= 1000000UL / LIVE_GUI_FLUSH_HZ) {
+        lastGuiFlushUs = nowUs;
+        flushGui();
+    }
+    if (nowUs - lastMeterFrameUs >= 1000000UL / LIVE_METER_HZ) {
+        lastMeterFrameUs = nowUs;
+        flushMeters();
+    }
+    if (nowUs - lastPositionFrameUs >= 1000000UL / LIVE_POSITION_HZ) {
+        lastPositionFrameUs = nowUs;
+        flushPositions();
+    }
+
     // Watchdog: if Live connected but no grid yet, request it after a timeout
     if (liveConnected && !gridSeen) {
         unsigned long now = millis();
@@ -85,696 +153,856 @@ void LiveController::read() {
 }
 
 void LiveController::processMIDI() {
-    // Limit MIDI processing to avoid blocking UART
-    const int MAX_MIDI_PER_LOOP = 5;
-    int processedCount = 0;
-
-    while (usbMIDI.read() && processedCount < MAX_MIDI_PER_LOOP) {
-        if (usbMIDI.getType() != usbMIDI.SystemExclusive) {
-            continue;
+    // Drain USB MIDI for up to the loop's time budget. The budget is checked
+    // before each read, so a message is never read and then left unhandled,
+    // and the first message always goes through.
+    const uint32_t cyclesPerUs = F_CPU_ACTUAL / 1000000UL;
+    const uint32_t budgetCycles = midiDrainBudgetUs() * cyclesPerUs;
+    const uint32_t start = ARM_DWT_CYCCNT;
+    uint16_t messages = 0;
+
+    while (true) {
+        if (messages > 0 && ARM_DWT_CYCCNT - start >= budgetCycles) {
+            drainStats.budgetExhausted++;
+            break;
         }
-        processedCount++;
-
-        uint8_t* sysexData = usbMIDI.getSysExArray();
-        uint16_t length = usbMIDI.getSysExArrayLength();
-        if (!sysexData || length == 0) {
-            continue;
+        // SysEx pieces go to handleUsbSysEx() from inside read()
+        if (!usbMIDI.read()) {
+            break;
         }
+        messages++;
+    }
 
-        #ifdef DEBUG_LIVE_LOG
-        Serial.print("Live command (");
-        Serial.print(length);
-        Serial.print(" bytes): ");
-        for (int i = 0; i < min(length, 10); i++) {
-            Serial.print(sysexData[i], HEX);
-            Serial.print(" ");
-        }
-        if (length > 10) Serial.print("...");
-        Serial.println();
-        #endif
-
-        bool isLiveFrame = (length >= 10 &&
-                            sysexData[0] == SYSEX_START &&
-                            sysexData[1] == MANUFACTURER_ID &&
-                            sysexData[2] == DEVICE_ID &&
-                            sysexData[3] == 0x7F);
-        if (!isLiveFrame) {
-            processSysEx(sysexData, length);
-            if (neoTrellisLink.isConnected()) {
-                neoTrellisLink.sendRaw(sysexData, length);
-            }
-            continue;
-        }
+    if (messages == 0) {
+        return;
+    }
+    const uint32_t elapsedUs = (ARM_DWT_CYCCNT - start) / cyclesPerUs;
+    drainStats.drains++;
+    drainStats.messages += messages;
+    if (messages > drainStats.maxMessages) {
+        drainStats.maxMessages = messages;
+    }
+    if (elapsedUs > drainStats.maxDrainUs) {
+        drainStats.maxDrainUs = elapsedUs;
+    }
+}
 
+// Full budget while the links are quiet. Pad events from the M4 waiting to
+// be read, or frames piling up for the M4, shrink it so loop() gets back to
+// them sooner; Live's backlog waits in USB until the next loop.
+uint32_t LiveController::midiDrainBudgetUs() {
+    const uint32_t backlog = neoTrellisLink.getTxQueue().pendingBytes();
+    if (backlog > drainStats.maxTxBacklog) {
+        drainStats.maxTxBacklog = backlog;
+    }
+    const bool padEventsPending = Serial1.available() > 0;
+    if (backlog == 0 && !padEventsPending) {
+        return MIDI_DRAIN_BUDGET_US;
+    }
+    drainStats.throttled++;
+    if (padEventsPending || backlog >= MIDI_DRAIN_TX_BACKLOG_BYTES) {
+        return MIDI_DRAIN_MIN_BUDGET_US;
+    }
+    return MIDI_DRAIN_BUDGET_US -
+           (MIDI_DRAIN_BUDGET_US - MIDI_DRAIN_MIN_BUDGET_US) * backlog / MIDI_DRAIN_TX_BACKLOG_BYTES;
+}
+
+void LiveController::feedSysEx(const uint8_t* data, uint16_t length, bool last) {
+    const uint8_t rejected = sysexAssembler.feed(data, length, last, [this]() {
+        handleAssembledSysEx();
+    });
+    if (rejected > 0) {
+        Serial.printf("Teensy: Ignoring malformed SysEx (%s, expected format F0 7F 00 7F CMD SEQ LEN... F7)\n",
+                      LiveSysExAssembler::reasonName(sysexAssembler.lastRejectReason()));
+        // A Live frame cut short still names what it carried
         uint8_t command = 0;
-        uint8_t sequence = 0;
-        uint16_t payloadLen = 0;
-        const uint8_t* payload = nullptr;
-        if (!parseLiveSysExFrame(sysexData, length, command, sequence, payloadLen, payload)) {
-            Serial.printf("Teensy: Ignoring malformed Live SysEx frame (length=%u bytes, expected format F0 7F 00 7F CMD SEQ LEN... F7)\n", length);
-            Serial.print("  First 16 bytes: ");
-            for (int i = 0; i < min(length, 16); i++) {
-                Serial.printf("%02X ", sysexData[i]);
+        if (liveConnected && sysexAssembler.lastRejectCommand(command)) {
+            resyncStats.rejectedFrames++;
+            const uint8_t areas = LiveSequenceTracker::areaOf(command);
+            if (areas) {
+                requestResync(areas);
             }
-            Serial.println();
-            continue;
         }
+    }
+}
 
-        #ifdef DEBUG_LIVE_LOG
-        Serial.print("Live SysEx CMD:0x");
-        Serial.print(command, HEX);
-        Serial.print(" PAYLOAD:");
-        Serial.println(payloadLen);
-        #endif
-
-        // Always log bulk commands for debugging
-        if (command == CMD_SESSION_RING_METADATA || command == CMD_SESSION_RING_CLIPS) {
-            Serial.printf("Teensy: Received Live CMD 0x%02X (payload %u bytes)\n", command, payloadLen);
-        }
-
-        switch (command) {
-            case CMD_GRID_UPDATE: {
-                if (payloadLen == 96) {
-                    neoTrellisLink.sendCommand(CMD_LED_GRID_UPDATE, payload, static_cast<int>(payloadLen));
-                    guiInterface.sendGridColors7bit(payload, static_cast<int>(payloadLen));
-                    Serial.println("Teensy: Forwarded grid bulk (96 bytes, 7-bit RGB) to M4 + GUI");
-                } else if (payloadLen == 192) {
-                    neoTrellisLink.sendCommand(CMD_LED_GRID_UPDATE_14, payload, static_cast<int>(payloadLen));
-                    guiInterface.sendGridColors14bit(payload, static_cast<int>(payloadLen));
-                    Serial.println("Teensy: Forwarded grid bulk (192 bytes, 14-bit RGB) to M4 + GUI");
-                } else {
-                    Serial.print("Live Grid: payload length invalid (expected 96 or 192, got ");
-                    Serial.print(payloadLen);
-                    Serial.println(")");
-                    break;
-                }
+void LiveController::handleAssembledSysEx() {
+    const uint8_t* sysexData = sysexAssembler.message();
+    const uint16_t length = sysexAssembler.length();
 
-                if (!gridSeen) {
-                    gridSeen = true;
-                    Serial.println("Teensy: First grid seen — enabling key scanning on M4");
-                    neoTrellisLink.sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
-                }
-                
-                // After a bulk update, resend names to ensure GUI is in sync
-                broadcastCachedNamesToGUI();
-                break;
-            }
+    #ifdef DEBUG_LIVE_LOG
+    Serial.print("Live command (");
+    Serial.print(length);
+    Serial.print(" bytes): ");
+    for (int i = 0; i < min(length, 10); i++) {
+        Serial.print(sysexData[i], HEX);
+        Serial.print(" ");
+    }
+    if (length > 10) Serial.print("...");
+    Serial.println();
+    #endif
 
+    if (!liveConnected) {
+        // Only Live's handshake matters until it has been answered
+        if (sysexAssembler.isLiveFrame()) {
+            processHandshakeMessage(sysexData, length);
+        }
+        return;
+    }
+    if (!sysexAssembler.isLiveFrame()) {
+        processSysEx(sysexData, length);
+        if (neoTrellisLink.isConnected()) {
+            neoTrellisLink.sendRaw(sysexData, length);
+        }
+        return;
+    }
+    const uint8_t lostAreas = sequenceTracker.received(sysexAssembler.command(), sysexAssembler.sequence());
+    if (lostAreas) {
+        const LiveSequenceTracker::Stats& seq = sequenceTracker.getStats();
+        LIVE_LOG("Live: SEQ gap before 0x%02X (%lu frames lost so far), resync 0x%02X\n",
+                 sysexAssembler.command(), static_cast<unsigned long>(seq.missing), lostAreas);
+        requestResync(lostAreas);
+    }
+    dispatchLiveCommand(sysexAssembler.command(), sysexAssembler.payload(), sysexAssembler.payloadLength());
+}
 
+void LiveController::requestResync(uint8_t areas) {
+    if (areas & LiveSequenceTracker::AREA_NAMES) {
+        // Whatever Live resends goes to the GUI, even if unchanged
+        memset(nameSentId, 0xFF, sizeof(nameSentId));
+    }
+    pendingResync |= areas & LiveSequenceTracker::AREA_ALL;
+    lastLossAt = millis();
+}
 
-            case CMD_RING_POSITION: {
-                if (payloadLen >= 7) {
-                    uint16_t track = static_cast<uint16_t>(((payload[0] & 0x7F) << 7) | (payload[1] & 0x7F));
-                    uint16_t scene = static_cast<uint16_t>(((payload[2] & 0x7F) << 7) | (payload[3] & 0x7F));
-                    uint8_t width = payload[4] & 0x7F;
-                    uint8_t height = payload[5] & 0x7F;
-                    uint8_t overview = payload[6] & 0x7F;
-                    Serial.printf("Ring position -> track %u scene %u w=%u h=%u ov=%u\n",
-                                  track, scene, width, height, overview);
-                } else {
-                    Serial.println("Ring position payload too short");
-                }
-                uiBridge.processLiveSysEx(CMD_RING_POSITION, payload, static_cast<uint8_t>(payloadLen));
-                break;
-            }
+// One request per burst of losses: wait until frames arrive cleanly for
+// the hold-off, and keep requests apart so a resend that is itself lossy
+// does not snowball.
+void LiveController::flushResync(unsigned long now) {
+    if (!liveConnected) {
+        pendingResync = 0;
+        return;
+    }
+    if (now - lastLossAt < LIVE_RESYNC_HOLDOFF_MS ||
+        (resyncStats.requests > 0 && now - lastResyncAt < LIVE_RESYNC_MIN_INTERVAL_MS)) {
+        return;
+    }
+    const uint8_t areas = pendingResync;
+    pendingResync = 0;
+    lastResyncAt = now;
+    resyncStats.requests++;
+    resyncStats.lastAreas = areas;
+    sendSysExToAbleton(CMD_RESYNC_REQUEST, &areas, 1);
+    Serial.printf("Live: lost frames — resync requested (areas 0x%02X)\n", areas);
+}
 
-            case CMD_TRACK_SELECT: {
-                if (payloadLen >= 1) {
-                    uint8_t idx = payload[0] & 0x7F;
-                    Serial.printf("Live: Track select echo -> %u\n", idx);
-                } else {
-                    Serial.println("Live: Track select payload too short");
-                }
-                break;
-            }
+void LiveController::dispatchLiveCommand(uint8_t command, const uint8_t* payload, uint16_t payloadLen) {
+    #ifdef DEBUG_LIVE_LOG
+    Serial.print("Live SysEx CMD:0x");
+    Serial.print(command, HEX);
+    Serial.print(" PAYLOAD:");
+    Serial.println(payloadLen);
+    #endif
 
-            case CMD_SCENE_SELECT: {
-                if (payloadLen >= 1) {
-                    uint8_t idx = payload[0] & 0x7F;
-                    Serial.printf("Live: Scene select echo -> %u\n", idx);
-                } else {
-                    Serial.println("Live: Scene select payload too short");
-                }
-                break;
-            }
+    const CommandTable::Entry& entry = commandTable[command];
+    if (entry.flags & LiveCommand::LOG_RECEIPT) {
+        Serial.printf("Teensy: Received Live CMD 0x%02X (payload %u bytes)\n", command, payloadLen);
+    }
 
-            case CMD_DETAIL_CLIP: {
-                if (payloadLen >= 2) {
-                    uint8_t track = payload[0] & 0x7F;
-                    uint8_t scene = payload[1] & 0x7F;
-                    Serial.printf("Live: Detail clip focus -> track %u scene %u\n", track, scene);
-                } else {
-                    Serial.println("Live: Detail clip payload too short");
-                }
-                break;
-            }
+    const uint32_t start = ARM_DWT_CYCCNT;
+    const LiveCommand::Result result = commandTable.dispatch(*this, command, payload, payloadLen);
+    profiler.record(command, payloadLen, ARM_DWT_CYCCNT - start);
+    dispatchStats.count(result);
+    if (result == LiveCommand::Result::BAD_LENGTH) {
+        Serial.printf("Live: CMD 0x%02X payload %u bytes, expected %u-%u\n",
+                      command, payloadLen, entry.minLength, entry.maxLength);
+    } else if (result == LiveCommand::Result::UNKNOWN) {
+        // Custom vendor messages (F0 7D ...) still go through processSysEx
+        Serial.print("Unhandled Live CMD:0x");
+        Serial.println(command, HEX);
+    }
+}
 
-            case CMD_HANDSHAKE_REPLY: {
-                Serial.println("Live: Handshake final (0x01) received.");
-                break;
-            }
+// One entry per Live command: handler, accepted payload length, logging.
+// Lengths checked here are not re-checked by the handlers.
+constexpr LiveController::CommandTable LiveController::buildCommandTable() {
+    using LC = LiveController;
+    constexpr uint16_t ANY = LiveCommand::ANY_LENGTH;
+    constexpr uint8_t LOG = LiveCommand::LOG_RECEIPT;
+
+    CommandTable table;
+    table.on(CMD_HANDSHAKE, &LC::onHandshake, 0);
+    table.on(CMD_HANDSHAKE_REPLY, &LC::onHandshakeReply, 0);
+    table.on(CMD_DISCONNECT, &LC::onDisconnect, 0);
+
+    // Session grid
+    table.on(CMD_GRID_UPDATE, &LC::onGridUpdate, 96, 192);
+    table.on(CMD_GRID_SINGLE_PAD, &LC::onGridSinglePad, 7);
+    table.on(CMD_CLIP_STATE, &LC::onClipState, 9);
+    table.on(CMD_CLIP_NAME, &LC::onClipName, 3);
+    table.on(CMD_SESSION_RING_METADATA, &LC::onRingMetadata, 1, ANY, LOG);
+    table.on(CMD_SESSION_RING_CLIPS, &LC::onRingClips, 32 * 4, ANY, LOG);
+    table.on(CMD_RING_POSITION, &LC::onRingPosition, 7);
+    table.on(CMD_CLIP_WINDOW, &LC::onClipWindow, 6);
+
+    // Scenes
+    table.on(CMD_SCENE_NAME, &LC::onSceneName, 2);
+    table.on(CMD_SCENE_COLOR, &LC::onSceneColor, 4);
+    table.on(CMD_SCENE_STATE, &LC::onSceneState, 2);
+    table.on(CMD_SCENE_IS_TRIGGERED, &LC::onSceneTriggered, 2);
+
+    // Tracks and mixer
+    table.on(CMD_TRACK_NAME, &LC::onTrackName, 2);
+    table.on(CMD_TRACK_COLOR, &LC::onTrackColor, 4);
+    table.on(CMD_TRACK_VOLUME, &LC::onMixerLevel, 3);
+    table.on(CMD_TRACK_PAN, &LC::onMixerLevel, 3);
+    table.on(CMD_TRACK_SEND_A, &LC::onMixerSend, 4);
+    table.on(CMD_TRACK_MUTE, &LC::onMixerToggle, 2);
+    table.on(CMD_TRACK_SOLO, &LC::onMixerToggle, 2);
+    table.on(CMD_TRACK_ARM, &LC::onMixerToggle, 2);
+    table.on(CMD_TRACK_METER, &LC::onTrackMeter, 2, 3);
+
+    // Selection and focus
+    table.on(CMD_SELECTED_TRACK, &LC::onSelectedTrack, 0);
+    table.on(CMD_TRACK_SELECT, &LC::onTrackSelect, 1);
+    table.on(CMD_SCENE_SELECT, &LC::onSceneSelect, 1);
+    table.on(CMD_DETAIL_CLIP, &LC::onDetailClip, 2);
+
+    // Transport
+    table.on(CMD_TEMPO, &LC::onTempo, 2);
+    table.on(CMD_TRANSPORT_PLAY, &LC::onTransport, 0);
+    table.on(CMD_TRANSPORT_RECORD, &LC::onTransport, 0);
+    table.on(CMD_TRANSPORT_POSITION, &LC::onSongPosition, 2);
+    table.on(CMD_CLIP_PLAYING_POSITION, &LC::onClipPosition, 4);
+    table.on(CMD_CLIP_LENGTH, &LC::onClipLength, 4);
+
+    // Echoes of hardware actions, informational or high-rate: dropped
+    table.ignore(CMD_CLIP_TRIGGER);
+    table.ignore(CMD_CLIP_STOP);
+    table.ignore(CMD_SCENE_FIRE);
+    table.ignore(CMD_TRACK_PLAYING_SLOT);
+    table.ignore(CMD_TRACK_FIRED_SLOT);
+    table.ignore(CMD_TRACK_CROSSFADE);
+    table.ignore(CMD_SELECTED_SCENE);
+    table.ignore(CMD_TRANSPORT_LOOP);
+    table.ignore(CMD_TRANSPORT_METRONOME);
+    table.ignore(CMD_TRANSPORT_SIGNATURE);
+    table.ignore(CMD_TRANSPORT_OVERDUB); // Also known as CMD_ARRANGEMENT_RECORD
+    table.ignore(CMD_TRANSPORT_PUNCH);
+    table.ignore(CMD_RECORD_QUANTIZATION);
+    table.ignore(CMD_QUANTIZE_CLIP);
+    table.ignore(CMD_BACK_TO_ARRANGER);
+    table.ignore(CMD_RE_ENABLE_AUTOMATION);
+    table.ignore(CMD_TRANSPORT_QUANTIZE);
+    table.ignore(CMD_TRANSPORT);
+    table.ignore(CMD_STEP_SEQUENCER_STATE);
+    table.ignore(CMD_DEVICE_LIST);
+    table.ignore(CMD_DEVICE_ENABLE);
+    table.ignore(CMD_PARAM_VALUE);
+    table.ignore(CMD_CHAIN_SELECT);
+    table.ignore(CMD_DRUM_PAD_STATE);
+    table.ignore(CMD_LOOP_MARKERS);
+    table.ignore(CMD_CLIP_LOOP);
+    table.ignore(CMD_CLIP_MUTED);
+    return table;
+}
 
-            case CMD_GRID_SINGLE_PAD: {
-                if (payloadLen < 7) {
-                    Serial.println("Live: CMD_GRID_SINGLE_PAD payload too short");
-                    break;
-                }
-                uint8_t padIndex = payload[0] & 0x7F;
-                
-                // Decode 14-bit color
-                // auto decodeColor = [&](uint16_t offset) -> uint8_t {
-                //     return (uint8_t)(((payload[offset] & 0x7F) << 7) | (payload[offset + 1] & 0x7F));
-                // };
-                // uint8_t r = decodeColor(1);
-                // uint8_t g = decodeColor(3);
-                // uint8_t b = decodeColor(5);
-
-                if (padIndex < TOTAL_KEYS) {
-                    // Serial.printf("GRID_SINGLE_PAD pad %02d RGB=%u,%u,%u\n", padIndex, r, g, b);
-                    
-                    // Forward to NeoTrellis
-                    uint8_t m4Data[] = {
-                        padIndex,
-                        payload[1], payload[2],
-                        payload[3], payload[4],
-                        payload[5], payload[6]
-                    };
-                    neoTrellisLink.sendCommand(CMD_LED_PAD_UPDATE_14, m4Data, sizeof(m4Data));
-                    
-                    // Forward to GUI
-                    guiInterface.sendPadColor14bit(padIndex, payload[1], payload[2], payload[3], payload[4], payload[5], payload[6]);
-                }
-                break;
-            }
+constexpr LiveController::CommandTable LiveController::commandTable = LiveController::buildCommandTable();
 
-            case CMD_CLIP_STATE: {
-                if (payloadLen < 9) {
-                    Serial.println("Live: CMD_CLIP_STATE payload too short");
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                uint8_t scene = payload[1] & 0x7F;
-                uint8_t state = payload[2] & 0x7F;
-                auto decodeColor = [&](uint16_t offset) -> uint8_t {
-                    return (uint8_t)(((payload[offset] & 0x7F) << 7) | (payload[offset + 1] & 0x7F));
-                };
-                uint8_t r = decodeColor(3);
-                uint8_t g = decodeColor(5);
-                uint8_t b = decodeColor(7);
-                int padIndex = scene * GRID_TRACKS + track;
-                if (padIndex < TOTAL_KEYS) {
-                    Serial.printf("CLIP_STATE pad %02d (T%d,S%d) state=%u RGB=%u,%u,%u\n",
-                                  padIndex, track, scene, state, r, g, b);
-                    uint8_t m4Data[] = {
-                        static_cast<uint8_t>(padIndex),
-                        payload[3], payload[4],
-                        payload[5], payload[6],
-                        payload[7], payload[8]
-                    };
-                    neoTrellisLink.sendCommand(CMD_LED_PAD_UPDATE_14, m4Data, sizeof(m4Data));
-                    // Forward full clip state to GUI (includes state + color)
-                    guiInterface.sendClipState(track, scene, state, payload[3], payload[4], payload[5], payload[6], payload[7], payload[8]);
-                    uint8_t statePayload[] = { static_cast<uint8_t>(padIndex), state };
-                    neoTrellisLink.sendCommand(CMD_LED_CLIP_STATE, statePayload, sizeof(statePayload));
-                }
-                break;
-            }
+void LiveController::onHandshake(uint8_t, const uint8_t*, uint16_t) {
+    Serial.println("Live: secondary handshake ping received");
+}
 
-            case CMD_CLIP_NAME: {
-                if (payloadLen < 3) {
-                    Serial.println("Live: Clip name payload too short");
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                uint8_t scene = payload[1] & 0x7F;
-                // Payload format: [track] [scene] [name_chars...]
-                // Extract null-terminated name string
-                char clipName[64] = {0};
-                int nameLen = payloadLen - 2; // Subtract track and scene bytes
-                if (nameLen > 0 && nameLen < 63) {
-                    for (int i = 0; i < nameLen; i++) {
-                        clipName[i] = static_cast<char>(payload[2 + i] & 0x7F);
-                    }
-                    clipName[nameLen] = '\0';
-                    guiInterface.sendClipName(track, scene, clipName);
-                    int padIndex = scene * GRID_TRACKS + track;
-                    if (padIndex >= 0 && padIndex < TOTAL_KEYS) {
-                        size_t copyLen = static_cast<size_t>(nameLen);
-                        if (copyLen > MAX_CLIP_NAME_LEN - 1) {
-                            copyLen = MAX_CLIP_NAME_LEN - 1;
-                        }
-                        memcpy(clipNameCache[padIndex], clipName, copyLen);
-                        clipNameCache[padIndex][copyLen] = '\0';
-                        clipNameValid[padIndex] = true;
-                    }
-                    Serial.printf("Clip name -> track %u scene %u: %s\n", track, scene, clipName);
-                } else {
-                    Serial.printf("Clip name -> track %u scene %u (len=%u)\n", track, scene, payloadLen);
-                }
-                break;
+void LiveController::onHandshakeReply(uint8_t, const uint8_t*, uint16_t) {
+    Serial.println("Live: Handshake final (0x01) received.");
+}
+
+void LiveController::onDisconnect(uint8_t, const uint8_t*, uint16_t) {
+    Serial.println("Live: Disconnect command received — clearing state.");
+    liveConnected = false;
+    liveConnectedAt = 0;
+    gridSeen = false;
+    gridRequestRetries = 0;
+    gridRequestLastAttempt = 0;
+    state.reset();
+    sequenceTracker.reset();
+    pendingResync = 0;
+    clipCache.clear();
+    ringNav.reset();
+    previewCheck = false;
+    meters.reset();
+    positions.reset();
+    uint8_t clearFrame[TOTAL_KEYS * 3] = {0};
+    neoTrellisLink.updateGridColors7bit(clearFrame, sizeof(clearFrame));
+    neoTrellisLink.sendCommand(CMD_DISABLE_KEYS, nullptr, 0);
+}
+
+void LiveController::onGridUpdate(uint8_t, const uint8_t* payload, uint16_t length) {
+    const bool fine = length == 192;
+    if (ringNav.moving()) {
+        // A position the hardware has already left: cache only
+        for (uint8_t pad = 0; pad < TOTAL_KEYS && (fine || length == 96); ++pad) {
+            const uint8_t* rgb = fine ? &payload[pad * 6] : &payload[pad * 3];
+            if (fine) {
+                cacheColorWhileMoving(pad, decode14(&rgb[0]), decode14(&rgb[2]), decode14(&rgb[4]));
+            } else {
+                cacheColorWhileMoving(pad, expand7(rgb[0]), expand7(rgb[1]), expand7(rgb[2]));
             }
+        }
+        return;
+    }
+    for (uint8_t pad = 0; pad < TOTAL_KEYS && (fine || length == 96); ++pad) {
+        if (fine) {
+            const uint8_t* rgb = &payload[pad * 6];
+            state.setClipColor(pad, decode14(&rgb[0]), decode14(&rgb[2]), decode14(&rgb[4]));
+        } else {
+            const uint8_t* rgb = &payload[pad * 3];
+            state.setClipColor(pad, expand7(rgb[0]), expand7(rgb[1]), expand7(rgb[2]));
+        }
+        cachePad(pad);
+    }
 
+    if (length == 96) {
+        neoTrellisLink.updateGridColors7bit(payload, static_cast<int>(length));
+        guiInterface.sendGridColors7bit(payload, static_cast<int>(length));
+        LIVE_LOG("Teensy: Forwarded grid bulk (96 bytes, 7-bit RGB) to M4 + GUI\n");
+    } else if (length == 192) {
+        neoTrellisLink.updateGridColors14bit(payload, static_cast<int>(length));
+        guiInterface.sendGridColors14bit(payload, static_cast<int>(length));
+        LIVE_LOG("Teensy: Forwarded grid bulk (192 bytes, 14-bit RGB) to M4 + GUI\n");
+    } else {
+        Serial.printf("Live Grid: payload length invalid (expected 96 or 192, got %u)\n", length);
+        return;
+    }
 
+    if (!gridSeen) {
+        gridSeen = true;
+        Serial.println("Teensy: First grid seen — enabling key scanning on M4");
+        neoTrellisLink.sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
+    }
 
-            case CMD_CLIP_TRIGGER:
-            case CMD_CLIP_STOP:
-            case CMD_SCENE_FIRE:
-            case CMD_TRACK_PLAYING_SLOT:
-            case CMD_TRACK_FIRED_SLOT: {
-                // These normally originate from hardware or are informational from Live
-                // Silently ignore to prevent spam
-                break;
-            }
+    // The whole grid went out as is: nothing left for the flushes
+    state.takeDirty(LiveStateModel::GUI, LiveStateModel::CLIP_COLOR);
+    state.takeDirty(LiveStateModel::LEDS, LiveStateModel::CLIP_COLOR);
 
-            case CMD_SCENE_NAME: {
-                if (payloadLen < 2) {
-                    Serial.println("Live: Scene name payload too short");
-                    break;
-                }
-                uint8_t scene = payload[0] & 0x7F;
-                char sceneName[64] = {0};
-                int nameLen = payloadLen - 1;
-                if (nameLen > 0 && nameLen < 63) {
-                    for (int i = 0; i < nameLen; ++i) {
-                        sceneName[i] = static_cast<char>(payload[1 + i] & 0x7F);
-                    }
-                    sceneName[nameLen] = '\0';
-                    guiInterface.sendSceneName(scene, sceneName);
-                    Serial.printf("Scene name -> scene %u: %s\n", scene, sceneName);
-                } else {
-                    Serial.printf("Scene name -> scene %u (len=%u)\n", scene, payloadLen);
-                }
-                break;
-            }
+    // Names the GUI missed since (e.g. sent while it was away)
+    sendNamesToGUI(false);
+}
 
-            case CMD_SCENE_COLOR: {
-                if (payloadLen < 4) {
-                    Serial.println("Live: Scene color payload too short");
-                    break;
-                }
-                uint8_t scene = payload[0] & 0x7F;
-                uint8_t r = payload[1] & 0x7F;
-                uint8_t g = payload[2] & 0x7F;
-                uint8_t b = payload[3] & 0x7F;
-                guiInterface.sendSceneColor(scene, r, g, b);
-                Serial.printf("Scene color -> scene %u (%u,%u,%u)\n", scene, r, g, b);
-                break;
-            }
+void LiveController::onGridSinglePad(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t padIndex = payload[0] & 0x7F;
+    if (padIndex >= TOTAL_KEYS) {
+        return;
+    }
+    if (ringNav.moving()) {
+        cacheColorWhileMoving(padIndex, decode14(&payload[1]), decode14(&payload[3]), decode14(&payload[5]));
+        return;
+    }
+    // Forwarded by the next flushes (GUI as a pad color, M4 as a delta)
+    state.setClipColor(padIndex, decode14(&payload[1]), decode14(&payload[3]), decode14(&payload[5]));
+    cachePad(padIndex);
+}
 
-            case CMD_SCENE_STATE: {
-                if (payloadLen < 2) {
-                    Serial.println("Live: Scene state payload too short");
-                    break;
-                }
-                uint8_t scene = payload[0] & 0x7F;
-                uint8_t flags = payload[1] & 0x7F;
-                guiInterface.sendSceneState(scene, flags);
-                Serial.printf("Scene state -> scene %u flags 0x%02X\n", scene, flags);
-                break;
-            }
+void LiveController::onClipState(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t scene = payload[1] & 0x7F;
+    uint8_t clipState = payload[2] & 0x7F;
+    uint8_t r = decode14(&payload[3]);
+    uint8_t g = decode14(&payload[5]);
+    uint8_t b = decode14(&payload[7]);
+    int padIndex = scene * GRID_TRACKS + track;
+    if (padIndex >= TOTAL_KEYS) {
+        return;
+    }
+    LIVE_LOG("CLIP_STATE pad %02d (T%d,S%d) state=%u RGB=%u,%u,%u\n",
+             padIndex, track, scene, clipState, r, g, b);
+    if (ringNav.moving()) {
+        // A position the hardware has already left: cache only
+        clipCache.store(ringNav.liveTrack() + track, ringNav.liveScene() + scene, clipState, r, g, b);
+        return;
+    }
+    // Forwarded by the next flushes, merged with any later update of the pad
+    state.setClipState(static_cast<uint8_t>(padIndex), clipState);
+    state.setClipColor(static_cast<uint8_t>(padIndex), r, g, b);
+    cachePad(static_cast<uint8_t>(padIndex));
+}
 
-            case CMD_SCENE_IS_TRIGGERED: {
-                if (payloadLen < 2) {
-                    Serial.println("Live: Scene triggered payload too short");
-                    break;
-                }
-                uint8_t scene = payload[0] & 0x7F;
-                uint8_t flag = payload[1] & 0x7F;
-                guiInterface.sendSceneTriggered(scene, flag);
-                Serial.printf("Scene triggered -> scene %u flag %u\n", scene, flag);
-                break;
-            }
+void LiveController::onClipName(uint8_t, const uint8_t* payload, uint16_t length) {
+    // Payload format: [track] [scene] [name_chars...]
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t scene = payload[1] & 0x7F;
+    int nameLen = length - 2;
+    if (nameLen >= 63) {
+        LIVE_LOG("Clip name -> track %u scene %u (len=%u)\n", track, scene, length);
+        return;
+    }
+    char clipName[64] = {0};
+    for (int i = 0; i < nameLen; i++) {
+        clipName[i] = static_cast<char>(payload[2 + i] & 0x7F);
+    }
+    setName(NAME_CLIP, track, scene, clipName, static_cast<size_t>(nameLen));
+    LIVE_LOG("Clip name -> track %u scene %u: %s\n", track, scene, clipName);
+}
 
-            case CMD_TRACK_NAME: {
-                if (payloadLen < 2) {
-                    Serial.println("Live: Track name payload too short");
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                // Payload format: [track] [name_chars...]
-                char trackName[64] = {0};
-                int nameLen = payloadLen - 1; // Subtract track byte
-                if (nameLen > 0 && nameLen < 63) {
-                    for (int i = 0; i < nameLen; i++) {
-                        trackName[i] = static_cast<char>(payload[1 + i] & 0x7F);
-                    }
-                    trackName[nameLen] = '\0';
-                    guiInterface.sendTrackName(track, trackName);
-                    if (track < GRID_TRACKS) {
-                        size_t copyLen = static_cast<size_t>(nameLen);
-                        if (copyLen > MAX_TRACK_NAME_LEN - 1) {
-                            copyLen = MAX_TRACK_NAME_LEN - 1;
-                        }
-                        memcpy(trackNameCache[track], trackName, copyLen);
-                        trackNameCache[track][copyLen] = '\0';
-                        trackNameValid[track] = true;
-                    }
-                    Serial.printf("Track name -> track %u: %s\n", track, trackName);
-                } else {
-                    Serial.printf("Track name -> track %u (len=%u)\n", track, payloadLen);
-                }
-                break;
-            }
+void LiveController::onRingMetadata(uint8_t, const uint8_t* payload, uint16_t length) {
+    // Bulk metadata: tracks and scenes with names and colors
+    // Format: [num_tracks] [track0: len, name..., R, G, B] ... [track7: ...]
+    //         [num_scenes] [scene0: len, name..., R, G, B] ... [scene3: ...]
+    RingMetadataReader reader(payload, length);
+    char name[64];
+    uint8_t nameLen, r, g, b;
+
+    guiInterface.beginBatch();
+
+    // Parse tracks
+    uint8_t numTracks = 0;
+    reader.count(numTracks);
+    LIVE_LOG("📦 Ring metadata bulk: %u tracks\n", numTracks);
+
+    bool complete = true;
+    for (uint8_t t = 0; t < numTracks; t++) {
+        complete = reader.entry(name, sizeof(name), nameLen, r, g, b);
+        if (!complete) break;  // Cut short: the scene list is not where it should be
+
+        setName(NAME_TRACK, t, 0, name, nameLen);
+        // Colors stay 7-bit, as CMD_TRACK_COLOR carries them to the GUI
+        if (state.setTrackColor(t, r, g, b)) {
+            guiInterface.sendTrackColor(t, r, g, b);
+        }
+    }
 
-            case CMD_TRACK_VOLUME:
-            case CMD_TRACK_PAN:
-            {
-                // Volume and Pan use 14-bit resolution (3 bytes: track, MSB, LSB)
-                Serial.printf("Received CMD 0x%02X: payloadLen=%u\n", command, payloadLen);
-
-                if (payloadLen < 3) {
-                    Serial.printf("❌ Live: Volume/Pan payload too short! Got %u bytes, need 3. Payload: ",
-                                 payloadLen);
-                    for (uint16_t i = 0; i < payloadLen; i++) {
-                        Serial.printf("0x%02X ", payload[i]);
-                    }
-                    Serial.println();
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                uint8_t msb = payload[1] & 0x7F;
-                uint8_t lsb = payload[2] & 0x7F;
-
-                if (command == CMD_TRACK_VOLUME) {
-                    guiInterface.sendMixerVolume(track, msb, lsb);
-                    uint16_t value14bit = (msb << 7) | lsb;
-                    Serial.printf("✅ Mixer VOLUME -> track %u: %u (14bit) → forwarded to GUI\n", track, value14bit);
-                } else {
-                    guiInterface.sendMixerPan(track, msb, lsb);
-                    uint16_t value14bit = (msb << 7) | lsb;
-                    Serial.printf("✅ Mixer PAN -> track %u: %u (14bit) → forwarded to GUI\n", track, value14bit);
-                }
-                break;
-            }
+    // Parse scenes
+    uint8_t numScenes = 0;
+    if (complete && reader.count(numScenes)) {
+        LIVE_LOG("📦 Ring metadata bulk: %u scenes\n", numScenes);
 
-            case CMD_TRACK_SEND_A:
-#if CMD_TRACK_SEND_A != CMD_TRACK_SEND_B
-            case CMD_TRACK_SEND_B:
-#endif
-            {
-                // Sends use 14-bit resolution (4 bytes: track, sendIndex, MSB, LSB)
-                Serial.printf("Received CMD_SEND 0x%02X: payloadLen=%u\n", command, payloadLen);
-
-                if (payloadLen < 4) {
-                    Serial.printf("❌ Live: Send payload too short! Got %u bytes, need 4. Payload: ",
-                                 payloadLen);
-                    for (uint16_t i = 0; i < payloadLen; i++) {
-                        Serial.printf("0x%02X ", payload[i]);
-                    }
-                    Serial.println();
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                uint8_t sendIndex = payload[1] & 0x7F;
-                uint8_t msb = payload[2] & 0x7F;
-                uint8_t lsb = payload[3] & 0x7F;
-
-                guiInterface.sendMixerSend(track, sendIndex, msb, lsb);
-                uint16_t value14bit = (msb << 7) | lsb;
-                Serial.printf("✅ Mixer SEND -> track %u send %u: %u (14bit) → forwarded to GUI\n",
-                             track, sendIndex, value14bit);
-                break;
-            }
+        for (uint8_t s = 0; s < numScenes; s++) {
+            if (!reader.entry(name, sizeof(name), nameLen, r, g, b)) break;
 
-            case CMD_TRACK_MUTE:
-            case CMD_TRACK_SOLO:
-            case CMD_TRACK_ARM:
-            {
-                // Mute/Solo/Arm use single state byte (2 bytes: track, state)
-                if (payloadLen < 2) {
-                    Serial.println("Live: Mute/Solo/Arm payload too short (need 2 bytes)");
-                    break;
-                }
-                uint8_t track = payload[0] & 0x7F;
-                uint8_t state = payload[1] & 0x7F;
-
-                if (command == CMD_TRACK_MUTE) {
-                    guiInterface.sendMixerMute(track, state);
-                    Serial.printf("Mixer MUTE -> track %u: %s\n", track, state ? "ON" : "OFF");
-                } else if (command == CMD_TRACK_SOLO) {
-                    guiInterface.sendMixerSolo(track, state);
-                    Serial.printf("Mixer SOLO -> track %u: %s\n", track, state ? "ON" : "OFF");
-                } else {
-                    guiInterface.sendMixerArm(track, state);
-                    Serial.printf("Mixer ARM -> track %u: %s\n", track, state ? "ON" : "OFF");
-                }
-                break;
+            setName(NAME_SCENE, s, 0, name, nameLen);
+            if (state.setSceneColor(s, r, g, b)) {
+                guiInterface.sendSceneColor(s, r, g, b);
             }
+        }
+    }
 
-            case CMD_TRACK_COLOR:
-                if (payloadLen >= 4) {
-                    uint8_t track = payload[0] & 0x7F;
-                    uint8_t r = payload[1] & 0x7F;
-                    uint8_t g = payload[2] & 0x7F;
-                    uint8_t b = payload[3] & 0x7F;
-                    guiInterface.sendTrackColor(track, r, g, b);
-                    Serial.printf("Track color update track %u -> (%u,%u,%u)\n", track, r, g, b);
-                } else {
-                    Serial.println("Track color payload too short");
-                }
-                break;
-
-            case CMD_TRACK_CROSSFADE:
-                Serial.printf("Track-wide CMD 0x%02X len=%u\n", command, payloadLen);
-                break;
-
-            case CMD_SELECTED_TRACK:
-            case CMD_SELECTED_SCENE: {
-                uint8_t value = payloadLen ? (payload[0] & 0x7F) : 0;
-                Serial.printf("Selection CMD 0x%02X -> %u\n", command, value);
-                if (command == CMD_SELECTED_TRACK) {
-                    guiInterface.sendSelectedTrack(value);
-                    // Update selected track for encoder control
-                    extern void setSelectedTrack(int trackIndex);
-                    setSelectedTrack(value);
-                }
-                break;
-            }
+    guiInterface.endBatch();
 
-            case CMD_TEMPO: {
-                // BPM sent as 16-bit value (MSB, LSB) in units of 0.1 BPM
-                if (payloadLen >= 2) {
-                    uint16_t bpm_fixed = (uint16_t)(((payload[0] & 0x7F) << 7) | (payload[1] & 0x7F));
-                    float bpm = static_cast<float>(bpm_fixed) / 10.0f;
-                    guiInterface.sendBPM(bpm);
-                    Serial.printf("Tempo -> %.1f BPM\n", bpm);
-                } else {
-                    Serial.println("Tempo payload too short");
-                }
-                break;
-            }
+    Serial.printf("✅ Processed ring metadata bulk (%u bytes)\n", length);
+}
 
-            case CMD_TRANSPORT_PLAY:
-            case CMD_TRANSPORT_RECORD: {
-                uint8_t value = payloadLen ? (payload[0] & 0x7F) : 0;
-                bool isPlaying = (command == CMD_TRANSPORT_PLAY) ? (value > 0) : false;
-                bool isRecording = (command == CMD_TRANSPORT_RECORD) ? (value > 0) : false;
-                guiInterface.sendTransportState(isPlaying, isRecording);
-                break;
+void LiveController::onRingClips(uint8_t, const uint8_t* payload, uint16_t length) {
+    // Bulk clips: 32 clips with states and colors
+    // Format: [clip0: state, R, G, B] [clip1: ...] ... [clip31: ...]
+    // Order: column-major (track 0 scenes 0-3, track 1 scenes 0-3, ...)
+
+    uint16_t offset = 0;
+    for (uint8_t track = 0; track < GRID_TRACKS; track++) {
+        for (uint8_t scene = 0; scene < GRID_SCENES; scene++) {
+            if (offset + 3 >= length) break;
+
+            uint8_t clipState = payload[offset++] & 0x7F;
+            uint8_t r8 = expand7(payload[offset++]);
+            uint8_t g8 = expand7(payload[offset++]);
+            uint8_t b8 = expand7(payload[offset++]);
+
+            int padIndex = scene * GRID_TRACKS + track;
+            if (ringNav.moving()) {
+                // A position the hardware has already left: cache only
+                clipCache.store(ringNav.liveTrack() + track, ringNav.liveScene() + scene, clipState, r8, g8, b8);
+            } else if (padIndex < TOTAL_KEYS) {
+                const uint8_t pad = static_cast<uint8_t>(padIndex);
+                const bool changed = state.setClipState(pad, clipState) | state.setClipColor(pad, r8, g8, b8);
+                if (previewCheck && changed) {
+                    prefetchStats.corrections++; // The cache was out of date for this clip
+                }
+                cachePad(pad);
             }
+        }
+    }
+    if (!ringNav.moving()) {
+        previewCheck = false;
+    }
 
-            // === INFORMATIONAL COMMANDS (silenced to reduce log spam and delay) ===
-            case CMD_TRANSPORT_LOOP:
-            case CMD_TRANSPORT_METRONOME:
-            case CMD_TRANSPORT_SIGNATURE:
-            case CMD_TRANSPORT_POSITION:
-            case CMD_TRANSPORT_OVERDUB:  // Also known as CMD_ARRANGEMENT_RECORD
-            case CMD_TRANSPORT_PUNCH:
-            case CMD_RECORD_QUANTIZATION:
-            case CMD_QUANTIZE_CLIP:
-            case CMD_BACK_TO_ARRANGER:
-            case CMD_RE_ENABLE_AUTOMATION:
-            case CMD_TRANSPORT_QUANTIZE:
-            case CMD_TRANSPORT:
-            case CMD_STEP_SEQUENCER_STATE:
-            case CMD_DEVICE_LIST:
-            case CMD_DEVICE_ENABLE:
-            case CMD_PARAM_VALUE:
-            case CMD_CHAIN_SELECT:
-            case CMD_DRUM_PAD_STATE:
-            case CMD_LOOP_MARKERS:
-            case CMD_CLIP_LOOP:
-            case CMD_CLIP_MUTED: {
-                // Silently process - these are high-frequency or informational commands
-                break;
-            }
+    // The ring arrives whole: flush the changed pads now, in one batch per link
+    flushLeds();
+    flushGui();
 
-            case CMD_DISCONNECT: {
-                Serial.println("Live: Disconnect command received — clearing state.");
-                liveConnected = false;
-                liveConnectedAt = 0;
-                gridSeen = false;
-                gridRequestRetries = 0;
-                gridRequestLastAttempt = 0;
-                uint8_t clearFrame[TOTAL_KEYS * 3] = {0};
-                neoTrellisLink.sendCommand(CMD_LED_GRID_UPDATE, clearFrame, sizeof(clearFrame));
-                neoTrellisLink.sendCommand(CMD_DISABLE_KEYS, nullptr, 0);
-                break;
-            }
+    Serial.printf("✅ Processed ring clips bulk (%u clips)\n", 32);
 
-            case CMD_HANDSHAKE:
-                Serial.println("Live: secondary handshake ping received");
-                break;
+    // Mark grid as seen and enable keys (like CMD_GRID_UPDATE does)
+    if (!gridSeen) {
+        gridSeen = true;
+        Serial.println("Teensy: First grid seen (bulk clips) — enabling key scanning on M4");
+        neoTrellisLink.sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
+    }
 
-            case CMD_SESSION_RING_METADATA: {
-                // Bulk metadata: tracks and scenes with names and colors
-                // Format: [num_tracks] [track0: len, name..., R, G, B] ... [track7: ...]
-                //         [num_scenes] [scene0: len, name..., R, G, B] ... [scene3: ...]
-                uint16_t offset = 0;
+    // Names the GUI missed since (e.g. sent while it was away)
+    sendNamesToGUI(false);
+}
 
-                if (payloadLen < 1) {
-                    Serial.println("Live: Ring metadata bulk payload too short");
-                    break;
-                }
+void LiveController::onRingPosition(uint8_t command, const uint8_t* payload, uint16_t length) {
+    LIVE_LOG("Ring position -> track %u scene %u w=%u h=%u ov=%u\n",
+             decode14(&payload[0]), decode14(&payload[2]),
+             payload[4] & 0x7F, payload[5] & 0x7F, payload[6] & 0x7F);
+    if (ringNav.reported(decode14(&payload[0]), decode14(&payload[2])) && previewCheck && !previewRing()) {
+        // The preview was drawn for a position past the edge of the set and
+        // Live's own ring is not cached: ask for it
+        previewCheck = false;
+        requestResync(LiveSequenceTracker::AREA_GRID);
+    }
+    uiBridge.processLiveSysEx(command, payload, static_cast<uint8_t>(length));
+    prefetchAroundRing(millis());
+}
 
-                // Parse tracks
-                uint8_t numTracks = payload[offset++] & 0x7F;
-                Serial.printf("📦 Ring metadata bulk: %u tracks\n", numTracks);
-
-                for (uint8_t t = 0; t < numTracks && offset < payloadLen; t++) {
-                    if (offset >= payloadLen) break;
-
-                    uint8_t nameLen = payload[offset++] & 0x7F;
-                    if (offset + nameLen + 3 > payloadLen) break;  // name + RGB
-
-                    char trackName[64] = {0};
-                    for (uint8_t i = 0; i < nameLen && i < 63; i++) {
-                        trackName[i] = static_cast<char>(payload[offset++] & 0x7F);
-                    }
-                    trackName[nameLen] = '\0';
-
-                    uint8_t r7 = payload[offset++] & 0x7F;
-                    uint8_t g7 = payload[offset++] & 0x7F;
-                    uint8_t b7 = payload[offset++] & 0x7F;
-
-                    // Convert 7-bit to 8-bit
-                    uint8_t r8 = r7 << 1;
-                    uint8_t g8 = g7 << 1;
-                    uint8_t b8 = b7 << 1;
-
-                    guiInterface.sendTrackName(t, trackName);
-                    guiInterface.sendTrackColor(t, r8, g8, b8);
-
-                    if (t < GRID_TRACKS) {
-                        size_t copyLen = strlen(trackName);
-                        if (copyLen > MAX_TRACK_NAME_LEN - 1) {
-                            copyLen = MAX_TRACK_NAME_LEN - 1;
-                        }
-                        memcpy(trackNameCache[t], trackName, copyLen);
-                        trackNameCache[t][copyLen] = '\0';
-                        trackNameValid[t] = true;
-                    }
-                }
+void LiveController::onClipWindow(uint8_t, const uint8_t* payload, uint16_t length) {
+    // [track_msb, track_lsb, scene_msb, scene_lsb, width, height] + cells,
+    // column-major like the ring clips
+    const uint16_t track = decode14(&payload[0]);
+    const uint16_t scene = decode14(&payload[2]);
+    const uint8_t width = payload[4] & 0x7F;
+    const uint8_t height = payload[5] & 0x7F;
+    if (length != 6 + width * height * 4) {
+        Serial.printf("Live clip window: %ux%u needs %u bytes, got %u\n",
+                      width, height, 6 + width * height * 4, length);
+        return;
+    }
+    const uint8_t* cell = &payload[6];
+    for (uint8_t t = 0; t < width; ++t) {
+        for (uint8_t s = 0; s < height; ++s, cell += 4) {
+            // expand7, as for ring clips and grid bulks, so a preview matches them
+            clipCache.store(track + t, scene + s, cell[0] & 0x7F,
+                            expand7(cell[1]), expand7(cell[2]), expand7(cell[3]));
+        }
+    }
+    prefetchStats.windows++;
+    LIVE_LOG("Clip window -> T%u S%u %ux%u cached\n", track, scene, width, height);
+}
 
-                // Parse scenes
-                if (offset < payloadLen) {
-                    uint8_t numScenes = payload[offset++] & 0x7F;
-                    Serial.printf("📦 Ring metadata bulk: %u scenes\n", numScenes);
+// Pads are cached under their absolute clip, at the ring origin Live reported
+void LiveController::cachePad(uint8_t pad) {
+    clipCache.store(ringNav.liveTrack() + pad % GRID_TRACKS, ringNav.liveScene() + pad / GRID_TRACKS, state.clipState(pad),
+                    state.clipR(pad), state.clipG(pad), state.clipB(pad));
+}
 
-                    for (uint8_t s = 0; s < numScenes && offset < payloadLen; s++) {
-                        if (offset >= payloadLen) break;
+// A colour for Live's ring while the hardware shows another position: kept
+// with the clip's cached state, dropped when the clip is not cached
+void LiveController::cacheColorWhileMoving(uint8_t pad, uint8_t r, uint8_t g, uint8_t b) {
+    const uint16_t track = ringNav.liveTrack() + pad % GRID_TRACKS;
+    const uint16_t scene = ringNav.liveScene() + pad / GRID_TRACKS;
+    uint8_t clipState, oldR, oldG, oldB;
+    if (clipCache.lookup(track, scene, clipState, oldR, oldG, oldB)) {
+        clipCache.store(track, scene, clipState, r, g, b);
+    }
+}
 
-                        uint8_t nameLen = payload[offset++] & 0x7F;
-                        if (offset + nameLen + 3 > payloadLen) break;
+// Asks Live for the ring-sized windows around the ring: only the clips not
+// cached yet, or all of them once the cache is older than the refresh time
+// (Live does not push changes outside the ring).
+void LiveController::prefetchAroundRing(unsigned long now) {
+    if (!liveConnected) {
+        return;
+    }
+    const bool refresh = prefetchStats.requests == 0 || now - lastPrefetchAt >= LIVE_CLIP_PREFETCH_REFRESH_MS;
+    if (refresh) {
+        lastPrefetchAt = now;
+    }
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if (!dx && !dy) {
+                continue;
+            }
+            int track = ringNav.liveTrack() + dx * GRID_TRACKS;
+            int scene = ringNav.liveScene() + dy * GRID_SCENES;
+            int width = GRID_TRACKS;
+            int height = GRID_SCENES;
+            if (track < 0) {
+                width += track;
+                track = 0;
+            }
+            if (scene < 0) {
+                height += scene;
+                scene = 0;
+            }
+            if (width <= 0 || height <= 0) {
+                continue;
+            }
+            uint16_t t = static_cast<uint16_t>(track);
+            uint16_t s = static_cast<uint16_t>(scene);
+            uint8_t w = static_cast<uint8_t>(width);
+            uint8_t h = static_cast<uint8_t>(height);
+            if (!refresh && !clipCache.missingBounds(t, s, w, h)) {
+                continue;
+            }
+            const uint8_t request[6] = {
+                static_cast<uint8_t>((t >> 7) & 0x7F), static_cast<uint8_t>(t & 0x7F),
+                static_cast<uint8_t>((s >> 7) & 0x7F), static_cast<uint8_t>(s & 0x7F),
+                w, h
+            };
+            sendSysExToAbleton(CMD_CLIP_WINDOW_REQUEST, request, sizeof(request));
+            prefetchStats.requests++;
+        }
+    }
+}
 
-                        char sceneName[64] = {0};
-                        for (uint8_t i = 0; i < nameLen && i < 63; i++) {
-                            sceneName[i] = static_cast<char>(payload[offset++] & 0x7F);
-                        }
-                        sceneName[nameLen] = '\0';
+void LiveController::moveRing(int trackDelta, int sceneDelta) {
+    ringNav.move(trackDelta, sceneDelta, millis());
+    previewRing();
+}
 
-                        uint8_t r7 = payload[offset++] & 0x7F;
-                        uint8_t g7 = payload[offset++] & 0x7F;
-                        uint8_t b7 = payload[offset++] & 0x7F;
+// Absolute position: [track_msb, track_lsb, scene_msb, scene_lsb, width, height, overview]
+void LiveController::sendRingPosition() {
+    const uint16_t track = ringNav.track();
+    const uint16_t scene = ringNav.scene();
+    const uint8_t payload[7] = {
+        static_cast<uint8_t>((track >> 7) & 0x7F), static_cast<uint8_t>(track & 0x7F),
+        static_cast<uint8_t>((scene >> 7) & 0x7F), static_cast<uint8_t>(scene & 0x7F),
+        GRID_TRACKS, GRID_SCENES, 0
+    };
+    sendSysExToAbleton(CMD_RING_POSITION, payload, sizeof(payload));
+    LIVE_LOG("Ring position sent -> track %u scene %u\n", track, scene);
+}
 
-                        // Convert 7-bit to 8-bit
-                        uint8_t r8 = r7 << 1;
-                        uint8_t g8 = g7 << 1;
-                        uint8_t b8 = b7 << 1;
+// When the window the ring is moving to is cached, the grid is redrawn from
+// it right away (only changed pads go out); Live's ring clips for the new
+// position then correct any stale pad.
+bool LiveController::previewRing() {
+    if (!liveConnected || !gridSeen) {
+        return false;
+    }
+    const uint16_t track = ringNav.track();
+    const uint16_t scene = ringNav.scene();
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if (!clipCache.contains(track + pad % GRID_TRACKS, scene + pad / GRID_TRACKS)) {
+            prefetchStats.previewMisses++;
+            return false; // A half-drawn grid would be worse than a late one
+        }
+    }
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        uint8_t clipState, r, g, b;
+        clipCache.lookup(track + pad % GRID_TRACKS, scene + pad / GRID_TRACKS, clipState, r, g, b);
+        state.setClipState(pad, clipState);
+        state.setClipColor(pad, r, g, b);
+    }
+    flushLeds();
+    flushGui();
+    prefetchStats.previews++;
+    previewCheck = true;
+    return true;
+}
 
-                        guiInterface.sendSceneName(s, sceneName);
-                        guiInterface.sendSceneColor(s, r8, g8, b8);
-                    }
-                }
+void LiveController::onSceneName(uint8_t, const uint8_t* payload, uint16_t length) {
+    uint8_t scene = payload[0] & 0x7F;
+    int nameLen = length - 1;
+    if (nameLen >= 63) {
+        LIVE_LOG("Scene name -> scene %u (len=%u)\n", scene, length);
+        return;
+    }
+    setName(NAME_SCENE, scene, 0, reinterpret_cast<const char*>(&payload[1]), static_cast<size_t>(nameLen));
+    LIVE_LOG("Scene name -> scene %u: %.*s\n", scene, nameLen, reinterpret_cast<const char*>(&payload[1]));
+}
 
-                Serial.printf("✅ Processed ring metadata bulk (%u bytes)\n", payloadLen);
-                break;
-            }
+void LiveController::onSceneColor(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t scene = payload[0] & 0x7F;
+    uint8_t r = payload[1] & 0x7F;
+    uint8_t g = payload[2] & 0x7F;
+    uint8_t b = payload[3] & 0x7F;
+    if (scene >= LiveStateModel::SCENES) {
+        // Beyond the mirror: straight through, unmerged
+        guiInterface.sendSceneColor(scene, r, g, b);
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    if (!state.setSceneColor(scene, r, g, b)) {
+        return;
+    }
+    guiInterface.sendSceneColor(scene, r, g, b);
+    LIVE_LOG("Scene color -> scene %u (%u,%u,%u)\n", scene, r, g, b);
+}
 
-            case CMD_SESSION_RING_CLIPS: {
-                // Bulk clips: 32 clips with states and colors
-                // Format: [clip0: state, R, G, B] [clip1: ...] ... [clip31: ...]
-                // Order: column-major (track 0 scenes 0-3, track 1 scenes 0-3, ...)
+void LiveController::onSceneState(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t scene = payload[0] & 0x7F;
+    uint8_t flags = payload[1] & 0x7F;
+    if (scene >= LiveStateModel::SCENES) {
+        guiInterface.sendSceneState(scene, flags);
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    if (!state.setSceneState(scene, flags)) {
+        return;
+    }
+    guiInterface.sendSceneState(scene, flags);
+    LIVE_LOG("Scene state -> scene %u flags 0x%02X\n", scene, flags);
+}
 
-                const uint8_t expectedBytes = 32 * 4;  // 32 clips × 4 bytes each
-                if (payloadLen < expectedBytes) {
-                    Serial.printf("Live: Ring clips bulk payload too short (got %u, need %u)\n",
-                                 payloadLen, expectedBytes);
-                    break;
-                }
+void LiveController::onSceneTriggered(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t scene = payload[0] & 0x7F;
+    uint8_t flag = payload[1] & 0x7F;
+    if (scene >= LiveStateModel::SCENES) {
+        guiInterface.sendSceneTriggered(scene, flag);
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    if (!state.setSceneTriggered(scene, flag != 0)) {
+        return;
+    }
+    guiInterface.sendSceneTriggered(scene, flag);
+    LIVE_LOG("Scene triggered -> scene %u flag %u\n", scene, flag);
+}
 
-                Serial.printf("📦 Ring clips bulk: 32 clips\n");
-
-                uint16_t offset = 0;
-                for (uint8_t track = 0; track < GRID_TRACKS; track++) {
-                    for (uint8_t scene = 0; scene < GRID_SCENES; scene++) {
-                        if (offset + 3 >= payloadLen) break;
-
-                        uint8_t state = payload[offset++] & 0x7F;
-                        uint8_t r7 = payload[offset++] & 0x7F;
-                        uint8_t g7 = payload[offset++] & 0x7F;
-                        uint8_t b7 = payload[offset++] & 0x7F;
-
-                        // Convert 7-bit to 8-bit for RGB
-                        uint8_t r8 = r7 << 1;
-                        uint8_t g8 = g7 << 1;
-                        uint8_t b8 = b7 << 1;
-
-                        // Send to NeoTrellis
-                        int padIndex = scene * GRID_TRACKS + track;
-                        if (padIndex >= 0 && padIndex < TOTAL_KEYS) {
-                            uint8_t m4Data[] = {
-                                static_cast<uint8_t>(padIndex),
-                                r8, g8, b8
-                            };
-                            neoTrellisLink.sendCommand(CMD_LED_PAD_UPDATE, m4Data, sizeof(m4Data));
-
-                            uint8_t statePayload[] = { static_cast<uint8_t>(padIndex), state };
-                            neoTrellisLink.sendCommand(CMD_LED_CLIP_STATE, statePayload, sizeof(statePayload));
-                        }
-
-                        // Send to GUI (convert to 14-bit for full fidelity)
-                        uint16_t r14 = r8 << 1;
-                        uint16_t g14 = g8 << 1;
-                        uint16_t b14 = b8 << 1;
-                        guiInterface.sendClipState(track, scene, state,
-                                                   (r14 >> 7) & 0x7F, r14 & 0x7F,
-                                                   (g14 >> 7) & 0x7F, g14 & 0x7F,
-                                                   (b14 >> 7) & 0x7F, b14 & 0x7F);
-                    }
-                }
+void LiveController::onTrackName(uint8_t, const uint8_t* payload, uint16_t length) {
+    // Payload format: [track] [name_chars...]
+    uint8_t track = payload[0] & 0x7F;
+    int nameLen = length - 1;
+    if (nameLen >= 63) {
+        LIVE_LOG("Track name -> track %u (len=%u)\n", track, length);
+        return;
+    }
+    char trackName[64] = {0};
+    for (int i = 0; i < nameLen; i++) {
+        trackName[i] = static_cast<char>(payload[1 + i] & 0x7F);
+    }
+    setName(NAME_TRACK, track, 0, trackName, static_cast<size_t>(nameLen));
+    LIVE_LOG("Track name -> track %u: %s\n", track, trackName);
+}
 
-                Serial.printf("✅ Processed ring clips bulk (%u clips)\n", 32);
+void LiveController::onTrackColor(uint8_t, const uint8_t* payload, uint16_t) {
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t r = payload[1] & 0x7F;
+    uint8_t g = payload[2] & 0x7F;
+    uint8_t b = payload[3] & 0x7F;
+    if (track >= LiveStateModel::TRACKS) {
+        // Beyond the mirror: straight through, unmerged
+        guiInterface.sendTrackColor(track, r, g, b);
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    if (!state.setTrackColor(track, r, g, b)) {
+        return;
+    }
+    guiInterface.sendTrackColor(track, r, g, b);
+    LIVE_LOG("Track color update track %u -> (%u,%u,%u)\n", track, r, g, b);
+}
 
-                // Mark grid as seen and enable keys (like CMD_GRID_UPDATE does)
-                if (!gridSeen) {
-                    gridSeen = true;
-                    Serial.println("Teensy: First grid seen (bulk clips) — enabling key scanning on M4");
-                    neoTrellisLink.sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
-                }
+void LiveController::onMixerLevel(uint8_t command, const uint8_t* payload, uint16_t) {
+    // Volume and Pan use 14-bit resolution (3 bytes: track, MSB, LSB)
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t msb = payload[1] & 0x7F;
+    uint8_t lsb = payload[2] & 0x7F;
+    const uint16_t value = static_cast<uint16_t>((msb << 7) | lsb);
+    if (track >= LiveStateModel::TRACKS) {
+        // Beyond the mirror: straight through, unmerged
+        if (command == CMD_TRACK_VOLUME) {
+            guiInterface.sendMixerVolume(track, msb, lsb);
+        } else {
+            guiInterface.sendMixerPan(track, msb, lsb);
+        }
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    // Forwarded by the next GUI flush with the newest value
+    if (command == CMD_TRACK_VOLUME) {
+        state.setVolume(track, value);
+    } else {
+        state.setPan(track, value);
+    }
+    LIVE_LOG("Mixer %s -> track %u: %u (14bit)\n",
+             command == CMD_TRACK_VOLUME ? "VOLUME" : "PAN", track, value);
+}
 
-                // Resend cached names to ensure GUI is in sync
-                broadcastCachedNamesToGUI();
-                break;
-            }
+void LiveController::onMixerSend(uint8_t, const uint8_t* payload, uint16_t) {
+    // Sends use 14-bit resolution (4 bytes: track, sendIndex, MSB, LSB)
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t sendIndex = payload[1] & 0x7F;
+    uint8_t msb = payload[2] & 0x7F;
+    uint8_t lsb = payload[3] & 0x7F;
+    if (track >= LiveStateModel::TRACKS || sendIndex >= LiveStateModel::SENDS) {
+        guiInterface.sendMixerSend(track, sendIndex, msb, lsb);
+        coalesceStats.guiForwarded++;
+        return;
+    }
+    state.setSend(track, sendIndex, static_cast<uint16_t>((msb << 7) | lsb));
+    LIVE_LOG("Mixer SEND -> track %u send %u: %u (14bit)\n", track, sendIndex, (msb << 7) | lsb);
+}
 
-            default:
-                // Custom vendor messages (F0 7D ...) still go through processSysEx
-                Serial.print("Unhandled Live CMD:0x");
-                Serial.println(command, HEX);
-                break;
+void LiveController::onMixerToggle(uint8_t command, const uint8_t* payload, uint16_t) {
+    // Mute/Solo/Arm use single state byte (2 bytes: track, state)
+    uint8_t track = payload[0] & 0x7F;
+    uint8_t value = payload[1] & 0x7F;
+    if (track >= LiveStateModel::TRACKS) {
+        // Beyond the mirror: straight through, unmerged
+        if (command == CMD_TRACK_MUTE) {
+            guiInterface.sendMixerMute(track, value);
+        } else if (command == CMD_TRACK_SOLO) {
+            guiInterface.sendMixerSolo(track, value);
+        } else {
+            guiInterface.sendMixerArm(track, value);
         }
+        coalesceStats.guiForwarded++;
+        return;
     }
+    if (command == CMD_TRACK_MUTE) {
+        if (state.setMute(track, value != 0)) {
+            guiInterface.sendMixerMute(track, value);
+        }
+    } else if (command == CMD_TRACK_SOLO) {
+        if (state.setSolo(track, value != 0)) {
+            guiInterface.sendMixerSolo(track, value);
+        }
+    } else if (state.setArm(track, value != 0)) {
+        guiInterface.sendMixerArm(track, value);
+    }
+    LIVE_LOG("Mixer CMD 0x%02X -> track %u: %s\n", command, track, value ? "ON" : "OFF");
+}
+
+void LiveController::onSelectedTrack(uint8_t, const uint8_t* payload, uint16_t length) {
+    uint8_t value = length ? (payload[0] & 0x7F) : 0;
+    LIVE_LOG("Selected track -> %u\n", value);
+    if (!state.setSelectedTrack(value)) {
+        return;
+    }
+    guiInterface.sendSelectedTrack(value);
+    // Update selected track for encoder control
+    extern void setSelectedTrack(int trackIndex);
+    setSelectedTrack(value);
+}
+
+void LiveController::onTrackSelect(uint8_t, const uint8_t* payload, uint16_t) {
+    LIVE_LOG("Live: Track select echo -> %u\n", payload[0] & 0x7F);
+}
+
+void LiveController::onSceneSelect(uint8_t, const uint8_t* payload, uint16_t) {
+    LIVE_LOG("Live: Scene select echo -> %u\n", payload[0] & 0x7F);
+}
+
+void LiveController::onDetailClip(uint8_t, const uint8_t* payload, uint16_t) {
+    LIVE_LOG("Live: Detail clip focus -> track %u scene %u\n", payload[0] & 0x7F, payload[1] & 0x7F);
+}
+
+void LiveController::onTempo(uint8_t, const uint8_t* payload, uint16_t) {
+    // BPM sent as 16-bit value (MSB, LSB) in units of 0.1 BPM
+    const uint16_t tenths = decode14(payload);
+    if (!state.setTempo(tenths)) {
+        return;
+    }
+    positions.setTempo(tenths, millis());
+    float bpm = static_cast<float>(tenths) / 10.0f;
+    guiInterface.sendBPM(bpm);
+    LIVE_LOG("Tempo -> %.1f BPM\n", bpm);
+}
+
+void LiveController::onTransport(uint8_t command, const uint8_t* payload, uint16_t length) {
+    uint8_t value = length ? (payload[0] & 0x7F) : 0;
+    // Each command carries one bit; the GUI message needs both
+    const bool changed = command == CMD_TRANSPORT_PLAY ? state.setPlaying(value > 0)
+                                                       : state.setRecording(value > 0);
+    if (!changed) {
+        return;
+    }
+    if (command == CMD_TRANSPORT_PLAY) {
+        positions.setRunning(state.playing(), millis());
+    }
+    guiInterface.sendTransportState(state.playing(), state.recording());
 }
 
 void LiveController::updateClipState(int padIndex, int state) {
@@ -808,8 +1036,7 @@ void LiveController::sendSysExToAbleton(uint8_t command, const uint8_t* data, in
     }
     if (dataLength < 0) dataLength = 0;
 
-    static uint8_t sequence = 0;
-    sequence = (sequence + 1) & 0x7F;
+    const uint8_t sequence = sequenceTracker.nextOutbound();
 
     const uint8_t lenMsb = (dataLength >> 7) & 0x7F;
     const uint8_t lenLsb = dataLength & 0x7F;
@@ -885,7 +1112,7 @@ int LiveController::getLocalKeyFromGlobal(int globalKey) {
     return globalKey % 16;
 }
 
-void LiveController::processSysEx(uint8_t* data, int length) {
+void LiveController::processSysEx(const uint8_t* data, int length) {
     if (length < 5 || data[0] != SYSEX_START || data[length - 1] != SYSEX_END) return;
     if (data[1] != MANUFACTURER_ID || data[2] != DEVICE_ID) return;
     
@@ -901,7 +1128,7 @@ void LiveController::processSysEx(uint8_t* data, int length) {
     }
 }
 
-void LiveController::processHandshakeMessage(uint8_t* data, int length) {
+void LiveController::processHandshakeMessage(const uint8_t* data, int length) {
     uint8_t command = 0;
     uint8_t sequence = 0;
     uint16_t payloadLen = 0;
@@ -924,12 +1151,14 @@ void LiveController::processHandshakeMessage(uint8_t* data, int length) {
 
     // Allow Live to re-establish state if it reopens ports
     liveConnected = true;
+    sequenceTracker.reset();
+    pendingResync = 0;
     liveConnectedAt = millis();
     gridSeen = false;
     gridRequestRetries = 0;
     gridRequestLastAttempt = 0;
     Serial.println("Teensy: ✓ Live connection established (ack sent).");
-    broadcastCachedNamesToGUI();
+    sendNamesToGUI(false);
     if (neoTrellisLink.isConnected()) {
         Serial.println("Teensy: Live connected — enabling NeoTrellis key scanning.");
         neoTrellisLink.sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
@@ -958,42 +1187,332 @@ void LiveController::sendHandshakeResponse() {
 void LiveController::waitForLiveHandshake() {
     if (liveConnected) return;
 
-    // This loop now only looks for one thing: the SysEx handshake from Live.
-    // It's much faster and less prone to timing errors.
+    // SysEx goes through handleUsbSysEx(), which only looks for one thing
+    // until Live is connected: the SysEx handshake from Live.
     while (usbMIDI.read()) {
-        if (usbMIDI.getType() == usbMIDI.SystemExclusive) {
-            uint8_t* data = usbMIDI.getSysExArray();
-            uint16_t length = usbMIDI.getSysExArrayLength();
-            
-            // A valid handshake message will not be null and will have a minimum length.
-            if (data && length >= 6) {
-                // Pass the message to the dedicated handler.
-                processHandshakeMessage(data, length);
-            }
+    }
+}
+
+void LiveController::flushLeds() {
+    typedef LiveStateModel M;
+    const uint32_t stateMask = state.takeDirty(M::LEDS, M::CLIP_STATE);
+    const uint32_t colorMask = state.takeDirty(M::LEDS, M::CLIP_COLOR);
+    if (!(stateMask | colorMask)) {
+        return;
+    }
+    coalesceStats.ledFlushes++;
+
+    neoTrellisLink.beginBatch();
+    for (uint8_t pad = 0; pad < M::PADS; ++pad) {
+        const uint32_t bit = 1UL << pad;
+        if (colorMask & bit) {
+            neoTrellisLink.stagePadColor(pad, state.clipR(pad), state.clipG(pad), state.clipB(pad));
+            coalesceStats.ledForwarded++;
+        }
+        if (stateMask & bit) {
+            neoTrellisLink.stageClipState(pad, state.clipState(pad));
+            coalesceStats.ledForwarded++;
         }
     }
+    // States and colors go out together, as one frame when the M4 takes it
+    neoTrellisLink.commitPads();
+    neoTrellisLink.endBatch();
+}
+
+void LiveController::onTrackMeter(uint8_t, const uint8_t* payload, uint16_t length) {
+    // [track, level] or [track, left, right]: the GUI meter shows the louder side
+    uint8_t level = payload[1] & 0x7F;
+    if (length > 2 && (payload[2] & 0x7F) > level) {
+        level = payload[2] & 0x7F;
+    }
+    meters.input(payload[0] & 0x7F, level, millis());
+}
+
+// Decay runs whether or not the GUI listens, so a GUI that connects later
+// does not see stale peaks
+void LiveController::flushMeters() {
+    const uint16_t first = ringNav.liveTrack();
+    meters.setVisible(static_cast<uint8_t>(first < LiveMeterStage::TRACKS ? first : LiveMeterStage::TRACKS),
+                      GRID_TRACKS);
+    uint8_t frame[LiveMeterStage::MAX_FRAME];
+    const uint8_t length = meters.tick(millis(), frame);
+    if (length && guiInterface.isConnected()) {
+        guiInterface.sendMeters(frame, length);
+    }
+}
+
+void LiveController::onClipPosition(uint8_t, const uint8_t* payload, uint16_t) {
+    // [track, scene, hi, lo]
+    positions.anchor(payload[0] & 0x7F, payload[1] & 0x7F, decode14(payload + 2), millis());
+}
+
+void LiveController::onClipLength(uint8_t, const uint8_t* payload, uint16_t) {
+    positions.setLength(payload[0] & 0x7F, payload[1] & 0x7F, decode14(payload + 2));
 }
 
-void LiveController::resendCachedNamesToGUI() {
-    broadcastCachedNamesToGUI();
+void LiveController::onSongPosition(uint8_t, const uint8_t* payload, uint16_t) {
+    // [hi, lo]
+    positions.anchor(ClipPositionEstimator::SONG_SLOT, 0, decode14(payload), millis());
+}
+
+void LiveController::flushPositions() {
+    const uint16_t first = ringNav.liveTrack();
+    positions.setVisible(static_cast<uint8_t>(first < ClipPositionEstimator::TRACKS ? first : ClipPositionEstimator::TRACKS),
+                         GRID_TRACKS);
+    uint8_t frame[ClipPositionEstimator::MAX_FRAME];
+    const uint8_t length = positions.tick(millis(), frame);
+    if (length && guiInterface.isConnected()) {
+        guiInterface.sendPositions(frame, length);
+    }
 }
 
-void LiveController::broadcastCachedNamesToGUI() {
+void LiveController::flushGui() {
+    typedef LiveStateModel M;
+    const uint32_t stateMask = state.takeDirty(M::GUI, M::CLIP_STATE);
+    const uint32_t colorMask = state.takeDirty(M::GUI, M::CLIP_COLOR);
+    const uint32_t volumeMask = state.takeDirty(M::GUI, M::TRACK_VOLUME);
+    const uint32_t panMask = state.takeDirty(M::GUI, M::TRACK_PAN);
+    uint32_t sendMasks[M::SENDS];
+    uint32_t any = stateMask | colorMask | volumeMask | panMask;
+    for (uint8_t send = 0; send < M::SENDS; ++send) {
+        sendMasks[send] = state.takeDirty(M::GUI, M::sendField(send));
+        any |= sendMasks[send];
+    }
+    if (!any || !guiInterface.isConnected()) {
+        return; // A GUI connecting later gets the whole state from replayStateToGUI()
+    }
+    coalesceStats.guiFlushes++;
+
+    guiInterface.beginBatch();
+    for (uint8_t pad = 0; pad < M::PADS; ++pad) {
+        const uint32_t bit = 1UL << pad;
+        if (!((stateMask | colorMask) & bit)) {
+            continue;
+        }
+        // 8-bit color split into MSB/LSB pairs, as Live sends it
+        const uint8_t r = state.clipR(pad);
+        const uint8_t g = state.clipG(pad);
+        const uint8_t b = state.clipB(pad);
+        if (stateMask & bit) {
+            guiInterface.sendClipState(pad % GRID_TRACKS, pad / GRID_TRACKS, state.clipState(pad),
+                                       r >> 7, r & 0x7F, g >> 7, g & 0x7F, b >> 7, b & 0x7F);
+        } else {
+            guiInterface.sendPadColor14bit(pad, r >> 7, r & 0x7F, g >> 7, g & 0x7F, b >> 7, b & 0x7F);
+        }
+        coalesceStats.guiForwarded++;
+    }
+    for (uint8_t track = 0; track < M::TRACKS; ++track) {
+        const uint32_t bit = 1UL << track;
+        if (volumeMask & bit) {
+            guiInterface.sendMixerVolume(track, state.volume(track) >> 7, state.volume(track) & 0x7F);
+            coalesceStats.guiForwarded++;
+        }
+        if (panMask & bit) {
+            guiInterface.sendMixerPan(track, state.pan(track) >> 7, state.pan(track) & 0x7F);
+            coalesceStats.guiForwarded++;
+        }
+        for (uint8_t send = 0; send < M::SENDS; ++send) {
+            if (sendMasks[send] & bit) {
+                const uint16_t value = state.send(track, send);
+                guiInterface.sendMixerSend(track, send, value >> 7, value & 0x7F);
+                coalesceStats.guiForwarded++;
+            }
+        }
+    }
+    guiInterface.endBatch();
+}
+
+void LiveController::replayStateToGUI() {
     if (!guiInterface.isConnected()) {
         return;
     }
 
-    for (int track = 0; track < GRID_TRACKS; ++track) {
-        if (trackNameValid[track] && trackNameCache[track][0] != '\0') {
-            guiInterface.sendTrackName(static_cast<uint8_t>(track), trackNameCache[track]);
+    guiInterface.beginBatch();
+    sendNamesToGUI(true);
+    meters.resend();
+    positions.resend();
+
+    typedef LiveStateModel M;
+    for (uint8_t pad = 0; pad < M::PADS; ++pad) {
+        if (!state.isValid(M::CLIP_STATE, pad)) {
+            continue;
+        }
+        // 8-bit color split into the MSB/LSB pairs CMD_CLIP_STATE carries
+        const uint8_t r = state.clipR(pad);
+        const uint8_t g = state.clipG(pad);
+        const uint8_t b = state.clipB(pad);
+        guiInterface.sendClipState(pad % GRID_TRACKS, pad / GRID_TRACKS, state.clipState(pad),
+                                   r >> 7, r & 0x7F, g >> 7, g & 0x7F, b >> 7, b & 0x7F);
+    }
+
+    for (uint8_t track = 0; track < M::TRACKS; ++track) {
+        if (state.isValid(M::TRACK_COLOR, track)) {
+            guiInterface.sendTrackColor(track, state.trackR(track), state.trackG(track), state.trackB(track));
+        }
+        if (state.isValid(M::TRACK_VOLUME, track)) {
+            guiInterface.sendMixerVolume(track, state.volume(track) >> 7, state.volume(track) & 0x7F);
+        }
+        if (state.isValid(M::TRACK_PAN, track)) {
+            guiInterface.sendMixerPan(track, state.pan(track) >> 7, state.pan(track) & 0x7F);
+        }
+        for (uint8_t send = 0; send < M::SENDS; ++send) {
+            if (state.hasSend(track, send)) {
+                const uint16_t value = state.send(track, send);
+                guiInterface.sendMixerSend(track, send, value >> 7, value & 0x7F);
+            }
+        }
+        if (state.isValid(M::TRACK_MUTE, track)) {
+            guiInterface.sendMixerMute(track, state.mute(track));
+        }
+        if (state.isValid(M::TRACK_SOLO, track)) {
+            guiInterface.sendMixerSolo(track, state.solo(track));
+        }
+        if (state.isValid(M::TRACK_ARM, track)) {
+            guiInterface.sendMixerArm(track, state.arm(track));
+        }
+    }
+
+    for (uint8_t scene = 0; scene < M::SCENES; ++scene) {
+        if (state.isValid(M::SCENE_COLOR, scene)) {
+            guiInterface.sendSceneColor(scene, state.sceneR(scene), state.sceneG(scene), state.sceneB(scene));
+        }
+        if (state.isValid(M::SCENE_STATE, scene)) {
+            guiInterface.sendSceneState(scene, state.sceneState(scene));
+        }
+        if (state.isValid(M::SCENE_TRIGGERED, scene)) {
+            guiInterface.sendSceneTriggered(scene, state.sceneTriggered(scene));
+        }
+    }
+
+    if (state.isValid(M::TEMPO, 0)) {
+        guiInterface.sendBPM(static_cast<float>(state.tempo()) / 10.0f);
+    }
+    if (state.isValid(M::TRANSPORT, 0)) {
+        guiInterface.sendTransportState(state.playing(), state.recording());
+    }
+    if (state.isValid(M::SELECTED_TRACK, 0)) {
+        guiInterface.sendSelectedTrack(state.selectedTrack());
+    }
+    guiInterface.endBatch();
+
+    // Everything pending for the GUI just went out
+    for (uint8_t f = 0; f < M::FIELD_COUNT; ++f) {
+        state.takeDirty(M::GUI, static_cast<M::Field>(f));
+    }
+}
+
+// Slots: ring tracks, then pads, then ring scenes; -1 outside the ring
+int LiveController::nameSlot(NameKind kind, uint8_t index, uint8_t scene) {
+    switch (kind) {
+        case NAME_TRACK:
+            return index < GRID_TRACKS ? index : -1;
+        case NAME_CLIP:
+            return index < GRID_TRACKS && scene < GRID_SCENES ? GRID_TRACKS + scene * GRID_TRACKS + index : -1;
+        default:
+            return index < GRID_SCENES ? GRID_TRACKS + TOTAL_KEYS + index : -1;
+    }
+}
+
+LiveController::NameKind LiveController::nameSlotKind(uint8_t slot, uint8_t& index, uint8_t& scene) {
+    scene = 0;
+    if (slot >= GRID_TRACKS + TOTAL_KEYS) {
+        index = slot - GRID_TRACKS - TOTAL_KEYS;
+        return NAME_SCENE;
+    }
+    if (slot >= GRID_TRACKS) {
+        index = (slot - GRID_TRACKS) % GRID_TRACKS;
+        scene = (slot - GRID_TRACKS) / GRID_TRACKS;
+        return NAME_CLIP;
+    }
+    index = slot;
+    return NAME_TRACK;
+}
+
+// GUI frame bytes of a name sent as a string: header, slot bytes and name
+uint16_t LiveController::nameStringBytes(NameKind kind, uint8_t length) {
+    return BinaryProtocol::HEADER_SIZE + (kind == NAME_CLIP ? 2 : 1) + length;
+}
+
+void LiveController::setName(NameKind kind, uint8_t index, uint8_t scene, const char* name, size_t length) {
+    const int slot = nameSlot(kind, index, scene);
+    const uint16_t id = slot < 0 ? NamePool::NONE : namePool.intern(name, static_cast<uint8_t>(length));
+    if (id == NamePool::NONE) {
+        // Outside the ring, or the pool is full of names on show: as a string
+        if (slot >= 0) {
+            namePool.release(nameId[slot]);
+            nameId[slot] = nameSentId[slot] = NamePool::NONE;
+        }
+        sendNameString(kind, index, scene, name, length);
+        return;
+    }
+    if (id != nameId[slot]) {
+        namePool.retain(id);
+        namePool.release(nameId[slot]);
+        nameId[slot] = id;
+    }
+    if (id == nameSentId[slot]) {
+        nameDirty &= ~(1ULL << slot);
+        nameStats.skipped++;
+        nameStats.bytesSaved += nameStringBytes(kind, static_cast<uint8_t>(length));
+        return;
+    }
+    nameDirty |= 1ULL << slot;
+    sendNameToGUI(static_cast<uint8_t>(slot));
+}
+
+void LiveController::sendNameString(NameKind kind, uint8_t index, uint8_t scene, const char* name, size_t length) {
+    switch (kind) {
+        case NAME_TRACK: guiInterface.sendTrackName(index, name, length); break;
+        case NAME_CLIP: guiInterface.sendClipName(index, scene, name, length); break;
+        case NAME_SCENE: guiInterface.sendSceneName(index, name, length); break;
+    }
+}
+
+// Stays dirty while the GUI is away; replayStateToGUI() sends it later
+void LiveController::sendNameToGUI(uint8_t slot) {
+    uint8_t length = 0;
+    const char* text = namePool.text(nameId[slot], length);
+    if (!guiInterface.isConnected() || !text) {
+        return;
+    }
+    uint8_t index = 0;
+    uint8_t scene = 0;
+    const NameKind kind = nameSlotKind(slot, index, scene);
+    // [kind, index, scene, id_hi, id_lo]
+    const uint16_t refBytes = BinaryProtocol::HEADER_SIZE + 5;
+
+    if (guiInterface.getLinkMode().nameIds) {
+        if (!namePool.defined(nameId[slot])) {
+            guiInterface.sendNameDefine(nameId[slot], text, length);
+            namePool.markDefined(nameId[slot]);
+            nameStats.defines++;
+        } else if (nameStringBytes(kind, length) > refBytes) {
+            nameStats.bytesSaved += nameStringBytes(kind, length) - refBytes;
         }
+        guiInterface.sendNameRef(kind, index, scene, nameId[slot]);
+    } else {
+        sendNameString(kind, index, scene, text, length);
+    }
+    nameSentId[slot] = nameId[slot];
+    nameDirty &= ~(1ULL << slot);
+    nameStats.sent++;
+}
+
+// all: the GUI lost its copy (handshake); otherwise only dirty names go
+void LiveController::sendNamesToGUI(bool all) {
+    if (!guiInterface.isConnected()) {
+        return;
+    }
+    if (all) {
+        namePool.clearDefined();
     }
 
-    for (int pad = 0; pad < TOTAL_KEYS; ++pad) {
-        if (clipNameValid[pad] && clipNameCache[pad][0] != '\0') {
-            uint8_t track = pad % GRID_TRACKS;
-            uint8_t scene = pad / GRID_TRACKS;
-            guiInterface.sendClipName(track, scene, clipNameCache[pad]);
+    guiInterface.beginBatch();
+    for (uint8_t slot = 0; slot < NAME_SLOTS; ++slot) {
+        // Empty names go too: a cleared slot must not keep its old name
+        if (all || (nameDirty & (1ULL << slot))) {
+            sendNameToGUI(slot);
         }
     }
+    guiInterface.endBatch();
 }
@@ -2,6 +2,16 @@
 
 #include "shared/Config.h"
 #include <Arduino.h> // For byte type
+#include "LiveCommandTable.h"
+#include "LiveSysExAssembler.h"
+#include "LiveSequenceTracker.h"
+#include "LiveCommandProfiler.h"
+#include "RingNavigator.h"
+#include "LiveMeterStage.h"
+#include "ClipPositionEstimator.h"
+#include "LiveStateModel/LiveStateModel.h"
+#include "LiveStateModel/ClipPrefetchCache.h"
+#include "LiveStateModel/NamePool.h"
 
 class LiveController {
 public:
@@ -10,7 +20,7 @@ public:
     void begin();
     void read();
     
-    void processMIDI(); // Process incoming MIDI for LED feedback
+    void processMIDI(); // Drain incoming MIDI for up to the loop's time budget
     void updateClipState(int padIndex, int state); // Update pad LED based on Ableton state
     
     // MIDI utility functions
@@ -19,10 +29,69 @@ public:
     void sendSysExToAbleton(uint8_t command, const uint8_t* data, int dataLength, bool requireLiveConnection = true);
     void sendHandshakeResponse();
     void waitForLiveHandshake(); // Wait for Live to initiate handshake
-    void resendCachedNamesToGUI();
+    void replayStateToGUI(); // Names and the state mirror, e.g. after a GUI handshake
+    void requestResync(uint8_t areas); // LiveSequenceTracker::Area bits, sent from read()
+    void moveRing(int trackDelta, int sceneDelta); // Merged into one CMD_RING_POSITION, drawn from the clip cache
     
     // System state management
     bool isLiveConnected() { return liveConnected; }
+    const LiveCommand::Stats& getDispatchStats() const { return dispatchStats; }
+    const LiveCommandProfiler& getProfiler() const { return profiler; }
+    void resetProfiler() { profiler.reset(); }
+
+    struct MidiDrainStats {
+        uint32_t drains = 0;          // processMIDI() calls that read anything
+        uint32_t messages = 0;
+        uint32_t budgetExhausted = 0; // Drains that stopped on time, leaving a backlog in USB
+        uint32_t throttled = 0;       // Drains run on a reduced budget
+        uint32_t maxTxBacklog = 0;    // Largest M4 TX queue seen at drain start, bytes
+        uint16_t maxMessages = 0;     // Most messages in one drain
+        uint32_t maxDrainUs = 0;      // Worst-case drain time
+    };
+    const MidiDrainStats& getDrainStats() const { return drainStats; }
+    const LiveSysExAssembler::Stats& getSysExStats() const { return sysexAssembler.getStats(); }
+
+    struct ResyncStats {
+        uint32_t requests = 0;        // CMD_RESYNC_REQUEST frames sent
+        uint32_t rejectedFrames = 0;  // Live frames lost in reassembly with a known command
+        uint8_t lastAreas = 0;
+    };
+    // Clip and mixer updates are merged in the state mirror and flushed at
+    // LIVE_GUI_FLUSH_HZ / LIVE_LED_FLUSH_HZ; merged counts live in the model
+    struct CoalesceStats {
+        uint32_t guiForwarded = 0;   // Messages sent by GUI flushes
+        uint32_t ledForwarded = 0;   // Pad colors and clip states sent by LED flushes
+        uint32_t guiFlushes = 0;
+        uint32_t ledFlushes = 0;
+    };
+    const CoalesceStats& getCoalesceStats() const { return coalesceStats; }
+
+    struct PrefetchStats {
+        uint32_t requests = 0;      // CMD_CLIP_WINDOW_REQUEST frames sent
+        uint32_t windows = 0;       // CMD_CLIP_WINDOW frames cached
+        uint32_t previews = 0;      // Ring moves drawn from the cache
+        uint32_t previewMisses = 0; // Ring moves left to Live (window not cached)
+        uint32_t corrections = 0;   // Pads Live changed after a preview
+    };
+    const PrefetchStats& getPrefetchStats() const { return prefetchStats; }
+    const RingNavigator::Stats& getRingNavStats() const { return ringNav.getStats(); }
+    const LiveMeterStage::Stats& getMeterStats() const { return meters.getStats(); }
+    const ClipPositionEstimator::Stats& getPositionStats() const { return positions.getStats(); }
+
+    struct NameStats {
+        uint32_t sent = 0;        // Track, clip and scene names sent to the GUI
+        uint32_t defines = 0;     // Of those, strings sent as CMD_NAME_DEFINE
+        uint32_t skipped = 0;     // Names not sent again because the GUI has them
+        uint32_t bytesSaved = 0;  // GUI frame bytes saved by skips and by IDs
+    };
+    const NameStats& getNameStats() const { return nameStats; }
+    const NamePool& getNamePool() const { return namePool; }
+
+    const LiveSequenceTracker::Stats& getSequenceStats() const { return sequenceTracker.getStats(); }
+    const ResyncStats& getResyncStats() const { return resyncStats; }
+
+    // Mirror of Live's state; faders, encoders and the GUI replay read it
+    const LiveStateModel& getState() const { return state; }
 
 private:
     // System state variables
@@ -33,11 +102,50 @@ private:
     unsigned long gridRequestLastAttempt = 0; // Last time we requested grid
     uint8_t gridRequestRetries = 0;           // Number of grid requests sent
 
-    // SysEx buffer for handling fragmented messages
-    static const int SYSEX_BUFFER_SIZE = 64;
-    uint8_t sysexBuffer[SYSEX_BUFFER_SIZE];
-    int sysexBufferIndex = 0;
-    bool sysexInProgress = false;
+    LiveStateModel state;
+
+    // SysEx from USB, reassembled from the stack's pieces
+    LiveSysExAssembler sysexAssembler;
+    static void handleUsbSysEx(const uint8_t* data, uint16_t length, bool last);
+    void feedSysEx(const uint8_t* data, uint16_t length, bool last);
+    void handleAssembledSysEx();
+    void dispatchLiveCommand(uint8_t command, const uint8_t* payload, uint16_t payloadLen);
+
+    // SEQ tracking and resync of the areas hit by lost frames
+    LiveSequenceTracker sequenceTracker;
+    ResyncStats resyncStats;
+    uint8_t pendingResync = 0;
+    unsigned long lastLossAt = 0;
+    unsigned long lastResyncAt = 0;
+    void flushResync(unsigned long now);
+
+    // Ring moves, and the clip states around the ring to draw them before Live answers
+    RingNavigator ringNav;
+    ClipPrefetchCache clipCache;
+    PrefetchStats prefetchStats;
+    bool previewCheck = false;     // Count what Live's next ring clips change
+    unsigned long lastPrefetchAt = 0;
+    void sendRingPosition();
+    bool previewRing();
+    void cachePad(uint8_t pad);
+    void cacheColorWhileMoving(uint8_t pad, uint8_t r, uint8_t g, uint8_t b);
+    void prefetchAroundRing(unsigned long now);
+
+    // Track meters, decayed and sent as one frame at LIVE_METER_HZ
+    LiveMeterStage meters;
+    uint32_t lastMeterFrameUs = 0;
+    void flushMeters();
+
+    // Clip and song positions, extrapolated and sent as one frame at LIVE_POSITION_HZ
+    ClipPositionEstimator positions;
+    uint32_t lastPositionFrameUs = 0;
+    void flushPositions();
+
+    CoalesceStats coalesceStats;
+    uint32_t lastGuiFlushUs = 0;
+    uint32_t lastLedFlushUs = 0;
+    void flushGui();
+    void flushLeds();
     
     // All I2C-related member variables and functions have been removed
     // to match the UART-based architecture.
@@ -45,21 +153,74 @@ private:
     void handleKeyRelease(int board, int key);
     int getBoardFromKey(int globalKey);
     int getLocalKeyFromGlobal(int globalKey);
-    void processSysEx(byte* data, int length);
-    void processHandshakeMessage(uint8_t* data, int length);
-    void broadcastCachedNamesToGUI();
+    void processSysEx(const uint8_t* data, int length);
+    uint32_t midiDrainBudgetUs();
+    MidiDrainStats drainStats;
+    void processHandshakeMessage(const uint8_t* data, int length);
+
+    // Ring track, clip and scene names: one slot each holding a NamePool
+    // ID. A slot is sent again only when its ID differs from the last one
+    // sent (dirty bit); all of them on a GUI handshake or a names resync.
+    // GUIs that negotiated CAP_NAME_IDS get each string once and IDs after.
+    enum NameKind : uint8_t { NAME_TRACK = 0, NAME_CLIP = 1, NAME_SCENE = 2 }; // CMD_NAME_REF kind
+    static constexpr uint8_t NAME_SLOTS = GRID_TRACKS + TOTAL_KEYS + GRID_SCENES;
+    static_assert(NAME_SLOTS <= 64, "one dirty bit per name slot");
+    static_assert(NamePool::ENTRIES > NAME_SLOTS, "names on show must leave room to evict");
+    NamePool namePool;
+    NameStats nameStats;
+    uint16_t nameId[NAME_SLOTS];
+    uint16_t nameSentId[NAME_SLOTS];
+    uint64_t nameDirty = 0;  // Bit per slot
+    static int nameSlot(NameKind kind, uint8_t index, uint8_t scene);
+    static NameKind nameSlotKind(uint8_t slot, uint8_t& index, uint8_t& scene);
+    static uint16_t nameStringBytes(NameKind kind, uint8_t length);
+    void setName(NameKind kind, uint8_t index, uint8_t scene, const char* name, size_t length);
+    void sendNameString(NameKind kind, uint8_t index, uint8_t scene, const char* name, size_t length);
+    void sendNameToGUI(uint8_t slot);
+    void sendNamesToGUI(bool all);
+
+    // Live SysEx commands are routed through commandTable (built in
+    // LiveController.cpp); handlers get payloads already length-checked.
+    using CommandTable = LiveCommandTable<LiveController>;
+    static constexpr CommandTable buildCommandTable();
+    static const CommandTable commandTable;
+    LiveCommand::Stats dispatchStats;
+    LiveCommandProfiler profiler;
+
+    void onHandshake(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onHandshakeReply(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onDisconnect(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onGridUpdate(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onGridSinglePad(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onClipState(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onClipName(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onRingMetadata(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onRingClips(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onRingPosition(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onClipWindow(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSceneName(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSceneColor(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSceneState(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSceneTriggered(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTrackName(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTrackColor(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onMixerLevel(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onMixerSend(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onMixerToggle(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTrackMeter(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onClipPosition(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onClipLength(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSongPosition(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSelectedTrack(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTrackSelect(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onSceneSelect(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onDetailClip(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTempo(uint8_t command, const uint8_t* payload, uint16_t length);
+    void onTransport(uint8_t command, const uint8_t* payload, uint16_t length);
 
 public:
     bool isHardwareReady() const { return hardwareReady; }
     void setHardwareReady(bool v) { hardwareReady = v; }
     void setLiveConnected(bool v) { liveConnected = v; }
     bool hasSeenGrid() const { return gridSeen; }
-
-private:
-    static constexpr uint8_t MAX_TRACK_NAME_LEN = 64;
-    static constexpr uint8_t MAX_CLIP_NAME_LEN = 64;
-    char trackNameCache[GRID_TRACKS][MAX_TRACK_NAME_LEN];
-    bool trackNameValid[GRID_TRACKS] = {false};
-    char clipNameCache[TOTAL_KEYS][MAX_CLIP_NAME_LEN];
-    bool clipNameValid[TOTAL_KEYS] = {false};
 };
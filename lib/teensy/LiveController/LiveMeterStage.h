@@ -0,0 +1,126 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/Config.h"
+
+// Track meters from Live (CMD_TRACK_METER, ~20 per second per track),
+// reduced to what a meter on the GUI needs: per track a level that rises
+// with each reading and falls towards the last one at LIVE_METER_DECAY per
+// frame (a steady signal stays put instead of pumping), and
+// a peak held for LIVE_METER_PEAK_HOLD_MS. tick() runs at LIVE_METER_HZ and
+// packs the visible tracks into one frame, returned only when some value
+// moved by LIVE_METER_THRESHOLD or more (or reached zero) since the last
+// frame sent, so quiet or steady tracks cost nothing on the GUI link.
+//
+// Frame: [first_track, count] + count × [level, peak] (7-bit).
+class LiveMeterStage {
+public:
+    static constexpr uint8_t TRACKS = 32;  // Absolute track index, as in LiveStateModel
+    static constexpr uint8_t MAX_VISIBLE = GRID_TRACKS;
+    static constexpr uint8_t MAX_FRAME = 2 + MAX_VISIBLE * 2;
+
+    struct Stats {
+        uint32_t inputs = 0;    // CMD_TRACK_METER readings
+        uint32_t frames = 0;    // Frames built (sent when the GUI is connected)
+        uint32_t unchanged = 0; // Ticks with nothing worth sending
+    };
+
+    void input(uint8_t track, uint8_t value, uint32_t nowMs) {
+        if (track >= TRACKS) {
+            return;
+        }
+        stats.inputs++;
+        value &= 0x7F;
+        reading[track] = value;
+        if (value > level[track]) {
+            level[track] = value; // Rises at once, falls by decay
+        }
+        if (value >= peak[track]) {
+            peak[track] = value;
+            peakAt[track] = nowMs;
+        }
+    }
+
+    // Tracks the frame covers (the session ring's)
+    void setVisible(uint8_t firstTrack, uint8_t count) {
+        if (count > MAX_VISIBLE) {
+            count = MAX_VISIBLE;
+        }
+        if (firstTrack != visibleFirst || count != visibleCount) {
+            visibleFirst = firstTrack;
+            visibleCount = count;
+            forceFrame = true;
+        }
+    }
+
+    // Advances decay and hold by one frame; returns the frame length when
+    // the visible meters should be sent, 0 otherwise.
+    uint8_t tick(uint32_t nowMs, uint8_t* out) {
+        for (uint8_t track = 0; track < TRACKS; ++track) {
+            const uint8_t decayed = level[track] > LIVE_METER_DECAY ? level[track] - LIVE_METER_DECAY : 0;
+            level[track] = decayed > reading[track] ? decayed : reading[track];
+            if (nowMs - peakAt[track] >= LIVE_METER_PEAK_HOLD_MS) {
+                const uint8_t fallen = peak[track] > LIVE_METER_DECAY ? peak[track] - LIVE_METER_DECAY : 0;
+                peak[track] = fallen > level[track] ? fallen : level[track];
+            }
+        }
+
+        bool changed = forceFrame;
+        for (uint8_t i = 0; i < visibleCount && !changed; ++i) {
+            const uint8_t track = visibleFirst + i;
+            changed = track < TRACKS &&
+                      (moved(level[track], sentLevel[track]) || moved(peak[track], sentPeak[track]));
+        }
+        if (!changed) {
+            stats.unchanged++;
+            return 0;
+        }
+
+        forceFrame = false;
+        out[0] = visibleFirst & 0x7F;
+        out[1] = visibleCount;
+        uint8_t length = 2;
+        for (uint8_t i = 0; i < visibleCount; ++i) {
+            const uint8_t track = visibleFirst + i;
+            const bool known = track < TRACKS;
+            out[length++] = known ? level[track] : 0;
+            out[length++] = known ? peak[track] : 0;
+            if (known) {
+                sentLevel[track] = level[track];
+                sentPeak[track] = peak[track];
+            }
+        }
+        stats.frames++;
+        return length;
+    }
+
+    // The GUI lost its copy (reconnect)
+    void resend() { forceFrame = true; }
+
+    // Live went away: meters drop to zero in the next frame
+    void reset() {
+        memset(reading, 0, sizeof(reading));
+        memset(level, 0, sizeof(level));
+        memset(peak, 0, sizeof(peak));
+        forceFrame = true;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    static bool moved(uint8_t value, uint8_t sent) {
+        const uint8_t delta = value > sent ? value - sent : sent - value;
+        return delta >= LIVE_METER_THRESHOLD || (value == 0 && sent != 0);
+    }
+
+    Stats stats;
+    uint8_t reading[TRACKS] = {};  // Last value from Live
+    uint8_t level[TRACKS] = {};
+    uint8_t peak[TRACKS] = {};
+    uint32_t peakAt[TRACKS] = {};
+    uint8_t sentLevel[TRACKS] = {};
+    uint8_t sentPeak[TRACKS] = {};
+    uint8_t visibleFirst = 0;
+    uint8_t visibleCount = MAX_VISIBLE;
+    bool forceFrame = false;
+};
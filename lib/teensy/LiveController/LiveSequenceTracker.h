@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Arduino.h>
+#include "MidiCommands.h"
+
+// Follows the 7-bit SEQ field of Live frames in both directions. Inbound,
+// a jump in SEQ means frames were lost on the way (USB drops, truncated
+// SysEx); the tracker reports how many and which areas of state the
+// neighbouring frames belong to, so only those are asked for again with
+// CMD_RESYNC_REQUEST. Outbound, it numbers the frames sent to Live.
+//
+// SEQ wraps at 128, so a loss of exactly 128 frames cannot be seen.
+class LiveSequenceTracker {
+public:
+    // Areas of Live state that can be resent on their own (CMD_RESYNC_REQUEST payload)
+    enum Area : uint8_t {
+        AREA_GRID = 0x01,      // Clip states/colors and scene states in the ring
+        AREA_NAMES = 0x02,     // Track, scene and clip names and colors
+        AREA_MIXER = 0x04,     // Volume, pan, sends, mute/solo/arm, selected track
+        AREA_TRANSPORT = 0x08, // Play/record and tempo
+        AREA_ALL = 0x0F
+    };
+
+    struct Stats {
+        uint32_t inFrames = 0;
+        uint32_t outFrames = 0;
+        uint32_t gaps = 0;          // Jumps in the inbound SEQ
+        uint32_t missing = 0;       // Frames lost across all gaps
+        uint32_t duplicates = 0;    // Same SEQ twice in a row
+        uint8_t largestGap = 0;
+    };
+
+    // Area a command's data belongs to; 0 for commands nobody keeps
+    static uint8_t areaOf(uint8_t command) {
+        switch (command) {
+            case CMD_GRID_UPDATE:
+            case CMD_GRID_SINGLE_PAD:
+            case CMD_CLIP_STATE:
+            case CMD_SESSION_RING_CLIPS:
+            case CMD_CLIP_WINDOW:
+            case CMD_SCENE_STATE:
+            case CMD_SCENE_IS_TRIGGERED:
+                return AREA_GRID;
+            case CMD_CLIP_NAME:
+            case CMD_TRACK_NAME:
+            case CMD_TRACK_COLOR:
+            case CMD_SCENE_NAME:
+            case CMD_SCENE_COLOR:
+            case CMD_SESSION_RING_METADATA:
+                return AREA_NAMES;
+            case CMD_MIXER_VOLUME:
+            case CMD_MIXER_PAN:
+            case CMD_MIXER_SEND:
+            case CMD_MIXER_MUTE:
+            case CMD_MIXER_SOLO:
+            case CMD_MIXER_ARM:
+            case CMD_SELECTED_TRACK:
+                return AREA_MIXER;
+            case CMD_TRANSPORT_PLAY:
+            case CMD_TRANSPORT_RECORD:
+            case CMD_TRANSPORT_TEMPO:
+                return AREA_TRANSPORT;
+            default:
+                return 0;
+        }
+    }
+
+    // An inbound frame arrived. Returns the areas to resync (0 when the
+    // frame followed its predecessor). A gap is blamed on the areas of the
+    // frames on either side of it, since Live sends state in runs of one
+    // kind; when neither side holds state, everything is asked for.
+    uint8_t received(uint8_t command, uint8_t sequence) {
+        stats.inFrames++;
+        sequence &= 0x7F;
+        const bool first = !synced;
+        const uint8_t previousCommand = lastCommand;
+        const uint8_t expected = static_cast<uint8_t>((lastSequence + 1) & 0x7F);
+        synced = true;
+        lastSequence = sequence;
+        lastCommand = command;
+        if (first || sequence == expected) {
+            return 0;
+        }
+
+        const uint8_t lost = static_cast<uint8_t>((sequence - expected) & 0x7F);
+        if (lost == 0x7F) {
+            stats.duplicates++; // sequence == previous one
+            return 0;
+        }
+        stats.gaps++;
+        stats.missing += lost;
+        if (lost > stats.largestGap) {
+            stats.largestGap = lost;
+        }
+        const uint8_t areas = areaOf(previousCommand) | areaOf(command);
+        return areas ? areas : static_cast<uint8_t>(AREA_ALL);
+    }
+
+    uint8_t nextOutbound() {
+        stats.outFrames++;
+        outSequence = static_cast<uint8_t>((outSequence + 1) & 0x7F);
+        return outSequence;
+    }
+
+    // New session (handshake or disconnect): Live restarts its counter
+    void reset() {
+        synced = false;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    Stats stats;
+    bool synced = false;
+    uint8_t lastSequence = 0;
+    uint8_t lastCommand = 0;
+    uint8_t outSequence = 0;
+};
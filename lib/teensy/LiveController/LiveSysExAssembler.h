@@ -0,0 +1,221 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/Config.h"
+
+// Reassembles SysEx messages delivered in pieces by the USB MIDI stack, so a
+// Live frame is not limited by the driver's SysEx buffer.
+//
+// Live frames are validated as bytes arrive:
+//   F0 7F 00 7F CMD SEQ LEN_MSB LEN_LSB PAYLOAD... CHK F7
+// The length and checksum are checked on the fly, and a data byte with its
+// top bit set is rejected too (except CMD: the bulk IDs 0x9A-0x9C). A bad frame is rejected at its first wrong
+// byte, and everything up to the next F0 is dropped. Any other SysEx is
+// collected as a passthrough message. Payloads can be as long as the 14-bit
+// LEN field allows. Storage is supplied by the owner so the buffer can live
+// in a memory pool (DMAMEM on the Teensy).
+class LiveSysExAssembler {
+public:
+    static constexpr uint8_t HEADER_SIZE = 8;   // F0 7F 00 7F CMD SEQ LEN LEN
+    static constexpr uint8_t TRAILER_SIZE = 2;  // CHK F7
+    static constexpr uint16_t MAX_PAYLOAD = 0x3FFF;
+    static constexpr uint16_t MAX_FRAME = HEADER_SIZE + MAX_PAYLOAD + TRAILER_SIZE;
+
+    enum class Reason : uint8_t {
+        NONE,
+        BAD_START,    // Bytes outside F0 ... F7
+        BAD_BYTE,     // Status byte inside a Live frame
+        BAD_LENGTH,   // F7 early or late for LEN
+        BAD_CHECKSUM,
+        TRUNCATED,    // Stream said complete before F7
+        TOO_LARGE     // Message larger than the buffer
+    };
+
+    struct Stats {
+        uint32_t liveFrames = 0;
+        uint32_t passthrough = 0;   // Complete non-Live SysEx
+        uint32_t rejected = 0;
+        uint32_t chunks = 0;        // Pieces fed by the USB stack
+        uint16_t largestFrame = 0;
+    };
+
+    LiveSysExAssembler(uint8_t* storage, uint16_t capacity)
+        : buffer(storage), capacity(capacity) {}
+
+    // Feed one piece; last marks the end of the message as reported by the
+    // stack. onMessage() runs for each message completed, while message()
+    // and the frame accessors describe it. Returns how many messages were
+    // rejected during this piece.
+    template <typename Handler>
+    uint8_t feed(const uint8_t* data, uint16_t length, bool last, Handler&& onMessage) {
+        stats.chunks++;
+        const uint32_t rejectedBefore = stats.rejected;
+        for (uint16_t i = 0; i < length; ++i) {
+            if (push(data[i]) == Status::COMPLETE) {
+                onMessage();
+            }
+        }
+        if (last) {
+            if (state == State::LIVE || state == State::PASSTHROUGH) {
+                reject(Reason::TRUNCATED);
+            }
+            state = State::IDLE;
+        }
+        return static_cast<uint8_t>(stats.rejected - rejectedBefore);
+    }
+
+    void reset() {
+        state = State::IDLE;
+        count = 0;
+    }
+
+    const uint8_t* message() const { return buffer; }
+    uint16_t length() const { return count; }
+    bool isLiveFrame() const { return live; }
+
+    // Valid after a COMPLETE Live frame
+    uint8_t command() const { return buffer[4]; }
+    uint8_t sequence() const { return buffer[5]; }
+    const uint8_t* payload() const { return &buffer[HEADER_SIZE]; }
+    uint16_t payloadLength() const { return payloadLen; }
+
+    Reason lastRejectReason() const { return lastReason; }
+    // Command of the last rejected Live frame, when its header got through
+    bool lastRejectCommand(uint8_t& command) const {
+        command = rejectCommand;
+        return rejectHadCommand;
+    }
+    static const char* reasonName(Reason reason) {
+        switch (reason) {
+            case Reason::BAD_START: return "no F0";
+            case Reason::BAD_BYTE: return "status byte in frame";
+            case Reason::BAD_LENGTH: return "length mismatch";
+            case Reason::BAD_CHECKSUM: return "bad checksum";
+            case Reason::TRUNCATED: return "truncated";
+            case Reason::TOO_LARGE: return "too large";
+            default: return "none";
+        }
+    }
+    const Stats& getStats() const { return stats; }
+
+private:
+    enum class State : uint8_t { IDLE, LIVE, PASSTHROUGH, SKIP };
+    enum class Status : uint8_t { PENDING, COMPLETE, REJECTED };
+
+    Status push(uint8_t byte) {
+        if (byte == SYSEX_START) {
+            // A new message always restarts, even over an unfinished one
+            const bool dropped = state == State::LIVE || state == State::PASSTHROUGH;
+            if (dropped) {
+                reject(Reason::TRUNCATED);
+            }
+            state = State::LIVE;
+            live = true;
+            count = 0;
+            checksum = 0;
+            buffer[count++] = byte;
+            return dropped ? Status::REJECTED : Status::PENDING;
+        }
+
+        switch (state) {
+            case State::IDLE:
+                return reject(Reason::BAD_START);
+            case State::SKIP:
+                if (byte == SYSEX_END) {
+                    state = State::IDLE;
+                }
+                return Status::PENDING;
+            case State::PASSTHROUGH:
+                return pushPassthrough(byte);
+            case State::LIVE:
+                break;
+        }
+
+        // Live header: anything else from byte 1..3 is someone else's SysEx
+        static const uint8_t LIVE_HEADER[4] = {SYSEX_START, MANUFACTURER_ID, DEVICE_ID, 0x7F};
+        if (count < 4) {
+            if (byte != LIVE_HEADER[count]) {
+                state = State::PASSTHROUGH;
+                live = false;
+                return pushPassthrough(byte);
+            }
+            buffer[count++] = byte;
+            return Status::PENDING;
+        }
+
+        const uint16_t expected = count >= HEADER_SIZE
+            ? static_cast<uint16_t>(HEADER_SIZE + payloadLen + TRAILER_SIZE)
+            : MAX_FRAME;
+        if (byte == SYSEX_END) {
+            if (count != expected - 1) {
+                return reject(Reason::BAD_LENGTH);
+            }
+            buffer[count++] = byte;
+            state = State::IDLE;
+            stats.liveFrames++;
+            noteSize();
+            return Status::COMPLETE;
+        }
+        if ((byte & 0x80) && count != 4) {
+            return reject(Reason::BAD_BYTE); // Only CMD may use the top bit (bulk IDs)
+        }
+        if (count >= expected - 1) {
+            return reject(Reason::BAD_LENGTH); // Where F7 should be
+        }
+        if (count >= capacity) {
+            return reject(Reason::TOO_LARGE);
+        }
+
+        buffer[count++] = byte;
+        if (count == 5 || count == 6 || (count > HEADER_SIZE && count < expected - 1)) {
+            checksum ^= byte; // CMD, SEQ and payload
+        } else if (count == HEADER_SIZE) {
+            payloadLen = static_cast<uint16_t>((buffer[6] << 7) | buffer[7]);
+        } else if (count == expected - 1 && (checksum & 0x7F) != byte) {
+            return reject(Reason::BAD_CHECKSUM);
+        }
+        return Status::PENDING;
+    }
+
+    Status pushPassthrough(uint8_t byte) {
+        if (count >= capacity) {
+            return reject(Reason::TOO_LARGE);
+        }
+        buffer[count++] = byte;
+        if (byte != SYSEX_END) {
+            return Status::PENDING;
+        }
+        state = State::IDLE;
+        stats.passthrough++;
+        noteSize();
+        return Status::COMPLETE;
+    }
+
+    Status reject(Reason reason) {
+        // The rest of the message is dropped up to its F7 (or the next F0)
+        rejectHadCommand = state == State::LIVE && count > 4;
+        rejectCommand = rejectHadCommand ? buffer[4] : 0;
+        state = reason == Reason::TRUNCATED ? State::IDLE : State::SKIP;
+        lastReason = reason;
+        stats.rejected++;
+        return Status::REJECTED;
+    }
+
+    void noteSize() {
+        if (count > stats.largestFrame) {
+            stats.largestFrame = count;
+        }
+    }
+
+    uint8_t* buffer;
+    uint16_t capacity;
+    uint16_t count = 0;
+    uint16_t payloadLen = 0;
+    uint8_t checksum = 0;
+    bool live = false;
+    bool rejectHadCommand = false;
+    uint8_t rejectCommand = 0;
+    State state = State::IDLE;
+    Reason lastReason = Reason::NONE;
+    Stats stats;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Walks the entries of CMD_SESSION_RING_METADATA:
+//   [num_tracks] [len, name..., R, G, B] × num_tracks
+//   [num_scenes] [len, name..., R, G, B] × num_scenes
+// A name longer than the caller's buffer is cut to fit, but the reader
+// always moves past all of its bytes, so the colours and the entries after
+// it are read from where Live put them.
+class RingMetadataReader {
+public:
+    RingMetadataReader(const uint8_t* payload, uint16_t length)
+        : payload(payload), length(length) {}
+
+    // Entry count byte; false at the end of the payload
+    bool count(uint8_t& value) {
+        if (offset >= length) {
+            return false;
+        }
+        value = payload[offset++] & 0x7F;
+        return true;
+    }
+
+    // One entry: the name NUL-terminated in name[capacity] (nameLen bytes
+    // kept) and its 7-bit colour. False when the payload ends inside it.
+    bool entry(char* name, uint8_t capacity, uint8_t& nameLen, uint8_t& r, uint8_t& g, uint8_t& b) {
+        if (offset >= length || capacity == 0) {
+            return false;
+        }
+        const uint8_t fullLen = payload[offset] & 0x7F;
+        if (offset + 1 + fullLen + 3 > length) {
+            return false; // name + RGB
+        }
+        offset++;
+        nameLen = fullLen < capacity - 1 ? fullLen : static_cast<uint8_t>(capacity - 1);
+        for (uint8_t i = 0; i < nameLen; i++) {
+            name[i] = static_cast<char>(payload[offset + i] & 0x7F);
+        }
+        name[nameLen] = '\0';
+        offset += fullLen;
+        r = payload[offset++] & 0x7F;
+        g = payload[offset++] & 0x7F;
+        b = payload[offset++] & 0x7F;
+        return true;
+    }
+
+private:
+    const uint8_t* payload;
+    uint16_t length;
+    uint16_t offset = 0;
+};
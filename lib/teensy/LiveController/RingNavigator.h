@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/Config.h"
+
+// Session ring navigation towards Live. Presses only move a target; the
+// first press opens a LIVE_RING_NAV_MERGE_MS window and, when it closes,
+// the target goes to Live as one absolute CMD_RING_POSITION, so a bank
+// jump or a burst of presses costs one round trip and one grid push
+// instead of one per step.
+//
+// The target stays ahead of the position Live reports until Live answers
+// the position sent (or LIVE_CLIP_PREVIEW_TIMEOUT_MS passes without an
+// answer); meanwhile ring updates belong to a position the hardware has
+// already left. Moves only clamp at 0: past the right or bottom edge of the
+// set Live clamps, and its answer becomes the target.
+class RingNavigator {
+public:
+    struct Stats {
+        uint32_t moves = 0;      // Presses (one per shiftSessionRing call)
+        uint32_t positions = 0;  // CMD_RING_POSITION frames sent
+        uint32_t timeouts = 0;   // Positions Live never confirmed
+        uint32_t clamped = 0;    // Positions Live answered elsewhere (set edge)
+    };
+
+    void move(int trackDelta, int sceneDelta, uint32_t now) {
+        const int track = targetTrack + trackDelta;
+        const int scene = targetScene + sceneDelta;
+        targetTrack = static_cast<uint16_t>(track < 0 ? 0 : track);
+        targetScene = static_cast<uint16_t>(scene < 0 ? 0 : scene);
+        if (!merging) {
+            merging = true;
+            openedAt = now;
+        }
+        stats.moves++;
+    }
+
+    // True once per merge window, when the target is to be sent
+    bool takeDue(uint32_t now) {
+        if (!merging || now - openedAt < LIVE_RING_NAV_MERGE_MS) {
+            return false;
+        }
+        merging = false;
+        awaiting = true;
+        sentAt = now;
+        stats.positions++;
+        return true;
+    }
+
+    // Live reported the ring at (track, scene). True when it answered the
+    // position sent somewhere else (clamped at the edge of the set): the
+    // hardware shows the target, not Live's ring.
+    bool reported(uint16_t track, uint16_t scene) {
+        originTrack = track;
+        originScene = scene;
+        if (merging) {
+            return false;
+        }
+        const bool clamped = awaiting && (track != targetTrack || scene != targetScene);
+        if (clamped) {
+            stats.clamped++;
+        }
+        awaiting = false;
+        targetTrack = track; // Live's answer, or a move from Live's side
+        targetScene = scene;
+        return clamped;
+    }
+
+    // True once when Live did not confirm a sent position in time; the
+    // target falls back to where Live last reported the ring.
+    bool takeTimeout(uint32_t now) {
+        if (!awaiting || merging || now - sentAt < LIVE_CLIP_PREVIEW_TIMEOUT_MS) {
+            return false;
+        }
+        awaiting = false;
+        targetTrack = originTrack;
+        targetScene = originScene;
+        stats.timeouts++;
+        return true;
+    }
+
+    // Presses not yet reported back by Live
+    bool moving() const { return merging || awaiting; }
+
+    uint16_t track() const { return targetTrack; }
+    uint16_t scene() const { return targetScene; }
+    uint16_t liveTrack() const { return originTrack; }
+    uint16_t liveScene() const { return originScene; }
+
+    void reset() {
+        merging = false;
+        awaiting = false;
+        originTrack = originScene = 0;
+        targetTrack = targetScene = 0;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    Stats stats;
+    uint16_t originTrack = 0;  // As Live last reported it
+    uint16_t originScene = 0;
+    uint16_t targetTrack = 0;  // Where the presses take it
+    uint16_t targetScene = 0;
+    bool merging = false;      // Merge window open
+    bool awaiting = false;     // Target sent, Live has not reported it yet
+    uint32_t openedAt = 0;
+    uint32_t sentAt = 0;
+};
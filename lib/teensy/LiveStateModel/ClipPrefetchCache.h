@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/Config.h"
+
+// Clip state and color of the set around the session ring, keyed by
+// absolute (track, scene). Filled from the ring's own updates and from
+// prefetched neighbouring windows (CMD_CLIP_WINDOW), so moving the ring can
+// redraw the grid at once; Live's update for the new position corrects any
+// pad that was out of date.
+//
+// Direct-mapped: an absolute clip lives in slot (track % WIDTH, scene %
+// HEIGHT), tagged with its coordinates, so any WIDTH x HEIGHT window of the
+// set fits without collisions and moving the window needs no copying.
+class ClipPrefetchCache {
+public:
+    static constexpr uint8_t WIDTH = LIVE_CLIP_CACHE_TRACKS;
+    static constexpr uint8_t HEIGHT = LIVE_CLIP_CACHE_SCENES;
+    static constexpr uint16_t SLOTS = WIDTH * HEIGHT;
+
+    static_assert(WIDTH >= GRID_TRACKS && HEIGHT >= GRID_SCENES, "cache smaller than the ring");
+
+    ClipPrefetchCache() { clear(); }
+
+    void store(uint16_t track, uint16_t scene, uint8_t state, uint8_t r, uint8_t g, uint8_t b) {
+        const uint16_t slot = slotOf(track, scene);
+        keyTrack[slot] = track;
+        keyScene[slot] = scene;
+        states[slot] = state;
+        red[slot] = r;
+        green[slot] = g;
+        blue[slot] = b;
+    }
+
+    bool lookup(uint16_t track, uint16_t scene, uint8_t& state, uint8_t& r, uint8_t& g, uint8_t& b) const {
+        const uint16_t slot = slotOf(track, scene);
+        if (!holds(slot, track, scene)) {
+            return false;
+        }
+        state = states[slot];
+        r = red[slot];
+        g = green[slot];
+        b = blue[slot];
+        return true;
+    }
+
+    bool contains(uint16_t track, uint16_t scene) const {
+        return holds(slotOf(track, scene), track, scene);
+    }
+
+    // Shrinks the window to the rows and columns holding clips not cached;
+    // false when the whole window is cached.
+    bool missingBounds(uint16_t& track, uint16_t& scene, uint8_t& width, uint8_t& height) const {
+        uint16_t firstTrack = 0xFFFF, lastTrack = 0, firstScene = 0xFFFF, lastScene = 0;
+        for (uint16_t s = scene; s < scene + height; ++s) {
+            for (uint16_t t = track; t < track + width; ++t) {
+                if (contains(t, s)) {
+                    continue;
+                }
+                if (t < firstTrack) firstTrack = t;
+                if (t > lastTrack) lastTrack = t;
+                if (s < firstScene) firstScene = s;
+                if (s > lastScene) lastScene = s;
+            }
+        }
+        if (firstTrack == 0xFFFF) {
+            return false;
+        }
+        track = firstTrack;
+        scene = firstScene;
+        width = static_cast<uint8_t>(lastTrack - firstTrack + 1);
+        height = static_cast<uint8_t>(lastScene - firstScene + 1);
+        return true;
+    }
+
+    // Empty slots carry 0xFFFF, never a (14-bit) Live index
+    void clear() {
+        memset(keyTrack, 0xFF, sizeof(keyTrack));
+        memset(keyScene, 0xFF, sizeof(keyScene));
+    }
+
+private:
+    static uint16_t slotOf(uint16_t track, uint16_t scene) {
+        return static_cast<uint16_t>((scene % HEIGHT) * WIDTH + track % WIDTH);
+    }
+
+    bool holds(uint16_t slot, uint16_t track, uint16_t scene) const {
+        return keyTrack[slot] == track && keyScene[slot] == scene;
+    }
+
+    uint16_t keyTrack[SLOTS];
+    uint16_t keyScene[SLOTS];
+    uint8_t states[SLOTS] = {};
+    uint8_t red[SLOTS] = {};
+    uint8_t green[SLOTS] = {};
+    uint8_t blue[SLOTS] = {};
+};
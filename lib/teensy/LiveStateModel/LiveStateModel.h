@@ -0,0 +1,259 @@
+#pragma once
+
+#include <Arduino.h>
+#include "shared/Config.h"
+
+// Mirror of the Live state the hardware shows, written by LiveController as
+// messages arrive and read by everything that forwards or uses it (M4, GUI,
+// faders, encoders), so a reconnect or view change is served from here
+// instead of asking Live to resend.
+//
+// Stored as structure-of-arrays: each field is one contiguous array (or a
+// bitset), so a sweep over one field touches only its own bytes. Every field
+// carries a valid mask, a dirty mask per consumer (one bit per pad, track or
+// scene) and a version counter bumped on each change. Setters return whether
+// the value changed, so callers forward only real changes. A consumer that
+// forwards at its own rate subscribes to the fields it sends and takes their
+// dirty bits when it flushes, so several updates to one element in between
+// go out once, with the newest value.
+class LiveStateModel {
+public:
+    static constexpr uint8_t PADS = TOTAL_KEYS;
+    static constexpr uint8_t TRACKS = 32;  // Absolute track index, fader banks included
+    static constexpr uint8_t SENDS = 4;
+    static constexpr uint8_t SCENES = GRID_SCENES;
+
+    static_assert(PADS <= 32 && TRACKS <= 32 && SCENES <= 32, "masks are 32-bit");
+
+    enum Field : uint8_t {
+        CLIP_STATE,      // Index: pad
+        CLIP_COLOR,      // Index: pad, 8-bit RGB
+        TRACK_COLOR,     // Index: track, 7-bit RGB as Live sends it
+        TRACK_VOLUME,    // Index: track, 14-bit
+        TRACK_PAN,       // Index: track, 14-bit
+        TRACK_SEND_A,    // Index: track, 14-bit; one field per send
+        TRACK_SEND_B,
+        TRACK_SEND_C,
+        TRACK_SEND_D,
+        TRACK_MUTE,
+        TRACK_SOLO,
+        TRACK_ARM,
+        SCENE_STATE,     // Index: scene
+        SCENE_COLOR,     // Index: scene, 7-bit RGB
+        SCENE_TRIGGERED,
+        TRANSPORT,       // Index 0: play / record bits
+        TEMPO,           // Index 0: tenths of a BPM
+        SELECTED_TRACK,  // Index 0
+        FIELD_COUNT
+    };
+
+    // Forwarders that flush dirty elements at their own rate
+    enum Consumer : uint8_t {
+        GUI,
+        LEDS,
+        CONSUMER_COUNT
+    };
+
+    static Field sendField(uint8_t send) { return static_cast<Field>(TRACK_SEND_A + send); }
+    static constexpr uint32_t fieldBit(Field field) { return 1UL << field; }
+
+    static_assert(FIELD_COUNT <= 32, "subscriptions are 32-bit");
+
+    // ---- Updates (return true when the stored value changed) ----
+
+    bool setClipState(uint8_t pad, uint8_t state) {
+        return pad < PADS && store(CLIP_STATE, pad, clipStates[pad], state);
+    }
+    bool setClipColor(uint8_t pad, uint8_t r, uint8_t g, uint8_t b) {
+        return pad < PADS && storeColor(CLIP_COLOR, pad, clipRed, clipGreen, clipBlue, r, g, b);
+    }
+    bool setTrackColor(uint8_t track, uint8_t r, uint8_t g, uint8_t b) {
+        return track < TRACKS && storeColor(TRACK_COLOR, track, trackRed, trackGreen, trackBlue, r, g, b);
+    }
+    bool setVolume(uint8_t track, uint16_t value) {
+        return track < TRACKS && store(TRACK_VOLUME, track, volumes[track], value);
+    }
+    bool setPan(uint8_t track, uint16_t value) {
+        return track < TRACKS && store(TRACK_PAN, track, pans[track], value);
+    }
+    bool setSend(uint8_t track, uint8_t send, uint16_t value) {
+        return track < TRACKS && send < SENDS && store(sendField(send), track, sends[send][track], value);
+    }
+    bool setMute(uint8_t track, bool on) { return track < TRACKS && storeBit(TRACK_MUTE, track, muteBits, on); }
+    bool setSolo(uint8_t track, bool on) { return track < TRACKS && storeBit(TRACK_SOLO, track, soloBits, on); }
+    bool setArm(uint8_t track, bool on) { return track < TRACKS && storeBit(TRACK_ARM, track, armBits, on); }
+
+    bool setSceneState(uint8_t scene, uint8_t flags) {
+        return scene < SCENES && store(SCENE_STATE, scene, sceneFlags[scene], flags);
+    }
+    bool setSceneColor(uint8_t scene, uint8_t r, uint8_t g, uint8_t b) {
+        return scene < SCENES && storeColor(SCENE_COLOR, scene, sceneRed, sceneGreen, sceneBlue, r, g, b);
+    }
+    bool setSceneTriggered(uint8_t scene, bool on) {
+        return scene < SCENES && storeBit(SCENE_TRIGGERED, scene, sceneTriggeredBits, on);
+    }
+
+    bool setPlaying(bool on) { return storeTransport(TRANSPORT_PLAYING, on); }
+    bool setRecording(bool on) { return storeTransport(TRANSPORT_RECORDING, on); }
+    bool setTempo(uint16_t tenthsBpm) { return store(TEMPO, 0, tempoTenths, tenthsBpm); }
+    bool setSelectedTrack(uint8_t track) { return store(SELECTED_TRACK, 0, selected, track); }
+
+    // ---- Reads ----
+
+    uint8_t clipState(uint8_t pad) const { return clipStates[pad]; }
+    uint8_t clipR(uint8_t pad) const { return clipRed[pad]; }
+    uint8_t clipG(uint8_t pad) const { return clipGreen[pad]; }
+    uint8_t clipB(uint8_t pad) const { return clipBlue[pad]; }
+    uint8_t trackR(uint8_t track) const { return trackRed[track]; }
+    uint8_t trackG(uint8_t track) const { return trackGreen[track]; }
+    uint8_t trackB(uint8_t track) const { return trackBlue[track]; }
+    uint16_t volume(uint8_t track) const { return volumes[track]; }
+    uint16_t pan(uint8_t track) const { return pans[track]; }
+    uint16_t send(uint8_t track, uint8_t sendIndex) const { return sends[sendIndex][track]; }
+    bool hasSend(uint8_t track, uint8_t sendIndex) const {
+        return track < TRACKS && sendIndex < SENDS && isValid(sendField(sendIndex), track);
+    }
+    bool mute(uint8_t track) const { return (muteBits >> track) & 1UL; }
+    bool solo(uint8_t track) const { return (soloBits >> track) & 1UL; }
+    bool arm(uint8_t track) const { return (armBits >> track) & 1UL; }
+    uint8_t sceneState(uint8_t scene) const { return sceneFlags[scene]; }
+    uint8_t sceneR(uint8_t scene) const { return sceneRed[scene]; }
+    uint8_t sceneG(uint8_t scene) const { return sceneGreen[scene]; }
+    uint8_t sceneB(uint8_t scene) const { return sceneBlue[scene]; }
+    bool sceneTriggered(uint8_t scene) const { return (sceneTriggeredBits >> scene) & 1UL; }
+    bool playing() const { return transportBits & TRANSPORT_PLAYING; }
+    bool recording() const { return transportBits & TRANSPORT_RECORDING; }
+    uint16_t tempo() const { return tempoTenths; }
+    uint8_t selectedTrack() const { return selected; }
+
+    // ---- Bookkeeping ----
+
+    bool isValid(Field field, uint8_t index) const { return index < 32 && ((valid[field] >> index) & 1UL); }
+    uint32_t validMask(Field field) const { return valid[field]; }
+    uint16_t version(Field field) const { return versions[field]; }
+    bool isDirty(Consumer consumer, Field field, uint8_t index) const {
+        return index < 32 && ((dirty[consumer][field] >> index) & 1UL);
+    }
+
+    // Fields (fieldBit() mask) whose changes the consumer flushes itself
+    void subscribe(Consumer consumer, uint32_t fields) { subscriptions[consumer] = fields; }
+    // Changes that replaced one the consumer had not flushed yet
+    uint32_t mergedCount(Consumer consumer) const { return merged[consumer]; }
+    uint32_t dirtyMask(Consumer consumer, Field field) const { return dirty[consumer][field]; }
+
+    // Hand the dirty elements of a field to a consumer and clear them.
+    uint32_t takeDirty(Consumer consumer, Field field) {
+        const uint32_t mask = dirty[consumer][field];
+        dirty[consumer][field] = 0;
+        return mask;
+    }
+
+    // Everything known becomes dirty again (a consumer lost its copy).
+    void markAllDirty(Consumer consumer) {
+        for (uint8_t f = 0; f < FIELD_COUNT; ++f) {
+            dirty[consumer][f] = (subscriptions[consumer] >> f) & 1UL ? valid[f] : 0;
+        }
+    }
+
+    // Live went away: nothing is known any more.
+    void reset() {
+        for (uint8_t f = 0; f < FIELD_COUNT; ++f) {
+            if (valid[f]) {
+                versions[f]++;
+            }
+            valid[f] = 0;
+        }
+        memset(dirty, 0, sizeof(dirty));
+    }
+
+private:
+    enum : uint8_t { TRANSPORT_PLAYING = 0x01, TRANSPORT_RECORDING = 0x02 };
+
+    void mark(Field field, uint32_t bit) {
+        valid[field] |= bit;
+        for (uint8_t c = 0; c < CONSUMER_COUNT; ++c) {
+            if (!((subscriptions[c] >> field) & 1UL)) {
+                continue;
+            }
+            if (dirty[c][field] & bit) {
+                merged[c]++;
+            }
+            dirty[c][field] |= bit;
+        }
+        versions[field]++;
+    }
+
+    template <typename T>
+    bool store(Field field, uint8_t index, T& slot, T value) {
+        const uint32_t bit = 1UL << index;
+        if ((valid[field] & bit) && slot == value) {
+            return false;
+        }
+        slot = value;
+        mark(field, bit);
+        return true;
+    }
+
+    bool storeColor(Field field, uint8_t index, uint8_t* red, uint8_t* green, uint8_t* blue,
+                    uint8_t r, uint8_t g, uint8_t b) {
+        const uint32_t bit = 1UL << index;
+        if ((valid[field] & bit) && red[index] == r && green[index] == g && blue[index] == b) {
+            return false;
+        }
+        red[index] = r;
+        green[index] = g;
+        blue[index] = b;
+        mark(field, bit);
+        return true;
+    }
+
+    bool storeBit(Field field, uint8_t index, uint32_t& bits, bool on) {
+        const uint32_t bit = 1UL << index;
+        if ((valid[field] & bit) && (((bits & bit) != 0) == on)) {
+            return false;
+        }
+        bits = on ? (bits | bit) : (bits & ~bit);
+        mark(field, bit);
+        return true;
+    }
+
+    bool storeTransport(uint8_t flag, bool on) {
+        const uint8_t bits = on ? (transportBits | flag) : (transportBits & ~flag);
+        return store(TRANSPORT, 0, transportBits, static_cast<uint8_t>(bits));
+    }
+
+    // Pads
+    uint8_t clipStates[PADS] = {};
+    uint8_t clipRed[PADS] = {};
+    uint8_t clipGreen[PADS] = {};
+    uint8_t clipBlue[PADS] = {};
+
+    // Tracks
+    uint16_t volumes[TRACKS] = {};
+    uint16_t pans[TRACKS] = {};
+    uint16_t sends[SENDS][TRACKS] = {};
+    uint8_t trackRed[TRACKS] = {};
+    uint8_t trackGreen[TRACKS] = {};
+    uint8_t trackBlue[TRACKS] = {};
+    uint32_t muteBits = 0;
+    uint32_t soloBits = 0;
+    uint32_t armBits = 0;
+
+    // Scenes
+    uint8_t sceneFlags[SCENES] = {};
+    uint8_t sceneRed[SCENES] = {};
+    uint8_t sceneGreen[SCENES] = {};
+    uint8_t sceneBlue[SCENES] = {};
+    uint32_t sceneTriggeredBits = 0;
+
+    // Song
+    uint16_t tempoTenths = 0;
+    uint8_t transportBits = 0;
+    uint8_t selected = 0;
+
+    uint32_t valid[FIELD_COUNT] = {};
+    uint32_t dirty[CONSUMER_COUNT][FIELD_COUNT] = {};
+    uint32_t subscriptions[CONSUMER_COUNT] = {};
+    uint32_t merged[CONSUMER_COUNT] = {};
+    uint16_t versions[FIELD_COUNT] = {};
+};
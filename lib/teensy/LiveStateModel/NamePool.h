@@ -0,0 +1,217 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstring>
+#include "shared/Config.h"
+
+// Distinct track, clip and scene names, each stored once in a fixed arena
+// and known by a 14-bit ID, so the GUI gets a string once (CMD_NAME_DEFINE)
+// and slots refer to it afterwards (CMD_NAME_REF).
+//
+// An ID is [generation:8][entry:6]: the GUI can keep one string per entry,
+// a newer definition of the entry replacing the older one. Names held by a
+// slot (retain/release) are never evicted; when entries or arena bytes run
+// out, the least recently interned unheld name goes and the arena is
+// compacted.
+class NamePool {
+public:
+    static constexpr uint8_t ENTRIES = LIVE_NAME_POOL_ENTRIES;
+    static constexpr uint16_t BYTES = LIVE_NAME_POOL_BYTES;
+    static constexpr uint8_t ENTRY_BITS = 6;
+    static constexpr uint16_t NONE = 0xFFFF;
+
+    static_assert(ENTRIES <= (1 << ENTRY_BITS), "entry index must fit the ID");
+
+    struct Stats {
+        uint32_t interned = 0;    // Names looked up
+        uint32_t hits = 0;        // Already in the pool
+        uint32_t evictions = 0;
+        uint32_t compactions = 0;
+        uint32_t full = 0;        // Not stored: every name held and no room
+    };
+
+    // ID of the name, stored if new; NONE when it does not fit
+    uint16_t intern(const char* name, uint8_t length) {
+        stats.interned++;
+        clock++;
+        for (uint8_t i = 0; i < ENTRIES; ++i) {
+            Entry& entry = entries[i];
+            if (entry.used && entry.length == length && memcmp(&arena[entry.offset], name, length) == 0) {
+                entry.lastUsed = clock;
+                stats.hits++;
+                return idOf(i);
+            }
+        }
+
+        int slot = -1;
+        for (uint8_t i = 0; i < ENTRIES && slot < 0; ++i) {
+            if (!entries[i].used) {
+                slot = i;
+            }
+        }
+        if (slot < 0) {
+            slot = evictOldest();
+        }
+        while (slot >= 0 && tail + length > BYTES) {
+            compact();
+            if (tail + length > BYTES && evictOldest() < 0) {
+                slot = -1;
+            }
+        }
+        if (slot < 0) {
+            stats.full++;
+            return NONE;
+        }
+
+        Entry& entry = entries[slot];
+        memcpy(&arena[tail], name, length);
+        entry.offset = tail;
+        entry.length = length;
+        entry.refs = 0;
+        entry.used = true;
+        entry.defined = false;
+        entry.generation++;
+        entry.lastUsed = clock;
+        tail += length;
+        return idOf(static_cast<uint8_t>(slot));
+    }
+
+    void retain(uint16_t id) {
+        if (Entry* entry = find(id)) {
+            entry->refs++;
+        }
+    }
+
+    void release(uint16_t id) {
+        Entry* entry = find(id);
+        if (entry && entry->refs) {
+            entry->refs--;
+        }
+    }
+
+    // Name bytes (not NUL-terminated), nullptr for an evicted ID
+    const char* text(uint16_t id, uint8_t& length) const {
+        const Entry* entry = find(id);
+        if (!entry) {
+            length = 0;
+            return nullptr;
+        }
+        length = entry->length;
+        return reinterpret_cast<const char*>(&arena[entry->offset]);
+    }
+
+    // Whether the GUI has been sent the string of this ID
+    bool defined(uint16_t id) const {
+        const Entry* entry = find(id);
+        return entry && entry->defined;
+    }
+
+    void markDefined(uint16_t id) {
+        if (Entry* entry = find(id)) {
+            entry->defined = true;
+        }
+    }
+
+    // The GUI lost its strings (reconnect)
+    void clearDefined() {
+        for (Entry& entry : entries) {
+            entry.defined = false;
+        }
+    }
+
+    uint8_t entriesUsed() const {
+        uint8_t count = 0;
+        for (const Entry& entry : entries) {
+            count += entry.used;
+        }
+        return count;
+    }
+
+    uint16_t bytesUsed() const {
+        uint16_t bytes = 0;
+        for (const Entry& entry : entries) {
+            bytes += entry.used ? entry.length : 0;
+        }
+        return bytes;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        uint32_t lastUsed = 0;
+        uint16_t offset = 0;
+        uint8_t length = 0;
+        uint8_t refs = 0;        // Slots showing this name
+        uint8_t generation = 0;
+        bool used = false;
+        bool defined = false;
+    };
+
+    uint16_t idOf(uint8_t index) const {
+        return static_cast<uint16_t>((entries[index].generation << ENTRY_BITS) | index) & 0x3FFF;
+    }
+
+    Entry* find(uint16_t id) {
+        return const_cast<Entry*>(static_cast<const NamePool*>(this)->find(id));
+    }
+
+    const Entry* find(uint16_t id) const {
+        if (id == NONE) {
+            return nullptr;
+        }
+        const uint8_t index = id & ((1 << ENTRY_BITS) - 1);
+        if (index >= ENTRIES || !entries[index].used || idOf(index) != id) {
+            return nullptr;
+        }
+        return &entries[index];
+    }
+
+    // Least recently interned name no slot holds; -1 when all are held
+    int evictOldest() {
+        int oldest = -1;
+        for (uint8_t i = 0; i < ENTRIES; ++i) {
+            const Entry& entry = entries[i];
+            if (entry.used && !entry.refs && (oldest < 0 || entry.lastUsed < entries[oldest].lastUsed)) {
+                oldest = i;
+            }
+        }
+        if (oldest >= 0) {
+            entries[oldest].used = false;
+            stats.evictions++;
+        }
+        return oldest;
+    }
+
+    // Moves the names down to close the gaps left by evictions, lowest offset first
+    void compact() {
+        bool placed[ENTRIES] = {};
+        uint16_t cursor = 0;
+        for (;;) {
+            int next = -1;
+            for (uint8_t i = 0; i < ENTRIES; ++i) {
+                if (entries[i].used && !placed[i] && (next < 0 || entries[i].offset < entries[next].offset)) {
+                    next = i;
+                }
+            }
+            if (next < 0) {
+                break;
+            }
+            Entry& entry = entries[next];
+            if (entry.offset != cursor) {
+                memmove(&arena[cursor], &arena[entry.offset], entry.length);
+                entry.offset = cursor;
+            }
+            cursor += entry.length;
+            placed[next] = true;
+        }
+        tail = cursor;
+        stats.compactions++;
+    }
+
+    Stats stats;
+    Entry entries[ENTRIES];
+    uint8_t arena[BYTES];
+    uint16_t tail = 0;
+    uint32_t clock = 0;
+};
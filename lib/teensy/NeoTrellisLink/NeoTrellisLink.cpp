@@ -10,38 +10,135 @@ namespace {
 constexpr uint16_t HANDSHAKE_TIMEOUT_MS = 1000;
 constexpr uint16_t RECONNECT_BACKOFF_MS = 1500;
 constexpr uint8_t MAX_INITIAL_ATTEMPTS = 3;
+constexpr uint8_t DELTA_MASK_BYTES = 4;
 const uint8_t HANDSHAKE_PAYLOAD[] = {0x50,0x55,0x53,0x48,0x43,0x4C,0x4F,0x4E,0x45}; // "PUSHCLONE"
+TxQueue::Priority priorityFor(uint8_t command) {
+    if (BinaryProtocol::isLinkControl(command)) {
+        return TxQueue::PRIORITY_CONTROL;
+    }
+    switch (command) {
+        case CMD_PING:
+        case CMD_ENABLE_KEYS:
+        case CMD_DISABLE_KEYS:
+        case CMD_UART_CONFIRMATION_ANIMATION:
+        case CMD_LINK_BAUD:
+            return TxQueue::PRIORITY_CONTROL;
+        case CMD_LED_PAD_UPDATE:
+        case CMD_LED_PAD_UPDATE_14:
+        case CMD_LED_RGB_STATE:
+        case CMD_LED_CLIP_STATE:
+        case CMD_LED_PAD_FULL:
+            return TxQueue::PRIORITY_PAD;
+        default:
+            return TxQueue::PRIORITY_BULK;
+    }
+}
+
+constexpr uint16_t LINK_CAPS = BinaryProtocol::CAP_COBS | BinaryProtocol::CAP_CRC8 |
+                               BinaryProtocol::CAP_CRC16 | BinaryProtocol::CAP_BATCH |
+                               BinaryProtocol::CAP_LED_DELTA | BinaryProtocol::CAP_EXT_LEN |
+                               BinaryProtocol::CAP_LED_PAD_FULL;
 }
 
 extern UartHandler uartHandler;
 extern LiveController liveController;
 
-void NeoTrellisLink::sendCommand(uint8_t command, const uint8_t* data, int dataLength) {
+bool NeoTrellisLink::sendCommand(uint8_t command, const uint8_t* data, int dataLength) {
     if (dataLength < 0) dataLength = 0;
+    if (dataLength > BinaryProtocol::MAX_EXT_PAYLOAD_SIZE) {
+        Serial.println("Teensy: ERROR - Failed to build binary message for NeoTrellis");
+        return false;
+    }
+    const BinaryProtocol::Slice slice = {data, static_cast<uint16_t>(dataLength)};
+    return sendSlices(command, &slice, 1);
+}
 
-    // Use BinaryProtocol to build message
-    // Maximum message size: SYNC + CMD + LEN + PAYLOAD + CHECKSUM
-    uint8_t txBuffer[260]; // 4 overhead + 256 max payload
-    uint16_t messageLen = BinaryProtocol::buildMessage(
-        command,
-        data,
-        static_cast<uint8_t>(dataLength),
-        txBuffer,
-        sizeof(txBuffer)
-    );
-
-    if (messageLen > 0) {
-        Serial1.write(txBuffer, messageLen);
-        Serial1.flush();
-    } else {
+bool NeoTrellisLink::batches(uint8_t command, uint16_t length) const {
+    return batch.active() && linkMode.batch && BinaryProtocol::isBatchable(command) &&
+           length <= BinaryProtocol::MAX_PAYLOAD_SIZE - BinaryProtocol::BATCH_ENTRY_HEADER;
+}
+
+bool NeoTrellisLink::sendSlices(uint8_t command, const BinaryProtocol::Slice* slices, uint8_t sliceCount) {
+    const uint16_t length = BinaryProtocol::sliceLength(slices, sliceCount);
+    if (length > linkMode.maxPayload) {
+        Serial.println("Teensy: ERROR - Failed to build binary message for NeoTrellis");
+        return false;
+    }
+
+    if (batches(command, length)) {
+        if (!batch.fits(static_cast<uint8_t>(length))) {
+            flushBatch();
+        }
+        batch.add(command, slices, sliceCount);
+        return true;
+    }
+
+    // Anything queued goes out first to keep ordering
+    flushBatch();
+    return writeFrame(command, slices, sliceCount, length);
+}
+
+bool NeoTrellisLink::writeFrame(uint8_t command, const BinaryProtocol::Slice* slices, uint8_t sliceCount,
+                                uint16_t dataLength) {
+    // Encode in the negotiated link mode straight into the TX ring; slices
+    // are read in place, the payload is never assembled anywhere else
+    const BinaryProtocol::LinkMode mode = BinaryProtocol::modeFor(command, linkMode);
+    if (!txQueue.beginFrame(priorityFor(command), BinaryProtocol::getFrameSize(mode, dataLength))) {
+        return false; // Counted as a drop by the queue
+    }
+
+    BinaryProtocol::FrameEncoder<TxQueue> encoder(txQueue, mode);
+    if (!encoder.begin(command, dataLength) || !encoder.write(slices, sliceCount) || !encoder.finish()) {
+        txQueue.abortFrame();
         Serial.println("Teensy: ERROR - Failed to build binary message for NeoTrellis");
+        return false;
+    }
+    txQueue.endFrame();
+    return true;
+}
+
+void NeoTrellisLink::beginBatch() {
+    batch.depth++;
+}
+
+void NeoTrellisLink::endBatch() {
+    if (batch.depth == 0) return;
+    if (--batch.depth == 0) {
+        flushBatch();
+    }
+}
+
+void NeoTrellisLink::flushBatch() {
+    if (batch.count == 0) return;
+
+    bool sent = true;
+    if (batch.count == 1 || !linkMode.batch) {
+        // Single entry (no container overhead) or the link renegotiated
+        // without batching while entries were queued: send them one by one
+        uint16_t offset = 0;
+        uint8_t command = 0;
+        const uint8_t* payload = nullptr;
+        uint8_t payloadLen = 0;
+        while (BinaryProtocol::nextBatchEntry(batch.payload, batch.length, offset,
+                                              command, payload, payloadLen)) {
+            const BinaryProtocol::Slice slice = {payload, payloadLen};
+            sent &= writeFrame(command, &slice, 1, payloadLen);
+        }
+    } else {
+        const BinaryProtocol::Slice slice = {batch.payload, batch.length};
+        sent = writeFrame(CMD_BATCH, &slice, 1, batch.length);
+    }
+    batch.clear();
+    if (!sent) {
+        markPadsLost(batchedPads);
     }
+    batchedPads = 0;
 }
 
 void NeoTrellisLink::sendRaw(const uint8_t* data, int length) {
     if (!data || length <= 0) return;
-    Serial1.write(data, length);
-    Serial1.flush();
+    flushBatch();
+    txQueue.push(TxQueue::PRIORITY_BULK, data, static_cast<uint16_t>(length));
 }
 
 void NeoTrellisLink::sendDisconnectEvent() {
@@ -55,13 +152,203 @@ void NeoTrellisLink::sendDisconnectEvent() {
 
 void NeoTrellisLink::setPixelColor(int key, uint32_t color) {
     if (key < 0 || key >= TOTAL_KEYS) return;
-    uint8_t payload[] = {
-        static_cast<uint8_t>(key),
-        static_cast<uint8_t>((color >> 16) & 0xFF),
-        static_cast<uint8_t>((color >> 8) & 0xFF),
-        static_cast<uint8_t>(color & 0xFF)
-    };
+    const uint8_t r = static_cast<uint8_t>((color >> 16) & 0xFF);
+    const uint8_t g = static_cast<uint8_t>((color >> 8) & 0xFF);
+    const uint8_t b = static_cast<uint8_t>(color & 0xFF);
+    if (linkMode.ledDelta) {
+        updatePadColor(static_cast<uint8_t>(key), r, g, b);
+        return;
+    }
+    uint8_t payload[] = {static_cast<uint8_t>(key), r, g, b};
     sendCommand(CMD_LED_RGB_STATE, payload, sizeof(payload));
+    // Legacy M4 renders RGB_STATE through its 7-bit path; colour no longer known
+    staleMask |= (1UL << key);
+}
+
+void NeoTrellisLink::stagePadColor(uint8_t pad, uint8_t r8, uint8_t g8, uint8_t b8) {
+    if (pad >= TOTAL_KEYS) return;
+    stagedColors[pad][0] = r8;
+    stagedColors[pad][1] = g8;
+    stagedColors[pad][2] = b8;
+}
+
+void NeoTrellisLink::stageClipState(uint8_t pad, uint8_t state) {
+    if (pad >= TOTAL_KEYS) return;
+    stagedClipStates[pad] = state;
+    clipStatesKnown |= (1UL << pad);
+}
+
+void NeoTrellisLink::commitPads() {
+    uint32_t colorMask = 0;
+    uint32_t stateMask = 0;
+    uint8_t changedCount = 0;
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        const uint32_t bit = 1UL << pad;
+        const bool stale = staleMask & bit;
+        if (stale || memcmp(stagedColors[pad], shadowColors[pad], 3) != 0) {
+            colorMask |= bit;
+        }
+        if ((clipStatesKnown & bit) &&
+            (!(clipStatesValid & bit) || shadowClipStates[pad] != stagedClipStates[pad])) {
+            stateMask |= bit;
+        }
+        changedCount += ((colorMask | stateMask) & bit) ? 1 : 0;
+    }
+    padsSkipped += TOTAL_KEYS - changedCount;
+    if (changedCount == 0) {
+        return;
+    }
+    padsSent += changedCount;
+
+    // The shadow takes the staged values first; a frame that does not make
+    // it into the TX queue marks its pads stale again (markPadsLost)
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if ((stateMask >> pad) & 1UL) {
+            shadowClipStates[pad] = stagedClipStates[pad];
+        }
+    }
+    clipStatesValid |= stateMask;
+    memcpy(shadowColors, stagedColors, sizeof(shadowColors));
+    staleMask = 0;
+
+    if (linkMode.padFull) {
+        sendPadsFull(colorMask, stateMask);
+        return;
+    }
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if ((stateMask >> pad) & 1UL) {
+            uint8_t payload[] = {pad, stagedClipStates[pad]};
+            sendPadFrame(CMD_LED_CLIP_STATE, payload, sizeof(payload), 1UL << pad);
+        }
+    }
+    if (colorMask && !linkMode.ledDelta) {
+        sendPadColorsLegacy(colorMask);
+    } else if (colorMask) {
+        sendPadColorsDelta(colorMask);
+    }
+}
+
+// Sends a frame carrying the pads in padMask. If it is dropped (TX queue
+// full), now or when the batch holding it is flushed, those pads go stale
+// and the next commit sends them again.
+void NeoTrellisLink::sendPadFrame(uint8_t command, const uint8_t* data, uint16_t length, uint32_t padMask) {
+    padFrames++;
+    const bool batched = batches(command, length);
+    if (!sendCommand(command, data, length)) {
+        markPadsLost(padMask);
+    } else if (batched) {
+        batchedPads |= padMask;
+    }
+}
+
+void NeoTrellisLink::markPadsLost(uint32_t padMask) {
+    staleMask |= padMask;
+    clipStatesValid &= ~padMask;
+    padsLost += __builtin_popcount(padMask);
+}
+
+// One frame for every changed pad, state and colour together: the M4 shows
+// the grid once. Pads whose state did not change carry LED_PAD_STATE_KEEP.
+void NeoTrellisLink::sendPadsFull(uint32_t colorMask, uint32_t stateMask) {
+    const uint32_t changedMask = colorMask | stateMask;
+    uint8_t payload[DELTA_MASK_BYTES + TOTAL_KEYS * 4];
+    uint8_t length = 0;
+    const bool single = (changedMask & (changedMask - 1)) == 0;
+    if (!single) {
+        payload[length++] = static_cast<uint8_t>(changedMask & 0xFF);
+        payload[length++] = static_cast<uint8_t>((changedMask >> 8) & 0xFF);
+        payload[length++] = static_cast<uint8_t>((changedMask >> 16) & 0xFF);
+        payload[length++] = static_cast<uint8_t>((changedMask >> 24) & 0xFF);
+    }
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if (!((changedMask >> pad) & 1UL)) continue;
+        if (single) {
+            payload[length++] = pad;
+        }
+        payload[length++] = ((stateMask >> pad) & 1UL) ? stagedClipStates[pad] : LED_PAD_STATE_KEEP;
+        memcpy(&payload[length], stagedColors[pad], 3);
+        length += 3;
+    }
+    sendPadFrame(single ? CMD_LED_PAD_FULL : CMD_LED_PAD_FULL_BULK, payload, length, changedMask);
+}
+
+void NeoTrellisLink::sendPadColorsDelta(uint32_t changedMask) {
+    if ((changedMask & (changedMask - 1)) == 0) {
+        uint8_t pad = 0;
+        while (!((changedMask >> pad) & 1UL)) pad++;
+        uint8_t payload[] = {pad, stagedColors[pad][0], stagedColors[pad][1], stagedColors[pad][2]};
+        sendPadFrame(CMD_LED_PAD_UPDATE, payload, sizeof(payload), changedMask);
+        return;
+    }
+    uint8_t payload[DELTA_MASK_BYTES + TOTAL_KEYS * 3];
+    uint8_t length = 0;
+    payload[length++] = static_cast<uint8_t>(changedMask & 0xFF);
+    payload[length++] = static_cast<uint8_t>((changedMask >> 8) & 0xFF);
+    payload[length++] = static_cast<uint8_t>((changedMask >> 16) & 0xFF);
+    payload[length++] = static_cast<uint8_t>((changedMask >> 24) & 0xFF);
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if ((changedMask >> pad) & 1UL) {
+            memcpy(&payload[length], stagedColors[pad], 3);
+            length += 3;
+        }
+    }
+    sendPadFrame(CMD_LED_GRID_DELTA, payload, length, changedMask);
+}
+
+// M4 firmware without CMD_LED_GRID_DELTA: per-pad 14-bit frames. Not
+// CMD_LED_GRID_UPDATE_14: the M4 skips pads touched within PAD_SUPPRESS_MS
+// in a grid bulk, so a second bulk right after the first would be lost.
+void NeoTrellisLink::sendPadColorsLegacy(uint32_t changedMask) {
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        if (!((changedMask >> pad) & 1UL)) continue;
+        uint8_t payload[7];
+        payload[0] = pad;
+        for (uint8_t c = 0; c < 3; ++c) {
+            payload[1 + c * 2] = stagedColors[pad][c] >> 7;
+            payload[2 + c * 2] = stagedColors[pad][c] & 0x7F;
+        }
+        sendPadFrame(CMD_LED_PAD_UPDATE_14, payload, sizeof(payload), 1UL << pad);
+    }
+}
+
+void NeoTrellisLink::updatePadColor(uint8_t pad, uint8_t r8, uint8_t g8, uint8_t b8) {
+    stagePadColor(pad, r8, g8, b8);
+    commitPads();
+}
+
+void NeoTrellisLink::updateGridColors7bit(const uint8_t* rgb7, int length) {
+    if (!rgb7 || length != TOTAL_KEYS * 3) return;
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        // Full-range 7→8 bit expansion (127 → 255)
+        const uint8_t* c = &rgb7[pad * 3];
+        stagePadColor(pad,
+                      static_cast<uint8_t>(((c[0] & 0x7F) << 1) | ((c[0] & 0x7F) >> 6)),
+                      static_cast<uint8_t>(((c[1] & 0x7F) << 1) | ((c[1] & 0x7F) >> 6)),
+                      static_cast<uint8_t>(((c[2] & 0x7F) << 1) | ((c[2] & 0x7F) >> 6)));
+    }
+    commitPads();
+}
+
+void NeoTrellisLink::updateGridColors14bit(const uint8_t* rgb14, int length) {
+    if (!rgb14 || length != TOTAL_KEYS * 6) return;
+    for (uint8_t pad = 0; pad < TOTAL_KEYS; ++pad) {
+        const uint8_t* c = &rgb14[pad * 6];
+        stagePadColor(pad,
+                      static_cast<uint8_t>(((c[0] & 0x7F) << 7) | (c[1] & 0x7F)),
+                      static_cast<uint8_t>(((c[2] & 0x7F) << 7) | (c[3] & 0x7F)),
+                      static_cast<uint8_t>(((c[4] & 0x7F) << 7) | (c[5] & 0x7F)));
+    }
+    commitPads();
+}
+
+void NeoTrellisLink::updateClipState(uint8_t pad, uint8_t state) {
+    stageClipState(pad, state);
+    commitPads();
+}
+
+void NeoTrellisLink::invalidateShadow() {
+    staleMask = 0xFFFFFFFF;
+    clipStatesValid = 0;
 }
 
 void NeoTrellisLink::triggerConnectionAnimation() {
@@ -95,6 +382,7 @@ void NeoTrellisLink::runConnectionSweep() {
         delay(18);
     }
 
+    invalidateShadow();
     Serial.println("Teensy: Sweep complete — waiting for Live colors.");
 }
 
@@ -105,6 +393,7 @@ bool NeoTrellisLink::initializeCommunication() {
     handshakeAttempts = 0;
     handshakePending = false;
     disconnectNotified = false;
+    baud.begin(Serial1, UART_BAUD_RATE, UART_MAX_BAUD_TEENSY);
     setConnected(false);
     sendDisconnectEvent();
 
@@ -112,6 +401,7 @@ bool NeoTrellisLink::initializeCommunication() {
         requestHandshake();
         unsigned long waitStart = millis();
         while (!m4Connected && (millis() - waitStart) < HANDSHAKE_TIMEOUT_MS) {
+            txQueue.drain();
             uartHandler.read();
         }
         if (!m4Connected) {
@@ -130,9 +420,29 @@ bool NeoTrellisLink::initializeCommunication() {
 }
 
 void NeoTrellisLink::update() {
+    txQueue.drain();
     unsigned long now = millis();
 
     if (m4Connected) {
+        if (pendingBaud && txQueue.fenceReached()) {
+            sendBaudRequest();
+        }
+        switch (baud.update(now, uartHandler.getParserStats().badFrames)) {
+            case LinkBaud::Action::REQUEST:
+                Serial.printf("Teensy: NeoTrellis UART errors at %lu bps, stepping down\n",
+                              static_cast<unsigned long>(baud.current()));
+                requestBaud(baud.requestedBaud());
+                break;
+            case LinkBaud::Action::LINK_LOST:
+                Serial.println("Teensy: NeoTrellis stopped answering at the upgraded baud rate");
+                setConnected(false);
+                return;
+            default:
+                break;
+        }
+        if (!pendingBaud) {
+            txQueue.hold(baud.awaitingEcho());
+        }
         if (now - lastPingSentMs >= UART_PING_INTERVAL_MS) {
             sendCommand(CMD_PING, nullptr, 0);
             lastPingSentMs = now;
@@ -155,8 +465,18 @@ void NeoTrellisLink::update() {
 
 void NeoTrellisLink::requestHandshake() {
     if (handshakePending) return;
-    Serial.println("Teensy: Sending NeoTrellis handshake...");
-    sendCommand(CMD_HANDSHAKE, HANDSHAKE_PAYLOAD, sizeof(HANDSHAKE_PAYLOAD));
+    // Attempts walk the baud ladder in case the M4 is still at a faster rate
+    baud.hunt(handshakeAttempts);
+    Serial.printf("Teensy: Sending NeoTrellis handshake @ %lu bps...\n",
+                  static_cast<unsigned long>(baud.current()));
+    BinaryProtocol::LinkCaps caps;
+    caps.flags = LINK_CAPS;
+    caps.maxBaud = baud.offered();
+    caps.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    uint8_t payload[sizeof(HANDSHAKE_PAYLOAD) + BinaryProtocol::CAPS_BLOCK_SIZE];
+    uint8_t payloadLen = BinaryProtocol::appendCaps(HANDSHAKE_PAYLOAD, sizeof(HANDSHAKE_PAYLOAD),
+                                                    caps, payload, sizeof(payload));
+    sendCommand(CMD_HANDSHAKE, payload, payloadLen);
     handshakePending = true;
     lastHandshakeRequestMs = millis();
     handshakeAttempts++;
@@ -192,11 +512,32 @@ void NeoTrellisLink::setConnected(bool connected, bool remoteRequest) {
         } else {
             sendDisconnectEvent();
         }
+        // A fresh handshake renegotiates the link mode; the M4 clears its grid
+        linkMode = BinaryProtocol::LinkMode();
+        pendingBaud = 0;
+        txQueue.hold(false);
+        txQueue.drain();
+        baud.reset();
+        invalidateShadow();
     }
 }
 
-void NeoTrellisLink::handleHandshakeAck() {
+void NeoTrellisLink::handleHandshakeAck(const uint8_t* payload, uint8_t length) {
     Serial.println("Teensy: NeoTrellis handshake ACK received.");
+    BinaryProtocol::LinkCaps local;
+    local.flags = LINK_CAPS;
+    local.maxBaud = baud.offered();
+    local.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    BinaryProtocol::LinkCaps peer;
+    if (!BinaryProtocol::findCaps(payload, length, peer)) {
+        peer = BinaryProtocol::LinkCaps(); // Legacy M4 firmware: no capability block
+    }
+    linkMode = BinaryProtocol::modeFromCaps(BinaryProtocol::agreeCaps(local, peer));
+    // The M4 drops to the base rate right after its reply
+    const uint32_t upgradeBaud = baud.afterHandshake(linkMode.maxBaud);
+    Serial.printf("Teensy: NeoTrellis link mode -> %s/%s\n",
+                  BinaryProtocol::framingName(linkMode.framing),
+                  BinaryProtocol::integrityName(linkMode.integrity));
     setConnected(true);
     triggerConnectionAnimation();
 
@@ -205,10 +546,71 @@ void NeoTrellisLink::handleHandshakeAck() {
     sendCommand(CMD_ENABLE_KEYS, nullptr, 0);
 
     liveController.setHardwareReady(true);
+
+    if (upgradeBaud) {
+        requestBaud(upgradeBaud);
+    }
+}
+
+// Ask the M4 to switch rate. Everything queued goes out at the current rate
+// first; frames queued from now on wait behind a fence. update() sends
+// CMD_LINK_BAUD once the older frames are on the wire, and they stay held
+// until the echo arrives and they can go out at the new rate.
+void NeoTrellisLink::requestBaud(uint32_t rate) {
+    if (BinaryProtocol::baudCode(rate) == BinaryProtocol::BAUD_CODE_NONE) {
+        return;
+    }
+    flushBatch();
+    if (!pendingBaud) {
+        txQueue.holdNew();
+    }
+    pendingBaud = rate;
+    Serial.printf("Teensy: Requesting NeoTrellis UART @ %lu bps once %u queued bytes are out\n",
+                  static_cast<unsigned long>(rate), txQueue.pendingBytes());
+}
+
+// The queue is idle behind its fence: CMD_LINK_BAUD goes straight to the
+// port, the last frame at the old rate.
+void NeoTrellisLink::sendBaudRequest() {
+    const uint8_t code = BinaryProtocol::baudCode(pendingBaud);
+    const BinaryProtocol::LinkMode mode = BinaryProtocol::modeFor(CMD_LINK_BAUD, linkMode);
+    uint8_t frame[16];
+    const uint16_t length = BinaryProtocol::getFrameSize(mode, 1);
+    if (length > sizeof(frame) || Serial1.availableForWrite() < length) {
+        return; // Next update()
+    }
+    const uint16_t built = BinaryProtocol::buildFrame(mode, CMD_LINK_BAUD, &code, 1, frame, sizeof(frame));
+    if (built == 0) {
+        return;
+    }
+    Serial1.write(frame, built);
+    baud.requested(pendingBaud, millis());
+    txQueue.hold(true);
+    pendingBaud = 0;
+}
+
+void NeoTrellisLink::handleLinkBaud(const uint8_t* payload, uint16_t length) {
+    if (!payload || length < 1) {
+        return;
+    }
+    const uint32_t rate = BinaryProtocol::baudRate(payload[0]);
+    if (baud.echoed(rate, millis())) {
+        // Echo of our request: the M4 has switched. A pong at the new rate confirms it
+        txQueue.hold(false);
+        Serial.printf("Teensy: NeoTrellis UART -> %lu bps\n", static_cast<unsigned long>(rate));
+        sendCommand(CMD_PING, nullptr, 0);
+        lastPingSentMs = millis();
+        return;
+    }
+    if (!baud.awaitingEcho() && rate != 0 && rate < baud.current()) {
+        // The M4 sees errors at this rate and proposes a slower one
+        requestBaud(rate);
+    }
 }
 
 void NeoTrellisLink::handlePingResponse() {
     lastPongMs = millis();
+    baud.frameReceived();
 }
 
 void NeoTrellisLink::handleDisconnectNotice() {
@@ -1,11 +1,47 @@
 #pragma once
 
 #include <Arduino.h>
+#include "shared/BinaryProtocol.h"
+#include "shared/LinkBaud.h"
+#include "TxQueue/TxQueue.h"
+#include "shared/Config.h"
 
 class NeoTrellisLink {
 public:
-    void sendCommand(uint8_t command, const uint8_t* data, int dataLength);
+    // False when the frame was dropped (TX queue full, payload too long).
+    // Inside a batch the frame is only packed; it is written on flush.
+    bool sendCommand(uint8_t command, const uint8_t* data, int dataLength);
+    // Scatter-gather form: the payload is the slices back to back, framed
+    // straight from where they live.
+    bool sendSlices(uint8_t command, const BinaryProtocol::Slice* slices, uint8_t sliceCount);
     void sendRaw(const uint8_t* data, int length);
+
+    // Commands sent between beginBatch()/endBatch() are packed into CMD_BATCH
+    // frames when the M4 negotiated it. Pairs may nest.
+    void beginBatch();
+    void endBatch();
+
+    // Shadow framebuffer: the 8-bit colour and clip state every pad shows on
+    // the M4. Updates are diffed against it and only changed pads go out: with
+    // CAP_LED_PAD_FULL as one CMD_LED_PAD_FULL (one pad) or
+    // CMD_LED_PAD_FULL_BULK frame carrying state and colour together;
+    // otherwise colours as one pad frame or a CMD_LED_GRID_DELTA bitmask
+    // frame, and each state as CMD_LED_CLIP_STATE. Stage several pads, then
+    // commit once. Pads of a frame the TX queue drops are marked stale and
+    // go out again on the next commit.
+    void stagePadColor(uint8_t pad, uint8_t r8, uint8_t g8, uint8_t b8);
+    void stageClipState(uint8_t pad, uint8_t state);
+    void commitPads();
+    void updatePadColor(uint8_t pad, uint8_t r8, uint8_t g8, uint8_t b8);
+    void updateGridColors7bit(const uint8_t* rgb7, int length);
+    void updateGridColors14bit(const uint8_t* rgb14, int length);
+    void updateClipState(uint8_t pad, uint8_t state);
+    void invalidateShadow();
+    uint32_t getPadsSent() const { return padsSent; }
+    uint32_t getPadsSkipped() const { return padsSkipped; }
+    uint32_t getPadFrames() const { return padFrames; }
+    uint32_t getPadsLost() const { return padsLost; }
+
     void setPixelColor(int key, uint32_t color);
     void triggerConnectionAnimation();
     void runConnectionSweep();
@@ -13,15 +49,33 @@ public:
     bool initializeCommunication();
     void update();
 
+    // Hands queued frames to Serial1 without blocking; called from loop()
+    void serviceTx() { txQueue.drain(); }
+    const TxQueue& getTxQueue() const { return txQueue; }
+
     void setConnected(bool connected, bool remoteRequest = false);
     bool isConnected() const { return m4Connected; }
+    const BinaryProtocol::LinkMode& getLinkMode() const { return linkMode; }
+    const LinkBaud& getBaud() const { return baud; }
 
-    void handleHandshakeAck();
+    void handleHandshakeAck(const uint8_t* payload, uint8_t length);
+    void handleLinkBaud(const uint8_t* payload, uint16_t length);
     void handlePingResponse();
     void handleDisconnectNotice();
 
 private:
+    bool batches(uint8_t command, uint16_t length) const;
+    bool writeFrame(uint8_t command, const BinaryProtocol::Slice* slices, uint8_t sliceCount,
+                    uint16_t dataLength);
+    void flushBatch();
+    void sendPadFrame(uint8_t command, const uint8_t* data, uint16_t length, uint32_t padMask);
+    void markPadsLost(uint32_t padMask);
+    void sendPadColorsLegacy(uint32_t changedMask);
+    void sendPadColorsDelta(uint32_t changedMask);
+    void sendPadsFull(uint32_t colorMask, uint32_t stateMask);
     void requestHandshake();
+    void requestBaud(uint32_t rate);
+    void sendBaudRequest();
     void sendDisconnectEvent();
 
     bool m4Connected = false;
@@ -33,4 +87,22 @@ private:
     unsigned long lastPingSentMs = 0;
     unsigned long lastPongMs = 0;
     uint8_t handshakeAttempts = 0;
+    BinaryProtocol::LinkMode linkMode;
+    LinkBaud baud;
+    uint32_t pendingBaud = 0;        // Rate to request once the queue drains to its fence
+    BinaryProtocol::Batch batch;
+    TxQueue txQueue{Serial1};
+
+    uint8_t shadowColors[TOTAL_KEYS][3] = {};
+    uint8_t stagedColors[TOTAL_KEYS][3] = {};
+    uint8_t shadowClipStates[TOTAL_KEYS] = {};
+    uint8_t stagedClipStates[TOTAL_KEYS] = {};
+    uint32_t clipStatesKnown = 0;    // Pads with a staged state
+    uint32_t staleMask = 0xFFFFFFFF; // Pads whose colour on the M4 is unknown
+    uint32_t clipStatesValid = 0;    // Bit per pad
+    uint32_t batchedPads = 0;        // Pads whose frames wait in the open batch
+    uint32_t padsSent = 0;
+    uint32_t padsSkipped = 0;
+    uint32_t padFrames = 0;          // Pad colour/state frames sent to the M4
+    uint32_t padsLost = 0;           // Pads of frames the TX queue dropped
 };
@@ -0,0 +1,211 @@
+#include "TxQueue/TxQueue.h"
+#include <cstring>
+
+namespace {
+const char* const CLASS_NAMES[TxQueue::PRIORITY_COUNT] = {"control", "pad", "bulk"};
+}
+
+bool TxQueue::push(Priority priority, const uint8_t* data, uint16_t length) {
+    if (!data || length == 0 || !beginFrame(priority, length)) {
+        return false;
+    }
+    write(data, length);
+    endFrame();
+    return true;
+}
+
+bool TxQueue::beginFrame(Priority priority, uint16_t maxLength) {
+    if (priority >= PRIORITY_COUNT || maxLength == 0) {
+        return false;
+    }
+
+    if (priority == PRIORITY_PAD && rings[PRIORITY_BULK].used > 0) {
+        stats[PRIORITY_PAD].framesDemoted++;
+        priority = PRIORITY_BULK;
+    }
+
+    Ring& ring = rings[priority];
+    const uint32_t needed = static_cast<uint32_t>(maxLength) + HEADER_SIZE;
+    if (needed > static_cast<uint32_t>(ring.capacity - ring.used)) {
+        stats[priority].framesDropped++;
+        openClass = NO_FRAME;
+        return false;
+    }
+
+    openClass = priority;
+    openStart = ring.head;
+    openLength = 0;
+    openCapacity = maxLength;
+    return true;
+}
+
+void TxQueue::write(const uint8_t* data, uint16_t length) {
+    if (openClass == NO_FRAME || length > openCapacity - openLength) {
+        return;
+    }
+    Ring& ring = rings[openClass];
+    const uint16_t offset = static_cast<uint16_t>((openStart + HEADER_SIZE + openLength) % ring.capacity);
+    copyIn(ring, offset, data, length);
+    openLength += length;
+}
+
+void TxQueue::endFrame() {
+    if (openClass == NO_FRAME) {
+        return;
+    }
+    Ring& ring = rings[openClass];
+    ClassStats& classStats = stats[openClass];
+    openClass = NO_FRAME;
+    if (openLength == 0) {
+        return;
+    }
+
+    const uint32_t now = micros();
+    const uint8_t header[HEADER_SIZE] = {
+        static_cast<uint8_t>(openLength & 0xFF),
+        static_cast<uint8_t>(openLength >> 8),
+        static_cast<uint8_t>(now & 0xFF),
+        static_cast<uint8_t>((now >> 8) & 0xFF),
+        static_cast<uint8_t>((now >> 16) & 0xFF),
+        static_cast<uint8_t>((now >> 24) & 0xFF)
+    };
+    copyIn(ring, openStart, header, HEADER_SIZE);
+    const uint16_t frameBytes = HEADER_SIZE + openLength;
+    ring.head = static_cast<uint16_t>((ring.head + frameBytes) % ring.capacity);
+    ring.used += frameBytes;
+
+    classStats.framesQueued++;
+    if (ring.used > classStats.highWaterBytes) {
+        classStats.highWaterBytes = ring.used;
+    }
+
+    // Opportunistic: most small frames go straight into the driver buffer
+    drain();
+}
+
+void TxQueue::drain() {
+    if (held) {
+        return;
+    }
+    int room = port.availableForWrite();
+    while (room > 0) {
+        if (currentClass == NO_FRAME) {
+            for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+                if (rings[cls].used > 0 && (!fenced || fenceBytes[cls] > 0)) {
+                    currentClass = cls;
+                    break;
+                }
+            }
+            if (currentClass == NO_FRAME) {
+                return;
+            }
+            uint8_t header[HEADER_SIZE];
+            readBytes(rings[currentClass], header, HEADER_SIZE);
+            if (fenced) {
+                fenceBytes[currentClass] -= HEADER_SIZE;
+            }
+            currentRemaining = static_cast<uint16_t>(header[0] | (header[1] << 8));
+            currentEnqueuedUs = static_cast<uint32_t>(header[2]) |
+                                (static_cast<uint32_t>(header[3]) << 8) |
+                                (static_cast<uint32_t>(header[4]) << 16) |
+                                (static_cast<uint32_t>(header[5]) << 24);
+        }
+
+        Ring& ring = rings[currentClass];
+        uint16_t chunk = currentRemaining;
+        const uint16_t contiguous = ring.capacity - ring.tail;
+        if (chunk > contiguous) chunk = contiguous;
+        if (chunk > room) chunk = static_cast<uint16_t>(room);
+
+        port.write(&ring.data[ring.tail], chunk);
+        stats[currentClass].bytesSent += chunk;
+        ring.tail = static_cast<uint16_t>((ring.tail + chunk) % ring.capacity);
+        ring.used -= chunk;
+        currentRemaining -= chunk;
+        room -= chunk;
+        if (fenced) {
+            fenceBytes[currentClass] -= chunk;
+        }
+
+        if (currentRemaining == 0) {
+            ClassStats& classStats = stats[currentClass];
+            const uint32_t waitUs = micros() - currentEnqueuedUs;
+            classStats.framesSent++;
+            classStats.totalWaitUs += waitUs;
+            if (waitUs > classStats.maxWaitUs) {
+                classStats.maxWaitUs = waitUs;
+            }
+            currentClass = NO_FRAME;
+        }
+    }
+}
+
+void TxQueue::holdNew() {
+    // Rings are FIFO: the bytes queued now, the rest of a frame being
+    // written included, are the first ones drain() takes from each
+    for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+        fenceBytes[cls] = rings[cls].used;
+    }
+    fenced = true;
+}
+
+bool TxQueue::fenceReached() const {
+    if (!fenced || currentClass != NO_FRAME) {
+        return false;
+    }
+    for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+        if (fenceBytes[cls] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TxQueue::isEmpty() const {
+    return pendingBytes() == 0;
+}
+
+uint16_t TxQueue::pendingBytes() const {
+    uint16_t total = 0;
+    for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+        total += rings[cls].used;
+    }
+    return total;
+}
+
+void TxQueue::resetStats() {
+    for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+        stats[cls] = ClassStats();
+    }
+}
+
+void TxQueue::printStats(Print& out) const {
+    for (uint8_t cls = 0; cls < PRIORITY_COUNT; ++cls) {
+        const ClassStats& s = stats[cls];
+        const uint32_t avgWaitUs = s.framesSent ? static_cast<uint32_t>(s.totalWaitUs / s.framesSent) : 0;
+        out.printf("  TX %-7s queued %lu sent %lu dropped %lu demoted %lu | high-water %u/%u B | wait avg %lu us max %lu us\n",
+                   CLASS_NAMES[cls],
+                   static_cast<unsigned long>(s.framesQueued),
+                   static_cast<unsigned long>(s.framesSent),
+                   static_cast<unsigned long>(s.framesDropped),
+                   static_cast<unsigned long>(s.framesDemoted),
+                   s.highWaterBytes, rings[cls].capacity,
+                   static_cast<unsigned long>(avgWaitUs),
+                   static_cast<unsigned long>(s.maxWaitUs));
+    }
+}
+
+void TxQueue::copyIn(Ring& ring, uint16_t offset, const uint8_t* src, uint16_t length) {
+    uint16_t first = ring.capacity - offset;
+    if (first > length) first = length;
+    memcpy(&ring.data[offset], src, first);
+    memcpy(ring.data, src + first, length - first);
+}
+
+void TxQueue::readBytes(Ring& ring, uint8_t* dst, uint16_t length) {
+    for (uint16_t i = 0; i < length; ++i) {
+        dst[i] = ring.data[ring.tail];
+        ring.tail = static_cast<uint16_t>((ring.tail + 1) % ring.capacity);
+    }
+    ring.used -= length;
+}
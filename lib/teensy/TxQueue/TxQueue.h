@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Non-blocking, prioritized transmit queue for a UART link.
+// Frames are copied into one byte ring per priority class and handed to the
+// port only as fast as its driver buffer has room (availableForWrite), so
+// callers never wait for the wire. Frames are never interleaved: the class
+// order is re-evaluated only at frame boundaries.
+class TxQueue {
+public:
+    enum Priority : uint8_t {
+        PRIORITY_CONTROL = 0, // Handshake, ping, key enable/disable
+        PRIORITY_PAD,         // Single pad feedback
+        PRIORITY_BULK,        // Grid bulks, batches, raw SysEx passthrough
+        PRIORITY_COUNT
+    };
+
+    struct ClassStats {
+        uint32_t framesQueued = 0;
+        uint32_t framesSent = 0;
+        uint32_t bytesSent = 0;       // Handed to the UART driver
+        uint32_t framesDropped = 0;   // Ring full, frame discarded
+        uint32_t framesDemoted = 0;   // Queued behind older bulk frames to keep order
+        uint16_t highWaterBytes = 0;  // Peak ring usage, headers included
+        uint32_t maxWaitUs = 0;       // Enqueue → last byte handed to the UART driver
+        uint64_t totalWaitUs = 0;
+    };
+
+    explicit TxQueue(Stream& port) : port(port) {}
+
+    // Queue one frame. Returns false (and counts a drop) if it does not fit.
+    // Pad frames queued while bulk frames are pending join the bulk class so
+    // an older grid bulk can never overwrite a newer pad colour.
+    bool push(Priority priority, const uint8_t* data, uint16_t length);
+
+    // Stream one frame in pieces: reserve room for up to maxLength bytes,
+    // put()/write() them, then endFrame(). The frame becomes visible to
+    // drain() only once it is closed, so a partial frame never hits the wire.
+    // This makes the queue a BinaryProtocol::FrameEncoder sink.
+    bool beginFrame(Priority priority, uint16_t maxLength);
+    void put(uint8_t value) { write(&value, 1); }
+    void write(const uint8_t* data, uint16_t length);
+    void endFrame();
+    void abortFrame() { openClass = NO_FRAME; }
+
+    // Write as much as the driver buffer accepts right now. Never blocks.
+    void drain();
+    // While held, drain() writes nothing and frames keep queueing; used while
+    // the link changes baud rate. Releasing the hold also lifts a fence.
+    void hold(bool held) {
+        this->held = held;
+        if (!held) fenced = false;
+    }
+    // Fence: frames already queued still go out, frames queued from now on
+    // wait behind it. fenceReached() once the older ones are all written,
+    // at a frame boundary; the port is then free for a frame of its own.
+    void holdNew();
+    bool fenceReached() const;
+
+    bool isEmpty() const;
+    uint16_t pendingBytes() const;
+    const ClassStats& getStats(Priority priority) const { return stats[priority]; }
+    void resetStats();
+    void printStats(Print& out) const;
+
+private:
+    static constexpr uint16_t HEADER_SIZE = 6; // uint16 length + uint32 enqueue micros
+    static constexpr uint8_t NO_FRAME = 0xFF;
+
+    struct Ring {
+        uint8_t* data;
+        uint16_t capacity;
+        uint16_t head = 0;
+        uint16_t tail = 0;
+        uint16_t used = 0;
+    };
+
+    void copyIn(Ring& ring, uint16_t offset, const uint8_t* src, uint16_t length);
+    void readBytes(Ring& ring, uint8_t* dst, uint16_t length);
+
+    Stream& port;
+
+    uint8_t controlStorage[512];
+    uint8_t padStorage[1024];
+    uint8_t bulkStorage[4096];
+    Ring rings[PRIORITY_COUNT] = {
+        {controlStorage, sizeof(controlStorage)},
+        {padStorage, sizeof(padStorage)},
+        {bulkStorage, sizeof(bulkStorage)}
+    };
+    ClassStats stats[PRIORITY_COUNT];
+
+    uint8_t openClass = NO_FRAME;    // Class of the frame being filled
+    uint16_t openStart = 0;          // Ring offset of its header
+    uint16_t openLength = 0;
+    uint16_t openCapacity = 0;
+
+    bool held = false;
+    bool fenced = false;
+    uint16_t fenceBytes[PRIORITY_COUNT] = {}; // Ring bytes queued before the fence
+    uint8_t currentClass = NO_FRAME; // Class of the frame being written
+    uint16_t currentRemaining = 0;
+    uint32_t currentEnqueuedUs = 0;
+};
@@ -76,12 +76,10 @@ void UIBridge::sendSessionRingPosition() {
 // Implement other member functions as needed, ensuring they are declared in the header.
 
 void UIBridge::shiftSessionRing(int trackDelta, int sceneDelta) {
-    // Send navigation commands to Live (0x68) per delta step
-    auto sendNav = [&](uint8_t dir){ liveController.sendSysExToAbleton(CMD_RING_NAVIGATE, &dir, 1); };
-    if (trackDelta > 0) for (int i=0;i<trackDelta;i++) sendNav(0x01); // Right
-    if (trackDelta < 0) for (int i=0;i<-trackDelta;i++) sendNav(0x00); // Left
-    if (sceneDelta > 0) for (int i=0;i<sceneDelta;i++) sendNav(0x03); // Down
-    if (sceneDelta < 0) for (int i=0;i<-sceneDelta;i++) sendNav(0x02); // Up
+    // Presses within LIVE_RING_NAV_MERGE_MS reach Live as one absolute
+    // CMD_RING_POSITION (one grid push), not one CMD_RING_NAVIGATE per step;
+    // the grid is redrawn from the clip cache meanwhile
+    liveController.moveRing(trackDelta, sceneDelta);
 }
 
 void UIBridge::handleGridUpdateFromLive(uint8_t* colorData, int dataLen) {
@@ -89,15 +87,10 @@ void UIBridge::handleGridUpdateFromLive(uint8_t* colorData, int dataLen) {
         return;
     }
 
-    uint8_t cmd = 0;
     if (dataLen == 96) {
-        cmd = CMD_LED_GRID_UPDATE;
+        neoTrellisLink.updateGridColors7bit(colorData, dataLen);
     } else if (dataLen == 192) {
-        cmd = CMD_LED_GRID_UPDATE_14;
-    }
-
-    if (cmd != 0) {
-        neoTrellisLink.sendCommand(cmd, colorData, dataLen);
+        neoTrellisLink.updateGridColors14bit(colorData, dataLen);
     }
 }
 
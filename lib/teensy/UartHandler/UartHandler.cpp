@@ -12,95 +12,70 @@ extern LiveController liveController;
 
 void UartHandler::begin() {
     Serial1.begin(UART_BAUD_RATE);
-    rxIndex = 0;
-    messageComplete = false;
+    parser.reset();
     lastSeenMs = millis();
     Serial.print("Teensy: UART handler listening @ ");
     Serial.println(UART_BAUD_RATE);
 }
 
 void UartHandler::read() {
-    while (Serial1.available()) {
-        uint8_t byte = Serial1.read();
+    const uint32_t badBefore = parser.getStats().badFrames;
+    if (parser.poll(Serial1, neoTrellisLink.getLinkMode(),
+                    [this](const FrameView& frame) { handleFrame(frame); }) > 0) {
         lastSeenMs = millis();
-
-        if (byte == BinaryProtocol::BINARY_SYNC_BYTE) {
-            rxIndex = 0;
-            messageComplete = false;
-            rxBuffer[rxIndex++] = byte;
-            continue;
-        }
-
-        if (rxIndex == 0) {
-            continue;
-        }
-
-        if (rxIndex < BUFFER_SIZE) {
-            rxBuffer[rxIndex++] = byte;
-        } else {
-            Serial.println("Teensy: UART buffer overflow, dropping packet");
-            rxIndex = 0;
-            continue;
-        }
-
-        if (rxIndex >= 3) {
-            uint8_t payloadLen = rxBuffer[2] & 0x7F;
-            uint16_t expectedLength = BinaryProtocol::getMessageSize(payloadLen);
-            if (expectedLength > BUFFER_SIZE) {
-                Serial.println("Teensy: Binary message too large");
-                rxIndex = 0;
-                continue;
-            }
-            if (rxIndex == expectedLength) {
-                messageComplete = true;
-                parseMessage();
-                rxIndex = 0;
-            } else if (rxIndex > expectedLength) {
-                Serial.println("Teensy: Binary message exceeded expected length");
-                rxIndex = 0;
-            }
-        }
     }
+    if (parser.getStats().badFrames != badBefore) {
+        Serial.println("Teensy: Invalid binary UART frame");
+    }
+    meter.sample(millis(), getHealth().bytesSent, parser.getStats().bytes);
 }
 
-void UartHandler::parseMessage() {
-    if (!messageComplete) {
-        return;
+LinkHealth UartHandler::getHealth() const {
+    LinkHealth health;
+    const TxQueue& queue = neoTrellisLink.getTxQueue();
+    for (uint8_t cls = 0; cls < TxQueue::PRIORITY_COUNT; ++cls) {
+        const TxQueue::ClassStats& stats = queue.getStats(static_cast<TxQueue::Priority>(cls));
+        health.framesSent += stats.framesSent;
+        health.bytesSent += stats.bytesSent;
+        health.txDropped += stats.framesDropped;
     }
+    const FrameParserStats& rx = parser.getStats();
+    health.framesReceived = rx.frames;
+    health.bytesReceived = rx.bytes;
+    health.badFrames = rx.badFrames;
+    health.resyncs = rx.resyncs;
+    health.overflows = rx.overflows;
+    health.txBytesPerSec = meter.txBytesPerSec();
+    health.rxBytesPerSec = meter.rxBytesPerSec();
+    health.baud = neoTrellisLink.getBaud().current();
+    return health;
+}
 
-    uint8_t command = 0;
-    const uint8_t* payload = nullptr;
-    uint8_t payloadLen = 0;
-    bool valid = BinaryProtocol::parseMessage(rxBuffer, rxIndex, command, payload, payloadLen);
-    if (!valid) {
-        Serial.println("Teensy: Invalid binary UART frame");
-        return;
+void UartHandler::requestPeerHealth() {
+    if (neoTrellisLink.isConnected()) {
+        neoTrellisLink.sendCommand(CMD_STATS, nullptr, 0);
     }
+}
 
-    Serial.print("Teensy: UART CMD 0x");
-    Serial.print(command, HEX);
-    Serial.print(" LEN ");
-    Serial.println(payloadLen);
+void UartHandler::handleFrame(const FrameView& frame) {
+    // In COBS mode only link-control frames may arrive SYNC-framed
+    if (frame.framing == BinaryProtocol::Framing::SYNC) {
+        if (neoTrellisLink.getLinkMode().framing == BinaryProtocol::Framing::COBS &&
+            !(frame.command == CMD_DISCONNECT && frame.length == 0)) {
+            return;
+        }
+        Serial.print("Teensy: UART CMD 0x");
+        Serial.print(frame.command, HEX);
+        Serial.print(" LEN ");
+        Serial.println(frame.length);
+    }
 
-    handleNeoTrellisCommand(command, const_cast<uint8_t*>(payload), payloadLen);
+    handleNeoTrellisCommand(frame.command, const_cast<uint8_t*>(frame.payload), frame.length);
 }
 
 void UartHandler::sendToNeoTrellis(uint8_t command, uint8_t* data, int length) {
-    if (length < 0) length = 0;
-    uint8_t buffer[BUFFER_SIZE];
-    uint16_t frameLen = BinaryProtocol::buildMessage(
-        command,
-        data,
-        static_cast<uint8_t>(length),
-        buffer,
-        sizeof(buffer)
-    );
-    if (frameLen == 0) {
-        Serial.println("Teensy: Failed to build UART frame for NeoTrellis");
-        return;
-    }
-    Serial1.write(buffer, frameLen);
-    Serial1.flush();
+    // Same framing and TX queue as every other frame to the M4
+    neoTrellisLink.sendCommand(command, data, length);
 }
 
 void UartHandler::processNeoTrellisMessage() {}
@@ -111,7 +86,7 @@ void UartHandler::handleNeoTrellisCommand(uint8_t command, uint8_t* data, int le
     switch (command) {
         case CMD_HANDSHAKE_REPLY:
             Serial.println("Teensy: Received CMD_HANDSHAKE_REPLY");
-            neoTrellisLink.handleHandshakeAck();
+            neoTrellisLink.handleHandshakeAck(data, static_cast<uint8_t>(length));
             break;
         case CMD_PING:
             neoTrellisLink.handlePingResponse();
@@ -119,7 +94,39 @@ void UartHandler::handleNeoTrellisCommand(uint8_t command, uint8_t* data, int le
         case CMD_DISCONNECT:
             neoTrellisLink.handleDisconnectNotice();
             break;
+        case CMD_LINK_BAUD:
+            neoTrellisLink.handleLinkBaud(data, static_cast<uint16_t>(length));
+            break;
+        case CMD_STATS: {
+            // [STATS_VERSION][M4 block]
+            uint16_t offset = 1;
+            uint8_t linkId = 0;
+            LinkHealth reported;
+            if (length > 0 && reported.decode(data, static_cast<uint16_t>(length), offset, linkId) &&
+                linkId == LinkHealth::LINK_M4_TEENSY) {
+                peerHealth = reported;
+                peerHealthValid = true;
+            }
+            break;
+        }
+        case CMD_BATCH: {
+            uint16_t offset = 0;
+            uint8_t entryCommand = 0;
+            const uint8_t* entry = nullptr;
+            uint8_t entryLen = 0;
+            while (BinaryProtocol::nextBatchEntry(data, static_cast<uint16_t>(length), offset,
+                                                  entryCommand, entry, entryLen)) {
+                if (BinaryProtocol::isBatchable(entryCommand)) {
+                    handleNeoTrellisCommand(entryCommand, const_cast<uint8_t*>(entry), entryLen);
+                }
+            }
+            break;
+        }
         default:
+            if (length > BinaryProtocol::MAX_PAYLOAD_SIZE) {
+                Serial.println("Teensy: Extended UART frame ignored (no handler)");
+                break;
+            }
             uiBridge.handleUARTCommand(command, data, static_cast<uint8_t>(length));
             break;
     }
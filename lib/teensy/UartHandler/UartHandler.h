@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Arduino.h>
+#include "shared/BinaryProtocol.h"
+#include "shared/FrameParser.h"
+#include "shared/LinkHealth.h"
 
 class UartHandler {
 public:
@@ -9,15 +12,23 @@ public:
     void sendToNeoTrellis(uint8_t command, uint8_t* data, int length);
     void processNeoTrellisMessage();
     
+    const FrameParserStats& getParserStats() const { return parser.getStats(); }
+
+    // Teensy's end of the M4 link: TX queue plus receiver counters
+    LinkHealth getHealth() const;
+    // The M4's own counters, as last reported in reply to requestPeerHealth()
+    const LinkHealth& getPeerHealth() const { return peerHealth; }
+    bool hasPeerHealth() const { return peerHealthValid; }
+    void requestPeerHealth();
+
 private:
-    static const int BUFFER_SIZE = 256;
-    uint8_t rxBuffer[BUFFER_SIZE];
-    int rxIndex;
-    bool messageComplete;
+    FrameParser<BinaryProtocol::MAX_EXT_FRAME_SIZE> parser;
     unsigned long lastPingMs = 0;
     unsigned long lastSeenMs = 0;
-    
-    
-    void parseMessage();
+    LinkRateMeter meter;
+    LinkHealth peerHealth;
+    bool peerHealthValid = false;
+
+    void handleFrame(const FrameView& frame);
     void handleNeoTrellisCommand(uint8_t command, uint8_t* data, int length);
 };
@@ -34,6 +34,31 @@ ButtonManager buttonManager;
 static int g_selectedTrack = 0;
 // Valores de encoders [Pan, SendA, SendB, SendC] para el track seleccionado
 static int g_encoderValues[4] = {8192, 0, 0, 0}; // Pan centrado, Sends en 0
+// Último giro de cada encoder (millis)
+static uint32_t g_encoderTouchedAt[4] = {0, 0, 0, 0};
+// Giros que empezaron desde un valor de Live distinto del local (saltos evitados)
+static uint32_t g_encoderResyncs = 0;
+
+// Valor 14-bit que Live tiene para el parámetro del encoder en el track
+// seleccionado (Pan, Send A-C); false si Live aún no lo ha enviado
+static bool liveEncoderValue(uint8_t encoderIndex, int& value) {
+    if (g_selectedTrack < 0 || g_selectedTrack >= LiveStateModel::TRACKS) {
+        return false;
+    }
+    const LiveStateModel& state = liveController.getState();
+    const uint8_t track = static_cast<uint8_t>(g_selectedTrack);
+    if (encoderIndex == 0) {
+        if (!state.isValid(LiveStateModel::TRACK_PAN, track)) return false;
+        value = state.pan(track);
+        return true;
+    }
+    const uint8_t send = encoderIndex - 1;
+    if (!state.hasSend(track, send)) return false;
+    value = state.send(track, send);
+    return true;
+}
+
+uint32_t getEncoderResyncs() { return g_encoderResyncs; }
 
 // Función para actualizar track seleccionado (llamada desde LiveController)
 void setSelectedTrack(int trackIndex) {
@@ -41,14 +66,18 @@ void setSelectedTrack(int trackIndex) {
         g_selectedTrack = trackIndex;
         Serial.printf("🎯 Selected track changed: Track %d\n", g_selectedTrack);
 
-        // Reset encoder values to neutral when changing tracks
-        // This prevents sending old values from previous track
-        g_encoderValues[0] = 8192;  // Pan center (50%)
-        g_encoderValues[1] = 0;     // Send A off
-        g_encoderValues[2] = 0;     // Send B off
-        g_encoderValues[3] = 0;     // Send C off
+        // Start from the new track's values as mirrored from Live, or from
+        // neutral for what Live has not sent yet. This prevents sending
+        // old values from the previous track
+        for (uint8_t i = 0; i < 4; i++) {
+            if (!liveEncoderValue(i, g_encoderValues[i])) {
+                g_encoderValues[i] = i == 0 ? 8192 : 0;  // Pan center (50%), sends off
+            }
+            g_encoderTouchedAt[i] = 0;
+        }
 
-        Serial.println("   ↳ Encoder values reset to neutral");
+        Serial.printf("   ↳ Encoders: pan=%d sends=%d/%d/%d\n", g_encoderValues[0],
+                      g_encoderValues[1], g_encoderValues[2], g_encoderValues[3]);
     }
 }
 
@@ -205,6 +234,17 @@ void setupHardware() {
     encoders.onEncoderChange = [](uint8_t encoderIndex, int8_t delta) {
         if (encoderIndex >= 4) return; // Solo 4 encoders
 
+        // Partir del valor actual en Live si cambió por otro lado (GUI, ratón,
+        // automatización) y el encoder no se está girando ahora mismo
+        const uint32_t now = millis();
+        int liveValue = 0;
+        if (now - g_encoderTouchedAt[encoderIndex] >= ENCODER_FEEDBACK_HOLDOFF_MS &&
+            liveEncoderValue(encoderIndex, liveValue) && liveValue != g_encoderValues[encoderIndex]) {
+            g_encoderValues[encoderIndex] = liveValue;
+            g_encoderResyncs++;
+        }
+        g_encoderTouchedAt[encoderIndex] = now;
+
         // Ajustar valor (paso de 128 ≈ 1 en 7-bit)
         g_encoderValues[encoderIndex] += delta * 128; // 128 ≈ 1/128 of 14-bit range
         g_encoderValues[encoderIndex] = constrain(g_encoderValues[encoderIndex], 0, 16383);
@@ -1,12 +1,13 @@
 #include <Arduino.h>
 #include <string.h>
 #include <stdlib.h>
-#include "Hardware.h"
+#include "teensy/Hardware.h"
 #include "LiveController/LiveController.h"
 #include "GUIInterface/GUIInterface.h"
 #include "MidiCommands.h"
 #include "teensy/UIBridge.h"
 #include "NeoTrellisLink/NeoTrellisLink.h"
+#include "UartHandler/UartHandler.h"
 #include "shared/Config.h"
 
 // Declare external reference to global instances
@@ -14,12 +15,73 @@ extern LiveController liveController;
 extern UIBridge uiBridge;
 extern NeoTrellisLink neoTrellisLink;
 extern GUIInterface guiInterface;
+extern UartHandler uartHandler;
 
 // Simple serial command parser for navigation and clip play
 static char serialLine[64];
 static uint8_t serialIdx = 0;
 static bool guiLinkStarted = false;
 
+static void printLinkHealth(const char* label, const LinkHealth& health) {
+    const uint16_t txUse = health.txUtilization();
+    const uint16_t rxUse = health.rxUtilization();
+    Serial.printf("%s: TX %lu B/s (%u.%u%%) %lu frames, %lu dropped | RX %lu B/s (%u.%u%%) %lu frames, "
+                  "%lu bad, %lu resyncs, %lu overflows\n", label,
+                  static_cast<unsigned long>(health.txBytesPerSec), txUse / 10, txUse % 10,
+                  static_cast<unsigned long>(health.framesSent),
+                  static_cast<unsigned long>(health.txDropped),
+                  static_cast<unsigned long>(health.rxBytesPerSec), rxUse / 10, rxUse % 10,
+                  static_cast<unsigned long>(health.framesReceived),
+                  static_cast<unsigned long>(health.badFrames),
+                  static_cast<unsigned long>(health.resyncs),
+                  static_cast<unsigned long>(health.overflows));
+}
+
+static void printLinkBaud(const char* label, const LinkBaud& baud) {
+    Serial.printf("%s: %lu bps (offering up to %lu), %lu fallbacks\n", label,
+                  static_cast<unsigned long>(baud.current()),
+                  static_cast<unsigned long>(baud.offered()),
+                  static_cast<unsigned long>(baud.getFallbacks()));
+}
+
+// Live commands by handler time, heaviest first
+static void printLiveProfile(const LiveCommandProfiler& profiler) {
+    uint8_t order[LiveCommandProfiler::ENTRIES];
+    uint16_t active = 0;
+    uint64_t totalCycles = 0;
+    uint32_t totalBytes = 0;
+    for (uint16_t id = 0; id < LiveCommandProfiler::ENTRIES; ++id) {
+        const LiveCommandProfiler::Entry& entry = profiler[static_cast<uint8_t>(id)];
+        if (!entry.count) continue;
+        // Insertion by cycles, descending
+        uint16_t pos = active++;
+        while (pos > 0 && profiler[order[pos - 1]].cycles < entry.cycles) {
+            order[pos] = order[pos - 1];
+            --pos;
+        }
+        order[pos] = static_cast<uint8_t>(id);
+        totalCycles += entry.cycles;
+        totalBytes += entry.payloadBytes;
+    }
+
+    const uint32_t cyclesPerUs = F_CPU_ACTUAL / 1000000UL;
+    Serial.printf("=== Live ingest profile: %u commands, %lu payload bytes, %lu us in handlers ===\n",
+                  active, static_cast<unsigned long>(totalBytes),
+                  static_cast<unsigned long>(totalCycles / cyclesPerUs));
+    Serial.println(" CMD     count      bytes   max   total us  us/msg   cpu%");
+    for (uint16_t i = 0; i < active; ++i) {
+        const LiveCommandProfiler::Entry& entry = profiler[order[i]];
+        const uint32_t totalUs = static_cast<uint32_t>(entry.cycles / cyclesPerUs);
+        Serial.printf(" 0x%02X %8lu %10lu %5u %10lu %7.2f %6.1f\n", order[i],
+                      static_cast<unsigned long>(entry.count),
+                      static_cast<unsigned long>(entry.payloadBytes),
+                      entry.maxPayload,
+                      static_cast<unsigned long>(totalUs),
+                      static_cast<float>(entry.cycles) / cyclesPerUs / entry.count,
+                      totalCycles ? 100.0f * entry.cycles / totalCycles : 0.0f);
+    }
+}
+
 static void handleSerialCommand(char* line) {
     // Trim leading spaces
     while (*line == ' ') ++line;
@@ -35,8 +97,10 @@ static void handleSerialCommand(char* line) {
         Serial.println("  u|d|l|r - Quick navigation");
         Serial.println("  play <track> <scene> - Trigger clip");
         Serial.println("  grid - Force grid refresh");
+        Serial.println("  resync [grid|names|mixer|transport|all] - Ask Live to resend one area");
         Serial.println("  enable - Enable pad scanning manually");
         Serial.println("  status - Show system status");
+        Serial.println("  profile [reset] - Live commands by count, bytes and handler time");
         return;
     }
 
@@ -47,18 +111,133 @@ static void handleSerialCommand(char* line) {
         return;
     }
 
+    if (strcmp(cmd, "profile") == 0) {
+        char* arg = strtok(nullptr, " ");
+        if (arg && strcmp(arg, "reset") == 0) {
+            liveController.resetProfiler();
+            Serial.println("Live ingest profile cleared");
+            return;
+        }
+        printLiveProfile(liveController.getProfiler());
+        return;
+    }
+
     if (strcmp(cmd, "status") == 0) {
         Serial.println("=== System Status ===");
         Serial.print("Live connected: ");
         Serial.println(liveController.isLiveConnected() ? "YES" : "NO");
         Serial.print("Grid seen: ");
         Serial.println(liveController.hasSeenGrid() ? "YES" : "NO");
+        const LiveCommand::Stats& dispatch = liveController.getDispatchStats();
+        Serial.printf("Live commands: %lu handled, %lu ignored, %lu bad length, %lu unknown\n",
+                      static_cast<unsigned long>(dispatch.handled),
+                      static_cast<unsigned long>(dispatch.ignored),
+                      static_cast<unsigned long>(dispatch.badLength),
+                      static_cast<unsigned long>(dispatch.unknown));
+        const LiveController::MidiDrainStats& drain = liveController.getDrainStats();
+        Serial.printf("MIDI drain: %lu msgs in %lu drains (max %u/drain, worst %lu us), "
+                      "budget hit %lu, throttled %lu, max M4 TX backlog %lu bytes\n",
+                      static_cast<unsigned long>(drain.messages),
+                      static_cast<unsigned long>(drain.drains),
+                      drain.maxMessages,
+                      static_cast<unsigned long>(drain.maxDrainUs),
+                      static_cast<unsigned long>(drain.budgetExhausted),
+                      static_cast<unsigned long>(drain.throttled),
+                      static_cast<unsigned long>(drain.maxTxBacklog));
+        const LiveSysExAssembler::Stats& sysex = liveController.getSysExStats();
+        Serial.printf("USB SysEx: %lu Live frames, %lu passthrough, %lu rejected, %lu pieces, largest %u bytes\n",
+                      static_cast<unsigned long>(sysex.liveFrames),
+                      static_cast<unsigned long>(sysex.passthrough),
+                      static_cast<unsigned long>(sysex.rejected),
+                      static_cast<unsigned long>(sysex.chunks),
+                      sysex.largestFrame);
+        const LiveSequenceTracker::Stats& seq = liveController.getSequenceStats();
+        const LiveController::ResyncStats& resync = liveController.getResyncStats();
+        Serial.printf("Live SEQ: in %lu, out %lu, %lu gaps (%lu lost, largest %u), %lu dup, %lu cut frames, %lu resyncs (last 0x%02X)\n",
+                      static_cast<unsigned long>(seq.inFrames),
+                      static_cast<unsigned long>(seq.outFrames),
+                      static_cast<unsigned long>(seq.gaps),
+                      static_cast<unsigned long>(seq.missing),
+                      seq.largestGap,
+                      static_cast<unsigned long>(seq.duplicates),
+                      static_cast<unsigned long>(resync.rejectedFrames),
+                      static_cast<unsigned long>(resync.requests),
+                      resync.lastAreas);
+        const LiveStateModel& model = liveController.getState();
+        Serial.printf("Live state: %u bytes, versions clips %u/%u mixer %u/%u\n",
+                      static_cast<unsigned>(sizeof(LiveStateModel)),
+                      model.version(LiveStateModel::CLIP_STATE),
+                      model.version(LiveStateModel::CLIP_COLOR),
+                      model.version(LiveStateModel::TRACK_VOLUME),
+                      model.version(LiveStateModel::TRACK_PAN));
+        const LiveController::CoalesceStats& merge = liveController.getCoalesceStats();
+        Serial.printf("Live merge: GUI %lu forwarded / %lu merged in %lu flushes, LEDs %lu forwarded / %lu merged in %lu flushes\n",
+                      static_cast<unsigned long>(merge.guiForwarded),
+                      static_cast<unsigned long>(model.mergedCount(LiveStateModel::GUI)),
+                      static_cast<unsigned long>(merge.guiFlushes),
+                      static_cast<unsigned long>(merge.ledForwarded),
+                      static_cast<unsigned long>(model.mergedCount(LiveStateModel::LEDS)),
+                      static_cast<unsigned long>(merge.ledFlushes));
+        const LiveController::PrefetchStats& prefetch = liveController.getPrefetchStats();
+        Serial.printf("Clip cache: %u bytes, %lu requests / %lu windows, %lu previews, %lu misses, %lu pads corrected\n",
+                      static_cast<unsigned>(sizeof(ClipPrefetchCache)),
+                      static_cast<unsigned long>(prefetch.requests),
+                      static_cast<unsigned long>(prefetch.windows),
+                      static_cast<unsigned long>(prefetch.previews),
+                      static_cast<unsigned long>(prefetch.previewMisses),
+                      static_cast<unsigned long>(prefetch.corrections));
+        const RingNavigator::Stats& nav = liveController.getRingNavStats();
+        Serial.printf("Ring nav: %lu presses sent as %lu positions, %lu clamped by Live, %lu unconfirmed\n",
+                      static_cast<unsigned long>(nav.moves),
+                      static_cast<unsigned long>(nav.positions),
+                      static_cast<unsigned long>(nav.clamped),
+                      static_cast<unsigned long>(nav.timeouts));
+        const LiveMeterStage::Stats& meterStats = liveController.getMeterStats();
+        Serial.printf("Meters: %lu readings → %lu frames, %lu ticks unchanged\n",
+                      static_cast<unsigned long>(meterStats.inputs),
+                      static_cast<unsigned long>(meterStats.frames),
+                      static_cast<unsigned long>(meterStats.unchanged));
+        const ClipPositionEstimator::Stats& positionStats = liveController.getPositionStats();
+        Serial.printf("Positions: %lu anchors from Live, %lu corrected the estimate, %lu frames\n",
+                      static_cast<unsigned long>(positionStats.anchors),
+                      static_cast<unsigned long>(positionStats.corrections),
+                      static_cast<unsigned long>(positionStats.frames));
+        const LiveController::NameStats& names = liveController.getNameStats();
+        const NamePool& pool = liveController.getNamePool();
+        Serial.printf("Names: %lu sent to GUI (%lu as strings by ID), %lu already there (%lu bytes saved); "
+                      "pool %u/%u names, %u/%u bytes, %lu evicted\n",
+                      static_cast<unsigned long>(names.sent),
+                      static_cast<unsigned long>(names.defines),
+                      static_cast<unsigned long>(names.skipped),
+                      static_cast<unsigned long>(names.bytesSaved),
+                      pool.entriesUsed(), NamePool::ENTRIES, pool.bytesUsed(), NamePool::BYTES,
+                      static_cast<unsigned long>(pool.getStats().evictions));
+        Serial.printf("Encoders: %lu turns started from Live's value instead of a stale one\n",
+                      static_cast<unsigned long>(getEncoderResyncs()));
         Serial.print("M4 connected: ");
         Serial.println(neoTrellisLink.isConnected() ? "YES" : "NO");
         Serial.print("GUI connected: ");
         Serial.println((guiLinkStarted && guiInterface.isConnected()) ? "YES" : "NO");
         Serial.print("Hardware ready: ");
         Serial.println(liveController.isHardwareReady() ? "YES" : "NO");
+        Serial.print("M4 TX queue pending: ");
+        Serial.print(neoTrellisLink.getTxQueue().pendingBytes());
+        Serial.println(" bytes");
+        neoTrellisLink.getTxQueue().printStats(Serial);
+        Serial.printf("M4 LED shadow: %lu pads sent, %lu unchanged pads skipped, %lu lost and resent, %lu frames (%s)\n",
+                      static_cast<unsigned long>(neoTrellisLink.getPadsSent()),
+                      static_cast<unsigned long>(neoTrellisLink.getPadsSkipped()),
+                      static_cast<unsigned long>(neoTrellisLink.getPadsLost()),
+                      static_cast<unsigned long>(neoTrellisLink.getPadFrames()),
+                      neoTrellisLink.getLinkMode().padFull ? "state+color" : "separate");
+        printLinkHealth("M4 link", uartHandler.getHealth());
+        if (uartHandler.hasPeerHealth()) {
+            printLinkHealth("M4 link (M4 end, last report)", uartHandler.getPeerHealth());
+        }
+        uartHandler.requestPeerHealth();
+        printLinkHealth("GUI link", guiInterface.getHealth());
+        printLinkBaud("M4 UART", neoTrellisLink.getBaud());
+        printLinkBaud("GUI UART", guiInterface.getBaud());
         return;
     }
 
@@ -111,6 +290,24 @@ static void handleSerialCommand(char* line) {
         return;
     }
 
+    if (strcmp(cmd, "resync") == 0) {
+        char* areaStr = strtok(nullptr, " ");
+        uint8_t areas = LiveSequenceTracker::AREA_ALL;
+        if (areaStr) {
+            if (strcmp(areaStr, "grid") == 0) areas = LiveSequenceTracker::AREA_GRID;
+            else if (strcmp(areaStr, "names") == 0) areas = LiveSequenceTracker::AREA_NAMES;
+            else if (strcmp(areaStr, "mixer") == 0) areas = LiveSequenceTracker::AREA_MIXER;
+            else if (strcmp(areaStr, "transport") == 0) areas = LiveSequenceTracker::AREA_TRANSPORT;
+            else if (strcmp(areaStr, "all") != 0) {
+                Serial.println("Usage: resync [grid|names|mixer|transport|all]");
+                return;
+            }
+        }
+        liveController.requestResync(areas);
+        Serial.printf("Resync of areas 0x%02X queued\n", areas);
+        return;
+    }
+
     if (strcmp(cmd, "pos") == 0) {
         // Absolute ring position (send 0x6A) — track/scene 14-bit, width/height, overview
         char* tStr = strtok(nullptr, " ");
@@ -194,9 +391,8 @@ void setup() {
 
     if (neoTrellisLink.isConnected()) {
         Serial.println("\n=== Step 2: GUI Interface Setup ===");
-        Serial2.begin(115200);
-        Serial.println("Serial2 (GUI link) initialized @ 115200 bps");
-        guiInterface.begin(Serial2);
+        guiInterface.begin(Serial2, GUI_BAUD_RATE);
+        Serial.printf("Serial2 (GUI link) initialized @ %lu bps\n", static_cast<unsigned long>(GUI_BAUD_RATE));
         guiLinkStarted = true;
         Serial.println("GUI Interface ready — awaiting GUI handshake");
     } else {
@@ -211,9 +407,8 @@ void setup() {
 void loop() {
     if (!guiLinkStarted && neoTrellisLink.isConnected()) {
         Serial.println("Teensy: NeoTrellis ready — starting GUI link");
-        Serial2.begin(115200);
-        Serial.println("Serial2 (GUI link) initialized @ 115200 bps");
-        guiInterface.begin(Serial2);
+        guiInterface.begin(Serial2, GUI_BAUD_RATE);
+        Serial.printf("Serial2 (GUI link) initialized @ %lu bps\n", static_cast<unsigned long>(GUI_BAUD_RATE));
         guiLinkStarted = true;
     }
 
@@ -228,8 +423,10 @@ void loop() {
     bool guiReady = guiLinkStarted && guiInterface.isConnected();
 
     if (liveController.isLiveConnected()) {
-        // Full operation mode - process limited MIDI per loop to avoid blocking UART
+        // Full operation mode - drain MIDI within a time budget so UART and pads stay responsive
         liveController.processMIDI();
+        // Frames produced by this MIDI batch go out without waiting for the wire
+        neoTrellisLink.serviceTx();
     } else {
         if (m4Ready && guiReady) {
             liveController.waitForLiveHandshake();
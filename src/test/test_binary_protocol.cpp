@@ -0,0 +1,561 @@
+/*
+ * TEST: BINARY PROTOCOL (BENCHMARK)
+ * =================================
+ *
+ * PROPÓSITO:
+ * Medir el coste de framing de BinaryProtocol en la Teensy 4.1:
+ *   - SYNC/XOR (0xAA + XOR, modo legado)
+ *   - COBS     (delimitador 0x00, negociado en el handshake)
+ *   - Integridad XOR / CRC-8 / CRC-16 (negociada en el handshake)
+ * Para cada tamaño de payload se mide encode (buildFrame) y decode
+ * (parseMessage / parseCobsMessage) en ciclos por frame y MB/s de payload,
+ * y se verifica que cada frame decodificado coincide con el original.
+ * Al final se mide el coste aislado del checksum para un frame
+ * LED_GRID_UPDATE_14 (192 bytes) y se cuentan los errores dobles que
+ * cada modo deja pasar.
+ * Por último compara el ring clips bulk (32 × LED_PAD_UPDATE + 32 ×
+ * LED_CLIP_STATE) enviado frame a frame frente a empaquetado en CMD_BATCH,
+ * y comprueba que un frame extendido (768 bytes, grid 16x8 de 14 bits)
+ * codificado en trozos de 64 bytes con FrameEncoder es idéntico al de
+ * buildFrame, y mide un CLIP_NAME enviado como slices (cabecera + vista
+ * del nombre) frente a copiarlo antes a un buffer de payload.
+ * Cierra con el FrameParser compartido por los enlaces: MB/s y ciclos por
+ * frame recibiendo frames de 192 bytes en trozos de 64, con frames corruptos
+ * intercalados para contar malos y resincronizaciones, y con el bloque de
+ * capacidades del handshake (CAPS2 y bloques cortos de firmware anterior).
+ * También comprueba la TxQueue que lleva esos frames al UART: un frame de pad
+ * pasa a la cola bulk si hay bulks pendientes (sin adelantarlos) y un frame
+ * que no cabe se descarta entero.
+ *
+ * HARDWARE:
+ * - Solo la Teensy 4.1 (no necesita M4 ni GUI conectados)
+ *
+ * CÓMO COMPILAR Y EJECUTAR:
+ * pio run -e test_binary_protocol_teensy -t upload && pio device monitor
+ *
+ * AUTOR: Push Clone Project
+ */
+
+#include <Arduino.h>
+#include "shared/BinaryProtocol.h"
+#include "shared/FrameParser.h"
+#include "TxQueue/TxQueue.h"
+
+// ========== CONFIGURACIÓN ==========
+const uint16_t ITERATIONS = 2000;
+// RGB_STATE, PAD_14, GRID, GRID_14, máximo corto, GRID_14 16x8 (extendido)
+const uint16_t PAYLOAD_SIZES[] = {4, 7, 96, 192, 254, 768};
+const uint8_t BENCH_COMMAND = CMD_LED_GRID_UPDATE_14;
+const uint16_t STREAM_CHUNK = 64;
+const uint16_t PARSER_FRAMES = 16; // Frames de 192 bytes en el flujo del parser
+
+uint8_t payload[BinaryProtocol::MAX_EXT_PAYLOAD_SIZE];
+uint8_t frame[BinaryProtocol::MAX_EXT_FRAME_SIZE];
+uint8_t scratch[BinaryProtocol::MAX_EXT_FRAME_SIZE];
+uint8_t parserStream[PARSER_FRAMES * (192 + 8)];
+FrameParser<BinaryProtocol::MAX_EXT_FRAME_SIZE> parser;
+
+// ========== FUNCIONES AUXILIARES ==========
+
+// Payload pseudoaleatorio de 8 bits (incluye 0x00 y 0xAA, como los colores reales)
+void fillPayload(uint16_t len, uint32_t seed) {
+    for (uint16_t i = 0; i < len; i++) {
+        seed = seed * 1664525UL + 1013904223UL;
+        payload[i] = static_cast<uint8_t>(seed >> 24);
+    }
+}
+
+uint16_t countFakeSyncBytes(uint16_t len) {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < len; i++) {
+        if (payload[i] == BinaryProtocol::BINARY_SYNC_BYTE) count++;
+    }
+    return count;
+}
+
+float cyclesToMBps(uint32_t cyclesPerFrame, uint16_t payloadLen) {
+    if (cyclesPerFrame == 0) return 0.0f;
+    float seconds = static_cast<float>(cyclesPerFrame) / static_cast<float>(F_CPU_ACTUAL);
+    return (static_cast<float>(payloadLen) / seconds) / 1.0e6f;
+}
+
+const char* integrityLabel(BinaryProtocol::Integrity integrity) {
+    switch (integrity) {
+        case BinaryProtocol::Integrity::CRC8:  return "CRC8 ";
+        case BinaryProtocol::Integrity::CRC16: return "CRC16";
+        default:                               return "XOR  ";
+    }
+}
+
+bool decodeFrame(const BinaryProtocol::LinkMode& mode, uint16_t frameLen,
+                 uint8_t& command, const uint8_t*& decoded, uint16_t& decodedLen) {
+    if (mode.framing == BinaryProtocol::Framing::COBS) {
+        // parseCobsMessage decodifica in-place: trabajar sobre una copia sin delimitadores
+        memcpy(scratch, &frame[1], frameLen - 2);
+        return BinaryProtocol::parseCobsMessage(scratch, frameLen - 2, command, decoded, decodedLen,
+                                                mode.integrity);
+    }
+    return BinaryProtocol::parseMessage(frame, frameLen, command, decoded, decodedLen, mode.integrity);
+}
+
+void benchFraming(const BinaryProtocol::LinkMode& mode, uint16_t payloadLen) {
+    fillPayload(payloadLen, payloadLen);
+
+    // Encode
+    uint16_t frameLen = 0;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        frameLen = BinaryProtocol::buildFrame(mode, BENCH_COMMAND, payload, payloadLen,
+                                              frame, sizeof(frame));
+    }
+    uint32_t encodeCycles = (ARM_DWT_CYCCNT - start) / ITERATIONS;
+
+    // Decode (incluye la copia a scratch en COBS, igual que un receptor real)
+    uint8_t command = 0;
+    const uint8_t* decoded = nullptr;
+    uint16_t decodedLen = 0;
+    bool ok = true;
+    start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        ok &= decodeFrame(mode, frameLen, command, decoded, decodedLen);
+    }
+    uint32_t decodeCycles = (ARM_DWT_CYCCNT - start) / ITERATIONS;
+
+    ok &= (command == BENCH_COMMAND) && (decodedLen == payloadLen);
+    ok &= (payloadLen == 0) || (memcmp(decoded, payload, payloadLen) == 0);
+
+    Serial.printf("│ %-4s │ %s │ %4u │ %4u │ %6lu │ %7.1f │ %6lu │ %7.1f │ %s │\n",
+                  mode.framing == BinaryProtocol::Framing::COBS ? "COBS" : "SYNC",
+                  integrityLabel(mode.integrity), payloadLen, frameLen,
+                  encodeCycles, cyclesToMBps(encodeCycles, payloadLen),
+                  decodeCycles, cyclesToMBps(decodeCycles, payloadLen),
+                  ok ? "OK  " : "FAIL");
+}
+
+// Coste aislado del checksum sobre CMD + LEN + payload
+void benchChecksum(BinaryProtocol::Integrity integrity, uint16_t payloadLen) {
+    fillPayload(payloadLen, payloadLen);
+    volatile uint16_t sink = 0;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = BinaryProtocol::computeChecksum(integrity, BENCH_COMMAND, payloadLen, payload);
+    }
+    uint32_t cycles = (ARM_DWT_CYCCNT - start) / ITERATIONS;
+    (void)sink;
+    Serial.printf("  %s: %5lu ciclos/frame (%.2f us), %6.1f MB/s\n",
+                  integrityLabel(integrity), cycles,
+                  static_cast<float>(cycles) * 1.0e6f / static_cast<float>(F_CPU_ACTUAL),
+                  cyclesToMBps(cycles, payloadLen));
+}
+
+// Invierte el mismo bit en dos bytes consecutivos del payload (el caso que el
+// XOR no ve) y cuenta cuántos frames corruptos pasan la validación
+uint16_t countUndetectedDoubleFlips(BinaryProtocol::Integrity integrity, uint16_t payloadLen,
+                                    uint16_t& tested) {
+    fillPayload(payloadLen, 0x5A);
+    uint16_t frameLen = BinaryProtocol::buildMessage(BENCH_COMMAND, payload, payloadLen,
+                                                     frame, sizeof(frame), integrity);
+    uint16_t undetected = 0;
+    uint8_t command = 0;
+    const uint8_t* decoded = nullptr;
+    uint16_t decodedLen = 0;
+    tested = 0;
+    for (uint16_t byteIndex = 3; byteIndex + 1 < 3 + payloadLen; byteIndex++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            frame[byteIndex] ^= (1 << bit);
+            frame[byteIndex + 1] ^= (1 << bit);
+            if (BinaryProtocol::parseMessage(frame, frameLen, command, decoded, decodedLen, integrity)) {
+                undetected++;
+            }
+            frame[byteIndex] ^= (1 << bit);
+            frame[byteIndex + 1] ^= (1 << bit);
+            tested++;
+        }
+    }
+    return undetected;
+}
+
+// Ring clips bulk: 64 frames sueltos frente a frames CMD_BATCH y frente a un
+// solo CMD_LED_PAD_FULL_BULK (estado y color juntos)
+void benchRingClipsBatch(const BinaryProtocol::LinkMode& mode) {
+    BinaryProtocol::Batch batch;
+    uint32_t singleBytes = 0;
+    uint32_t batchBytes = 0;
+    uint16_t singleFrames = 0;
+    uint16_t batchFrames = 0;
+
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint8_t pad = 0; pad < 32; pad++) {
+        uint8_t padData[] = {pad, 0x7E, 0x40, 0x12};
+        uint8_t stateData[] = {pad, CLIP_STATE_PLAYING};
+        singleBytes += BinaryProtocol::buildFrame(mode, CMD_LED_PAD_UPDATE, padData, sizeof(padData),
+                                                  frame, sizeof(frame));
+        singleBytes += BinaryProtocol::buildFrame(mode, CMD_LED_CLIP_STATE, stateData, sizeof(stateData),
+                                                  frame, sizeof(frame));
+        singleFrames += 2;
+    }
+    uint32_t singleCycles = ARM_DWT_CYCCNT - start;
+
+    start = ARM_DWT_CYCCNT;
+    for (uint8_t pad = 0; pad < 32; pad++) {
+        uint8_t padData[] = {pad, 0x7E, 0x40, 0x12};
+        uint8_t stateData[] = {pad, CLIP_STATE_PLAYING};
+        if (!batch.fits(sizeof(padData) + sizeof(stateData) + BinaryProtocol::BATCH_ENTRY_HEADER)) {
+            batchBytes += BinaryProtocol::buildFrame(mode, CMD_BATCH, batch.payload, batch.length,
+                                                     frame, sizeof(frame));
+            batchFrames++;
+            batch.clear();
+        }
+        batch.add(CMD_LED_PAD_UPDATE, padData, sizeof(padData));
+        batch.add(CMD_LED_CLIP_STATE, stateData, sizeof(stateData));
+    }
+    batchBytes += BinaryProtocol::buildFrame(mode, CMD_BATCH, batch.payload, batch.length,
+                                             frame, sizeof(frame));
+    batchFrames++;
+    uint32_t batchCycles = ARM_DWT_CYCCNT - start;
+
+    start = ARM_DWT_CYCCNT;
+    uint8_t fullData[4 + 32 * 4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    uint8_t fullLength = 4;
+    for (uint8_t pad = 0; pad < 32; pad++) {
+        fullData[fullLength++] = CLIP_STATE_PLAYING;
+        fullData[fullLength++] = 0x7E;
+        fullData[fullLength++] = 0x40;
+        fullData[fullLength++] = 0x12;
+    }
+    const uint32_t fullBytes = BinaryProtocol::buildFrame(mode, CMD_LED_PAD_FULL_BULK, fullData, fullLength,
+                                                          frame, sizeof(frame));
+    uint32_t fullCycles = ARM_DWT_CYCCNT - start;
+
+    Serial.printf("  %s/%s: sueltos %2u frames %4lu bytes %6lu ciclos | batch %u frames %4lu bytes %6lu ciclos"
+                  " | pad full 1 frame %4lu bytes %6lu ciclos\n",
+                  BinaryProtocol::framingName(mode.framing), BinaryProtocol::integrityName(mode.integrity),
+                  singleFrames, singleBytes, singleCycles, batchFrames, batchBytes, batchCycles,
+                  fullBytes, fullCycles);
+}
+
+// Frame extendido codificado en trozos de STREAM_CHUNK bytes (sin buffer
+// contiguo de payload) frente a buildFrame de una vez
+void checkChunkedEncode(const BinaryProtocol::LinkMode& mode, uint16_t payloadLen) {
+    fillPayload(payloadLen, 0x33);
+    const uint16_t frameLen = BinaryProtocol::buildFrame(mode, BENCH_COMMAND, payload, payloadLen,
+                                                         frame, sizeof(frame));
+
+    BinaryProtocol::BufferSink sink(scratch, sizeof(scratch));
+    BinaryProtocol::FrameEncoder<BinaryProtocol::BufferSink> encoder(sink, mode);
+    uint32_t start = ARM_DWT_CYCCNT;
+    bool ok = encoder.begin(BENCH_COMMAND, payloadLen);
+    for (uint16_t offset = 0; offset < payloadLen; offset += STREAM_CHUNK) {
+        const uint16_t remaining = payloadLen - offset;
+        const uint16_t chunk = remaining < STREAM_CHUNK ? remaining : STREAM_CHUNK;
+        ok &= encoder.write(&payload[offset], chunk);
+    }
+    ok &= encoder.finish();
+    uint32_t cycles = ARM_DWT_CYCCNT - start;
+
+    ok &= !sink.overflow && sink.length == frameLen && memcmp(scratch, frame, frameLen) == 0;
+    Serial.printf("  %s/%s: %u bytes en cable, %lu ciclos, %s\n",
+                  BinaryProtocol::framingName(mode.framing), BinaryProtocol::integrityName(mode.integrity),
+                  frameLen, cycles, ok ? "idéntico" : "FAIL");
+}
+
+// CLIP_NAME de 32 caracteres: copia a un payload contiguo + buildFrame
+// frente a FrameEncoder con dos slices (cabecera y vista del nombre)
+void benchScatterGather(const BinaryProtocol::LinkMode& mode) {
+    const char name[] = "Bass Loop 03 (Resampled) - Take2";
+    const uint16_t nameLen = sizeof(name) - 1;
+    const uint8_t header[] = {0x05, 0x02};
+
+    uint16_t copyLen = 0;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        memcpy(payload, header, sizeof(header));
+        memcpy(&payload[sizeof(header)], name, nameLen);
+        copyLen = BinaryProtocol::buildFrame(mode, CMD_CLIP_NAME, payload, sizeof(header) + nameLen,
+                                             frame, sizeof(frame));
+    }
+    uint32_t copyCycles = (ARM_DWT_CYCCNT - start) / ITERATIONS;
+
+    const BinaryProtocol::Slice slices[] = {
+        {header, sizeof(header)},
+        {reinterpret_cast<const uint8_t*>(name), nameLen}
+    };
+    uint16_t sliceLen = 0;
+    start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        BinaryProtocol::BufferSink sink(scratch, sizeof(scratch));
+        BinaryProtocol::FrameEncoder<BinaryProtocol::BufferSink> encoder(sink, mode);
+        encoder.begin(CMD_CLIP_NAME, BinaryProtocol::sliceLength(slices, 2));
+        encoder.write(slices, 2);
+        encoder.finish();
+        sliceLen = sink.length;
+    }
+    uint32_t sliceCycles = (ARM_DWT_CYCCNT - start) / ITERATIONS;
+
+    const bool ok = sliceLen == copyLen && memcmp(scratch, frame, copyLen) == 0;
+    Serial.printf("  %s/%s: copia %4lu ciclos | slices %4lu ciclos | %s\n",
+                  BinaryProtocol::framingName(mode.framing), BinaryProtocol::integrityName(mode.integrity),
+                  copyCycles, sliceCycles, ok ? "idéntico" : "FAIL");
+}
+
+// FrameParser: flujo de PARSER_FRAMES frames LED_GRID_UPDATE_14 entregado en
+// trozos de STREAM_CHUNK bytes, como llega de readBytes(). Un frame de cada
+// cuatro lleva un byte corrupto para medir también la resincronización.
+void benchFrameParser(const BinaryProtocol::LinkMode& mode) {
+    uint16_t streamLen = 0;
+    for (uint16_t f = 0; f < PARSER_FRAMES; f++) {
+        fillPayload(192, 0x100 + f);
+        const uint16_t frameLen = BinaryProtocol::buildFrame(mode, BENCH_COMMAND, payload, 192,
+                                                             &parserStream[streamLen],
+                                                             sizeof(parserStream) - streamLen);
+        if (f % 4 == 3) {
+            parserStream[streamLen + frameLen / 2] ^= 0x10;
+        }
+        streamLen += frameLen;
+    }
+
+    parser.reset();
+    parser.resetStats();
+    uint32_t delivered = 0;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t i = 0; i < ITERATIONS / 10; i++) {
+        for (uint16_t offset = 0; offset < streamLen; offset += STREAM_CHUNK) {
+            const uint16_t remaining = streamLen - offset;
+            const uint16_t chunk = remaining < STREAM_CHUNK ? remaining : STREAM_CHUNK;
+            parser.feed(&parserStream[offset], chunk, mode, 0, [&](const FrameView& view) {
+                delivered += view.length;
+            });
+        }
+    }
+    uint32_t cycles = ARM_DWT_CYCCNT - start;
+
+    const FrameParserStats& stats = parser.getStats();
+    const uint32_t cyclesPerFrame = stats.frames ? cycles / stats.frames : 0;
+    const float seconds = static_cast<float>(cycles) / static_cast<float>(F_CPU_ACTUAL);
+    const float mbps = seconds > 0.0f ? (static_cast<float>(stats.bytes) / seconds) / 1.0e6f : 0.0f;
+    const bool ok = stats.frames == static_cast<uint32_t>(ITERATIONS / 10) * (PARSER_FRAMES - PARSER_FRAMES / 4) &&
+                    delivered == stats.frames * 192;
+    Serial.printf("  %s/%s: %6.1f MB/s | %5lu ciclos/frame | frames %lu malos %lu resync %lu | %s\n",
+                  BinaryProtocol::framingName(mode.framing), BinaryProtocol::integrityName(mode.integrity),
+                  mbps, cyclesPerFrame,
+                  static_cast<unsigned long>(stats.frames),
+                  static_cast<unsigned long>(stats.badFrames),
+                  static_cast<unsigned long>(stats.resyncs),
+                  ok ? "OK" : "FAIL");
+}
+
+// Bloque de capacidades: ida y vuelta con CAPS2, y bloques cortos de peers anteriores
+bool checkCapsBlock() {
+    static const uint8_t id[] = {'P', 'U', 'S', 'H'};
+    BinaryProtocol::LinkCaps caps;
+    caps.flags = BinaryProtocol::CAP_COBS | BinaryProtocol::CAP_NAME_IDS | BinaryProtocol::CAP_LED_PAD_FULL;
+    caps.maxBaud = 2000000;
+    caps.maxPayload = BinaryProtocol::MAX_EXT_PAYLOAD_SIZE;
+    uint8_t block[sizeof(id) + BinaryProtocol::CAPS_BLOCK_SIZE];
+    const uint8_t length = BinaryProtocol::appendCaps(id, sizeof(id), caps, block, sizeof(block));
+
+    BinaryProtocol::LinkCaps full;
+    bool ok = BinaryProtocol::findCaps(block, length, full) && full.flags == caps.flags &&
+              full.maxBaud == caps.maxBaud && full.maxPayload == caps.maxPayload;
+    // NAME_IDS y PAD_FULL son bits distintos: un enlace sin uno no recibe el otro
+    BinaryProtocol::LinkCaps guiOnly;
+    guiOnly.flags = BinaryProtocol::CAP_COBS | BinaryProtocol::CAP_NAME_IDS;
+    const BinaryProtocol::LinkMode guiMode = BinaryProtocol::modeFromCaps(BinaryProtocol::agreeCaps(guiOnly, full));
+    ok &= guiMode.nameIds && !guiMode.padFull;
+    Serial.printf("  Bloque de %u bytes: flags 0x%04X ida y vuelta, GUI sin PAD_FULL → nameIds %u padFull %u | %s\n",
+                  BinaryProtocol::CAPS_BLOCK_SIZE, full.flags, guiMode.nameIds, guiMode.padFull,
+                  ok ? "OK" : "FAIL");
+
+    // Peer anterior: bloque sin CAPS2, flags altos desconocidos
+    BinaryProtocol::LinkCaps v1;
+    const bool v1Ok = BinaryProtocol::findCaps(block, length - 1, v1) &&
+                      v1.flags == (caps.flags & 0x7F) && v1.maxBaud == caps.maxBaud;
+    // Solo [CAPS]: velocidad base y límite del formato de frame
+    BinaryProtocol::LinkCaps bare;
+    const bool bareOk = BinaryProtocol::findCaps(block, sizeof(id) + 2, bare) &&
+                        bare.flags == (caps.flags & 0x7F) && bare.maxBaud == 0;
+    Serial.printf("  Bloque sin CAPS2: flags 0x%04X | %s. Solo CAPS: baud %lu | %s\n",
+                  v1.flags, v1Ok ? "OK" : "FAIL", static_cast<unsigned long>(bare.maxBaud),
+                  bareOk ? "OK" : "FAIL");
+    return ok && v1Ok && bareOk;
+}
+
+// Puerto de prueba: el driver acepta los bytes que se le dejan en room y
+// quedan en orden en bytes
+class CapturePort : public Stream {
+public:
+    uint16_t room = 0;
+    uint16_t count = 0;
+    uint8_t bytes[1024];
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    int availableForWrite() override { return room; }
+    size_t write(uint8_t value) override { return write(&value, 1); }
+    size_t write(const uint8_t* data, size_t length) override {
+        for (size_t i = 0; i < length && count < sizeof(bytes); i++) {
+            bytes[count++] = data[i];
+        }
+        room -= static_cast<uint16_t>(length);
+        return length;
+    }
+};
+
+// TxQueue con el driver lleno: un pad detrás de un bulk se degrada a bulk y
+// sale después de él; con la cola de control llena el frame se descarta sin
+// dejar bytes a medias
+bool checkTxQueue() {
+    static CapturePort port;
+    static TxQueue queue(port);
+    uint8_t frame[100];
+
+    memset(frame, 'B', 8);
+    queue.push(TxQueue::PRIORITY_BULK, frame, 8);
+    memset(frame, 'P', 4);
+    queue.push(TxQueue::PRIORITY_PAD, frame, 4);
+    memset(frame, 'C', 2);
+    queue.push(TxQueue::PRIORITY_CONTROL, frame, 2);
+    port.room = 64;
+    queue.drain();
+    static const char ORDER[] = "CCBBBBBBBBPPPP";
+    const bool demoteOk = queue.getStats(TxQueue::PRIORITY_PAD).framesDemoted == 1 &&
+                          queue.getStats(TxQueue::PRIORITY_BULK).framesSent == 2 &&
+                          port.count == sizeof(ORDER) - 1 && memcmp(port.bytes, ORDER, port.count) == 0;
+
+    // Sin bulks pendientes el pad va por su cola
+    port.count = 0;
+    port.room = 0;
+    queue.push(TxQueue::PRIORITY_PAD, frame, 4);
+    const bool padOk = queue.getStats(TxQueue::PRIORITY_PAD).framesDemoted == 1 &&
+                       queue.getStats(TxQueue::PRIORITY_PAD).framesQueued == 1;
+
+    // Control (512 bytes): caben cuatro frames de 100 + cabecera, el quinto no
+    memset(frame, 'C', sizeof(frame));
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        accepted += queue.push(TxQueue::PRIORITY_CONTROL, frame, sizeof(frame));
+    }
+    port.room = 1024;
+    queue.drain();
+    const TxQueue::ClassStats& control = queue.getStats(TxQueue::PRIORITY_CONTROL);
+    const bool dropOk = accepted == 4 && control.framesDropped == 1 && control.framesSent == 5 &&
+                        port.count == 4 * sizeof(frame) + 4 && queue.isEmpty();
+
+    const bool ok = demoteOk && padOk && dropOk;
+    Serial.printf("  TxQueue: pad tras bulk degradado y en orden %s, pad solo en su cola %s, "
+                  "cola llena descarta entero %s | %s\n",
+                  demoteOk ? "sí" : "no", padOk ? "sí" : "no", dropOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ========== SETUP ==========
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000);
+    delay(1000);
+
+    Serial.println();
+    Serial.println("╔══════════════════════════════════════════╗");
+    Serial.println("║  TEST: BINARY PROTOCOL BENCH (Teensy)   ║");
+    Serial.println("╚══════════════════════════════════════════╝");
+    Serial.println();
+
+    // Habilitar contador de ciclos DWT
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+
+    Serial.printf("CPU: %lu MHz, %u iteraciones por medida\n\n",
+                  static_cast<unsigned long>(F_CPU_ACTUAL / 1000000UL), ITERATIONS);
+
+    const BinaryProtocol::Integrity integrities[] = {
+        BinaryProtocol::Integrity::XOR,
+        BinaryProtocol::Integrity::CRC8,
+        BinaryProtocol::Integrity::CRC16
+    };
+
+    Serial.println("┌──────┬───────┬──────┬──────┬────────┬─────────┬────────┬─────────┬──────┐");
+    Serial.println("│ Mode │ Integ │ Len  │ Wire │ Enc cyc│ Enc MB/s│ Dec cyc│ Dec MB/s│ Chk  │");
+    Serial.println("├──────┼───────┼──────┼──────┼────────┼─────────┼────────┼─────────┼──────┤");
+    for (uint8_t i = 0; i < sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]); i++) {
+        for (BinaryProtocol::Integrity integrity : integrities) {
+            BinaryProtocol::LinkMode mode;
+            mode.integrity = integrity;
+            mode.framing = BinaryProtocol::Framing::SYNC;
+            benchFraming(mode, PAYLOAD_SIZES[i]);
+            mode.framing = BinaryProtocol::Framing::COBS;
+            benchFraming(mode, PAYLOAD_SIZES[i]);
+        }
+    }
+    Serial.println("└──────┴───────┴──────┴──────┴────────┴─────────┴────────┴─────────┴──────┘");
+
+    Serial.println("\nChecksum aislado, frame LED_GRID_UPDATE_14 (192 bytes):");
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        benchChecksum(integrity, 192);
+    }
+
+    Serial.println("\nErrores dobles no detectados (mismo bit en bytes consecutivos, 192 bytes):");
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        uint16_t tested = 0;
+        uint16_t undetected = countUndetectedDoubleFlips(integrity, 192, tested);
+        Serial.printf("  %s: %u / %u\n", integrityLabel(integrity), undetected, tested);
+    }
+
+    Serial.println("\nBytes 0xAA en payload (falsos SYNC en modo legado):");
+    for (uint8_t i = 0; i < sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]); i++) {
+        fillPayload(PAYLOAD_SIZES[i], PAYLOAD_SIZES[i]);
+        Serial.printf("  %4u bytes → %u\n", PAYLOAD_SIZES[i], countFakeSyncBytes(PAYLOAD_SIZES[i]));
+    }
+
+    Serial.println("\nRing clips bulk (32 pads, LED_PAD_UPDATE + LED_CLIP_STATE):");
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        BinaryProtocol::LinkMode mode;
+        mode.integrity = integrity;
+        mode.framing = BinaryProtocol::Framing::SYNC;
+        benchRingClipsBatch(mode);
+        mode.framing = BinaryProtocol::Framing::COBS;
+        benchRingClipsBatch(mode);
+    }
+
+    Serial.printf("\nFrame extendido de 768 bytes codificado en trozos de %u bytes:\n", STREAM_CHUNK);
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        BinaryProtocol::LinkMode mode;
+        mode.integrity = integrity;
+        mode.framing = BinaryProtocol::Framing::SYNC;
+        checkChunkedEncode(mode, 768);
+        mode.framing = BinaryProtocol::Framing::COBS;
+        checkChunkedEncode(mode, 768);
+    }
+
+    Serial.println("\nCLIP_NAME (32 caracteres), copia previa frente a scatter-gather:");
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        BinaryProtocol::LinkMode mode;
+        mode.integrity = integrity;
+        mode.framing = BinaryProtocol::Framing::SYNC;
+        benchScatterGather(mode);
+        mode.framing = BinaryProtocol::Framing::COBS;
+        benchScatterGather(mode);
+    }
+
+    Serial.printf("\nFrameParser (%u frames de 192 bytes, 1 de cada 4 corrupto, trozos de %u bytes):\n",
+                  PARSER_FRAMES, STREAM_CHUNK);
+    for (BinaryProtocol::Integrity integrity : integrities) {
+        BinaryProtocol::LinkMode mode;
+        mode.integrity = integrity;
+        mode.framing = BinaryProtocol::Framing::SYNC;
+        benchFrameParser(mode);
+        mode.framing = BinaryProtocol::Framing::COBS;
+        benchFrameParser(mode);
+    }
+
+    Serial.println("\nBloque de capacidades del handshake:");
+    checkCapsBlock();
+
+    Serial.println("\nCola de transmisión al UART:");
+    checkTxQueue();
+    Serial.println("\n✓ Benchmark completo");
+}
+
+// ========== LOOP PRINCIPAL ==========
+void loop() {
+}
@@ -0,0 +1,790 @@
+/*
+ * TEST: LIVE COMMAND DISPATCH (BENCHMARK)
+ * =======================================
+ *
+ * PROPÓSITO:
+ * Medir el coste por mensaje de despachar comandos SysEx de Live con
+ * LiveCommandTable (tabla constexpr indexada por comando: handler,
+ * longitud mínima/máxima y flags) frente a un switch con las
+ * comprobaciones de longitud repartidas por cada case, como estaba
+ * LiveController::processMIDI.
+ * El flujo imita lo que envía Live al cargar un set: nombres y colores de
+ * pistas, 32 nombres y estados de clip, mixer, tempo, comandos ignorados,
+ * algún payload corto y un comando desconocido.
+ * Los handlers solo acumulan un byte del payload, así que lo medido es el
+ * despacho en sí (validación + llamada), no el reenvío a M4/GUI.
+ * Después mide LiveStateModel: memoria ocupada y coste de cada
+ * actualización, la primera vez (cambia el valor) y al repetirla (sin
+ * cambio, el caso que evita reenviar a la GUI), y cuántas actualizaciones
+ * de una automatización de mixer se fusionan entre dos flushes a 60 Hz.
+ * Por último compara los bytes hacia la GUI de reenviar cada
+ * CMD_TRACK_METER frente a los frames de LiveMeterStage (y comprueba su caída,
+ * el pico sostenido y que una señal estable no genera frames), y lo mismo con las
+ * posiciones de clip extrapoladas por ClipPositionEstimator, y los nombres del
+ * ring enviados como texto frente a IDs de NamePool, con las reglas del pool
+ * (desalojo, generaciones, pool lleno) comprobadas aparte.
+ * Cierra con la entrada de Live: LiveSysExAssembler con SysEx partido en
+ * trozos, truncado y más grande que el buffer, y LiveSequenceTracker con SEQ
+ * que da la vuelta en 128, duplicados y huecos, y CMD_SESSION_RING_METADATA
+ * con un nombre más largo que el buffer del handler.
+ *
+ * HARDWARE:
+ * - Solo la Teensy 4.1 (no necesita Live, M4 ni GUI conectados)
+ *
+ * CÓMO COMPILAR Y EJECUTAR:
+ * pio run -e test_live_dispatch_teensy -t upload && pio device monitor
+ *
+ * AUTOR: Push Clone Project
+ */
+
+#include <Arduino.h>
+#include "MidiCommands.h"
+#include "LiveController/LiveCommandTable.h"
+#include "LiveStateModel/LiveStateModel.h"
+#include "LiveController/LiveMeterStage.h"
+#include "LiveController/ClipPositionEstimator.h"
+#include "LiveStateModel/NamePool.h"
+#include "LiveController/LiveSysExAssembler.h"
+#include "LiveController/LiveSequenceTracker.h"
+#include "LiveController/RingMetadataReader.h"
+#include "shared/BinaryProtocol.h"
+#include <math.h>
+
+// ========== CONFIGURACIÓN ==========
+const uint16_t ITERATIONS = 200;   // Pasadas sobre el flujo completo
+const uint16_t MAX_MESSAGES = 192;
+const uint16_t MAX_STREAM_BYTES = 4096;
+const uint8_t METER_FRAME_OVERHEAD = 5; // SYNC, CMD, LEN, XOR, fin (aprox.)
+
+struct BenchMessage {
+    uint8_t command;
+    uint16_t offset;
+    uint16_t length;
+};
+
+uint8_t streamBytes[MAX_STREAM_BYTES];
+BenchMessage messages[MAX_MESSAGES];
+uint16_t messageCount = 0;
+uint16_t streamLen = 0;
+
+// ========== HANDLERS DE PRUEBA ==========
+struct BenchTarget {
+    uint32_t sum = 0;
+    uint32_t calls = 0;
+
+    void onPayload(uint8_t command, const uint8_t* payload, uint16_t length) {
+        sum += command + (length ? payload[0] : 0);
+        calls++;
+    }
+};
+
+// Mismas longitudes que la tabla de LiveController para estos comandos
+constexpr LiveCommandTable<BenchTarget> buildBenchTable() {
+    using BT = BenchTarget;
+
+    LiveCommandTable<BenchTarget> table;
+    table.on(CMD_GRID_SINGLE_PAD, &BT::onPayload, 7);
+    table.on(CMD_CLIP_STATE, &BT::onPayload, 9);
+    table.on(CMD_CLIP_NAME, &BT::onPayload, 3);
+    table.on(CMD_TRACK_NAME, &BT::onPayload, 2);
+    table.on(CMD_TRACK_COLOR, &BT::onPayload, 4);
+    table.on(CMD_TRACK_VOLUME, &BT::onPayload, 3);
+    table.on(CMD_TRACK_PAN, &BT::onPayload, 3);
+    table.on(CMD_TRACK_MUTE, &BT::onPayload, 2);
+    table.on(CMD_TRACK_SOLO, &BT::onPayload, 2);
+    table.on(CMD_TRACK_ARM, &BT::onPayload, 2);
+    table.on(CMD_TEMPO, &BT::onPayload, 2);
+    table.on(CMD_TRANSPORT_POSITION, &BT::onPayload, 2);
+    table.ignore(CMD_TRACK_PLAYING_SLOT);
+    return table;
+}
+
+constexpr LiveCommandTable<BenchTarget> benchTable = buildBenchTable();
+
+// Referencia: un case por comando con su propia comprobación de longitud
+LiveCommand::Result dispatchSwitch(BenchTarget& target, uint8_t command,
+                                   const uint8_t* payload, uint16_t length) {
+    switch (command) {
+        case CMD_GRID_SINGLE_PAD:
+            if (length < 7) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_CLIP_STATE:
+            if (length < 9) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_CLIP_NAME:
+            if (length < 3) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_TRACK_NAME:
+        case CMD_TRACK_MUTE:
+        case CMD_TRACK_SOLO:
+        case CMD_TRACK_ARM:
+        case CMD_TEMPO:
+        case CMD_TRANSPORT_POSITION:
+            if (length < 2) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_TRACK_COLOR:
+            if (length < 4) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_TRACK_VOLUME:
+        case CMD_TRACK_PAN:
+            if (length < 3) return LiveCommand::Result::BAD_LENGTH;
+            target.onPayload(command, payload, length);
+            return LiveCommand::Result::HANDLED;
+        case CMD_TRACK_PLAYING_SLOT:
+            return LiveCommand::Result::IGNORED;
+        default:
+            return LiveCommand::Result::UNKNOWN;
+    }
+}
+
+// Aplica un mensaje del flujo al modelo como lo hacen los handlers de
+// LiveController; devuelve si cambió algo
+bool applyToModel(LiveStateModel& model, const BenchMessage& msg) {
+    const uint8_t* p = &streamBytes[msg.offset];
+    switch (msg.command) {
+        case CMD_CLIP_STATE: {
+            if (msg.length < 9) return false;
+            const uint8_t pad = static_cast<uint8_t>((p[1] * GRID_TRACKS + p[0]) % TOTAL_KEYS);
+            const bool s = model.setClipState(pad, p[2]);
+            return model.setClipColor(pad, p[3] << 1, p[5] << 1, p[7] << 1) || s;
+        }
+        case CMD_TRACK_COLOR:
+            return model.setTrackColor(p[0], p[1], p[2], p[3]);
+        case CMD_TRACK_VOLUME:
+            return model.setVolume(p[0], static_cast<uint16_t>((p[1] << 7) | p[2]));
+        case CMD_TRACK_PAN:
+            return model.setPan(p[0], static_cast<uint16_t>((p[1] << 7) | p[2]));
+        case CMD_TRACK_MUTE:
+            return model.setMute(p[0], p[1] != 0);
+        case CMD_TRACK_SOLO:
+            return model.setSolo(p[0], p[1] != 0);
+        case CMD_TRACK_ARM:
+            return model.setArm(p[0], p[1] != 0);
+        case CMD_TEMPO:
+            return model.setTempo(static_cast<uint16_t>((p[0] << 7) | p[1]));
+        default:
+            return false;
+    }
+}
+
+// ========== FUNCIONES AUXILIARES ==========
+
+void addMessage(uint8_t command, uint16_t length, uint8_t seed) {
+    if (messageCount >= MAX_MESSAGES || streamLen + length > MAX_STREAM_BYTES) {
+        return;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        streamBytes[streamLen + i] = static_cast<uint8_t>((seed + i * 7) & 0x7F);
+    }
+    messages[messageCount++] = {command, streamLen, length};
+    streamLen += length;
+}
+
+// Lo que llega de Live justo después de cargar un set
+void buildSetLoadStream() {
+    messageCount = 0;
+    streamLen = 0;
+    for (uint8_t t = 0; t < 8; t++) {
+        addMessage(CMD_TRACK_NAME, 1 + 12, t);
+        addMessage(CMD_TRACK_COLOR, 4, t);
+        addMessage(CMD_TRACK_VOLUME, 3, t);
+        addMessage(CMD_TRACK_PAN, 3, t);
+        addMessage(CMD_TRACK_MUTE, 2, t);
+        addMessage(CMD_TRACK_SOLO, 2, t);
+        addMessage(CMD_TRACK_ARM, 2, t);
+        addMessage(CMD_TRACK_PLAYING_SLOT, 2, t);
+    }
+    for (uint8_t pad = 0; pad < 32; pad++) {
+        addMessage(CMD_CLIP_NAME, 2 + 16, pad);
+        addMessage(CMD_CLIP_STATE, 9, pad);
+    }
+    for (uint8_t pad = 0; pad < 16; pad++) {
+        addMessage(CMD_GRID_SINGLE_PAD, 7, pad);
+        addMessage(CMD_TRANSPORT_POSITION, 3, pad);
+    }
+    addMessage(CMD_TEMPO, 2, 0);
+    addMessage(CMD_CLIP_STATE, 4, 0);    // Payload corto
+    addMessage(CMD_TRACK_NAME, 1, 0);    // Payload corto
+    addMessage(CMD_CREATE_SCENE, 1, 0);  // Sin entrada
+}
+
+// Tabla frente a switch sobre el flujo de carga de un set
+void benchDispatch() {
+    BenchTarget tableTarget;
+    LiveCommand::Stats tableStats;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t it = 0; it < ITERATIONS; it++) {
+        for (uint16_t m = 0; m < messageCount; m++) {
+            const BenchMessage& msg = messages[m];
+            tableStats.count(benchTable.dispatch(tableTarget, msg.command,
+                                                 &streamBytes[msg.offset], msg.length));
+        }
+    }
+    const uint32_t tableCycles = ARM_DWT_CYCCNT - start;
+
+    BenchTarget switchTarget;
+    LiveCommand::Stats switchStats;
+    start = ARM_DWT_CYCCNT;
+    for (uint16_t it = 0; it < ITERATIONS; it++) {
+        for (uint16_t m = 0; m < messageCount; m++) {
+            const BenchMessage& msg = messages[m];
+            switchStats.count(dispatchSwitch(switchTarget, msg.command,
+                                             &streamBytes[msg.offset], msg.length));
+        }
+    }
+    const uint32_t switchCycles = ARM_DWT_CYCCNT - start;
+
+    const uint32_t total = static_cast<uint32_t>(ITERATIONS) * messageCount;
+    const bool ok = tableTarget.sum == switchTarget.sum && tableTarget.calls == switchTarget.calls &&
+                    tableStats.handled == switchStats.handled &&
+                    tableStats.ignored == switchStats.ignored &&
+                    tableStats.badLength == switchStats.badLength &&
+                    tableStats.unknown == switchStats.unknown;
+
+    Serial.printf("  Tabla : %4lu ciclos/mensaje (%.2f µs)\n",
+                  static_cast<unsigned long>(tableCycles / total),
+                  static_cast<float>(tableCycles) / total / (F_CPU_ACTUAL / 1.0e6f));
+    Serial.printf("  Switch: %4lu ciclos/mensaje (%.2f µs)\n",
+                  static_cast<unsigned long>(switchCycles / total),
+                  static_cast<float>(switchCycles) / total / (F_CPU_ACTUAL / 1.0e6f));
+    Serial.printf("  Por pasada: %lu despachados, %lu ignorados, %lu longitud inválida, %lu desconocidos | %s\n",
+                  static_cast<unsigned long>(tableStats.handled / ITERATIONS),
+                  static_cast<unsigned long>(tableStats.ignored / ITERATIONS),
+                  static_cast<unsigned long>(tableStats.badLength / ITERATIONS),
+                  static_cast<unsigned long>(tableStats.unknown / ITERATIONS),
+                  ok ? "OK" : "FAIL");
+    Serial.printf("  Tamaño de la tabla: %u bytes\n", static_cast<unsigned>(sizeof(benchTable)));
+}
+
+// LiveStateModel: coste de cada actualización la primera vez y al repetirla
+void benchModel() {
+    static LiveStateModel model;
+    uint16_t updates = 0;
+    uint16_t firstChanges = 0;
+    uint32_t start = ARM_DWT_CYCCNT;
+    for (uint16_t m = 0; m < messageCount; m++) {
+        firstChanges += applyToModel(model, messages[m]);
+    }
+    const uint32_t firstCycles = ARM_DWT_CYCCNT - start;
+    for (uint16_t m = 0; m < messageCount; m++) {
+        switch (messages[m].command) {
+            case CMD_CLIP_STATE: case CMD_TRACK_COLOR:
+            case CMD_TRACK_VOLUME: case CMD_TRACK_PAN: case CMD_TRACK_MUTE:
+            case CMD_TRACK_SOLO: case CMD_TRACK_ARM: case CMD_TEMPO:
+                updates++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    uint16_t repeatChanges = 0;
+    start = ARM_DWT_CYCCNT;
+    for (uint16_t it = 0; it < ITERATIONS; it++) {
+        for (uint16_t m = 0; m < messageCount; m++) {
+            repeatChanges += applyToModel(model, messages[m]);
+        }
+    }
+    const uint32_t repeatCycles = ARM_DWT_CYCCNT - start;
+    const bool modelOk = firstChanges > 0 && repeatChanges == 0 &&
+                         model.version(LiveStateModel::TRACK_VOLUME) > 0;
+
+    Serial.printf("  LiveStateModel: %u bytes\n", static_cast<unsigned>(sizeof(LiveStateModel)));
+    Serial.printf("  Primera carga: %u actualizaciones, %u cambios, %lu ciclos/actualización\n",
+                  updates, firstChanges,
+                  static_cast<unsigned long>(updates ? firstCycles / updates : 0));
+    Serial.printf("  Repetida (sin cambios): %lu ciclos/actualización | %s\n",
+                  static_cast<unsigned long>(updates ? repeatCycles / (static_cast<uint32_t>(ITERATIONS) * updates) : 0),
+                  modelOk ? "OK" : "FAIL");
+}
+
+// Fusión de una automatización de volumen en 4 pistas, ~1 kHz por pista
+// Entre dos flushes de la GUI (16.7 ms) llegan ~16 valores por pista
+void benchAutomation() {
+    LiveStateModel automation;
+    automation.subscribe(LiveStateModel::GUI, LiveStateModel::fieldBit(LiveStateModel::TRACK_VOLUME));
+    const uint16_t FRAMES = 60;
+    const uint8_t VALUES_PER_FRAME = 16;
+    uint32_t changes = 0;
+    uint32_t forwarded = 0;
+    for (uint16_t frame = 0; frame < FRAMES; frame++) {
+        for (uint8_t v = 0; v < VALUES_PER_FRAME; v++) {
+            for (uint8_t track = 0; track < 4; track++) {
+                const uint16_t value = static_cast<uint16_t>((frame * VALUES_PER_FRAME + v) * 11 + track);
+                changes += automation.setVolume(track, value & 0x3FFF);
+            }
+        }
+        const uint32_t dirty = automation.takeDirty(LiveStateModel::GUI, LiveStateModel::TRACK_VOLUME);
+        for (uint8_t track = 0; track < 4; track++) {
+            forwarded += (dirty >> track) & 1UL;
+        }
+    }
+    const uint32_t merged = automation.mergedCount(LiveStateModel::GUI);
+    Serial.printf("  Automatización (1 s): %lu cambios → %lu enviados, %lu fusionados | %s\n",
+                  static_cast<unsigned long>(changes), static_cast<unsigned long>(forwarded),
+                  static_cast<unsigned long>(merged),
+                  forwarded + merged == changes && forwarded == FRAMES * 4UL ? "OK" : "FAIL");
+}
+
+// Medidores de 8 pistas a 20 Hz durante 3 s, frames a LIVE_METER_HZ
+// Primer segundo: pistas 0-3 con señal que varía, 4-5 estables, 6-7 en
+// silencio. Después las 0-3 también se quedan estables
+void benchMeters() {
+    LiveMeterStage meters;
+    const uint16_t DURATION_MS = 3000;
+    uint32_t readings = 0;
+    uint32_t meterBytes = 0;
+    uint8_t frame[LiveMeterStage::MAX_FRAME];
+    for (uint32_t ms = 0; ms < DURATION_MS; ms++) {
+        if (ms % 50 == 0) {
+            for (uint8_t track = 0; track < GRID_TRACKS; track++) {
+                uint8_t level = 0;
+                if (track < 4 && ms < 1000) level = static_cast<uint8_t>(60 + ((ms / 50 + track * 7) * 37) % 60);
+                else if (track < 4) level = 70;
+                else if (track < 6) level = 90;
+                meters.input(track, level, ms);
+                readings++;
+            }
+        }
+        if (ms % (1000 / LIVE_METER_HZ) == 0) {
+            const uint8_t length = meters.tick(ms, frame);
+            if (length) {
+                meterBytes += METER_FRAME_OVERHEAD + length;
+            }
+        }
+    }
+    const uint32_t rawBytes = readings * (METER_FRAME_OVERHEAD + 2);
+    const LiveMeterStage::Stats& meterStats = meters.getStats();
+    Serial.printf("  Medidores (3 s, 8 pistas): %lu lecturas → %lu bytes reenviando una a una, "
+                  "%lu frames → %lu bytes (%lu ticks sin cambios) | %s\n",
+                  static_cast<unsigned long>(readings), static_cast<unsigned long>(rawBytes),
+                  static_cast<unsigned long>(meterStats.frames), static_cast<unsigned long>(meterBytes),
+                  static_cast<unsigned long>(meterStats.unchanged),
+                  meterBytes < rawBytes ? "OK" : "FAIL");
+}
+
+// Una pista con un golpe a 100 y silencio después: el nivel baja
+// LIVE_METER_DECAY por frame y el pico se queda LIVE_METER_PEAK_HOLD_MS antes
+// de caer al mismo ritmo
+bool checkMeterDecay() {
+    LiveMeterStage meters;
+    meters.setVisible(0, 1);
+    meters.input(0, 100, 0);
+    meters.input(0, 0, 1);
+    uint8_t frame[LiveMeterStage::MAX_FRAME];
+    uint8_t expectedLevel = 100;
+    uint8_t expectedPeak = 100;
+    uint32_t heldUntil = 0;
+    uint8_t sentLevel = 0;
+    uint8_t sentPeak = 0;
+    bool levelOk = true;
+    bool peakOk = true;
+    for (uint32_t ms = 0; ms <= 2 * LIVE_METER_PEAK_HOLD_MS; ms += 1000 / LIVE_METER_HZ) {
+        const uint8_t length = meters.tick(ms, frame);
+        expectedLevel = expectedLevel > LIVE_METER_DECAY ? expectedLevel - LIVE_METER_DECAY : 0;
+        if (ms >= LIVE_METER_PEAK_HOLD_MS) {
+            const uint8_t fallen = expectedPeak > LIVE_METER_DECAY ? expectedPeak - LIVE_METER_DECAY : 0;
+            expectedPeak = fallen > expectedLevel ? fallen : expectedLevel;
+        } else {
+            heldUntil = ms;
+        }
+        if (length == 4) {
+            levelOk &= frame[2] == expectedLevel;
+            peakOk &= frame[3] == expectedPeak;
+            sentLevel = frame[2];
+            sentPeak = frame[3];
+        } else {
+            // Sin frame solo cuando nada se movió desde el último enviado
+            levelOk &= length == 0 && expectedLevel == sentLevel;
+            peakOk &= length == 0 && expectedPeak == sentPeak;
+        }
+    }
+    const bool ok = levelOk && peakOk && expectedPeak == 0 && heldUntil + 1000 / LIVE_METER_HZ >= LIVE_METER_PEAK_HOLD_MS;
+    Serial.printf("  Caída: nivel -%u por frame %s, pico sostenido %lu ms y luego cae %s | %s\n",
+                  LIVE_METER_DECAY, levelOk ? "sí" : "no", static_cast<unsigned long>(heldUntil),
+                  peakOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Pistas con una señal estable a 20 Hz: tras el primer frame no se envía nada
+bool checkSteadyMeters() {
+    LiveMeterStage meters;
+    uint8_t frame[LiveMeterStage::MAX_FRAME];
+    uint32_t frames = 0;
+    uint32_t framesAfterFirst = 0;
+    for (uint32_t ms = 0; ms < 2000; ms++) {
+        if (ms % 50 == 0) {
+            for (uint8_t track = 0; track < GRID_TRACKS; track++) {
+                meters.input(track, static_cast<uint8_t>(40 + track * 10), ms);
+            }
+        }
+        if (ms % (1000 / LIVE_METER_HZ) == 0 && meters.tick(ms, frame)) {
+            framesAfterFirst += frames > 0;
+            frames++;
+        }
+    }
+    const bool ok = frames == 1 && framesAfterFirst == 0;
+    Serial.printf("  Señal estable (2 s, 8 pistas): %lu frames | %s\n",
+                  static_cast<unsigned long>(frames), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Posiciones de la canción y 4 clips sonando 10 s, anclas cada 50 ms
+// Live las fecha con hasta 6 ms de retraso; a los 5 s el tempo pasa de
+// 120 a 140 BPM y a los 7 s el clip de la pista 2 se relanza desde 0
+// (la única corrección esperada). El error es frente a la posición real
+void benchPositions() {
+    ClipPositionEstimator positions;
+    const uint32_t POSITION_MS = 10000;
+    const uint16_t CLIP_LENGTHS[4] = {64, 128, 256, 64};
+    float truth[5] = {0, 0, 0, 0, 0}; // Pistas 0-3 y canción
+    uint16_t tenths = 1200;
+    uint32_t anchors = 0;
+    uint32_t positionBytes = 0;
+    float maxError = 0;
+    uint8_t positionFrame[ClipPositionEstimator::MAX_FRAME];
+    positions.setTempo(tenths, 0);
+    positions.setRunning(true, 0);
+    for (uint8_t track = 0; track < 4; track++) {
+        positions.setLength(track, 0, CLIP_LENGTHS[track]);
+    }
+    for (uint32_t ms = 0; ms < POSITION_MS; ms++) {
+        if (ms == 5000) {
+            tenths = 1400;
+            positions.setTempo(tenths, ms);
+        }
+        if (ms == 7000) {
+            truth[2] = 0;
+        }
+        for (uint8_t i = 0; i < 5; i++) {
+            truth[i] += tenths * LIVE_POSITION_TICKS_PER_BEAT / 600000.0f;
+            if (i < 4) truth[i] = fmodf(truth[i], CLIP_LENGTHS[i]);
+        }
+        for (uint8_t i = 0; i < 5; i++) {
+            // Ancla tomada 0-6 ms antes de llegar
+            const uint32_t delay = (ms / 50 + i * 3) % 7;
+            if ((ms + i * 10) % 50 != 0 || ms < delay) continue;
+            float sampled = truth[i] - delay * tenths * LIVE_POSITION_TICKS_PER_BEAT / 600000.0f;
+            if (sampled < 0) sampled += i < 4 ? CLIP_LENGTHS[i] : 0;
+            positions.anchor(i < 4 ? i : ClipPositionEstimator::SONG_SLOT, 0,
+                             static_cast<uint16_t>(sampled), ms);
+            anchors++;
+        }
+        if (ms % (1000 / LIVE_POSITION_HZ) == 0) {
+            const uint8_t length = positions.tick(ms, positionFrame);
+            if (length) {
+                positionBytes += METER_FRAME_OVERHEAD + length;
+            }
+            for (uint8_t at = 0; at + 4 <= length; at += 4) {
+                const uint8_t i = positionFrame[at] == ClipPositionEstimator::SONG_SLOT ? 4 : positionFrame[at];
+                const float sent = static_cast<float>((positionFrame[at + 2] << 7) | positionFrame[at + 3]);
+                float error = fabsf(sent - truth[i]);
+                if (i < 4 && error > CLIP_LENGTHS[i] / 2.0f) error = CLIP_LENGTHS[i] - error;
+                if (ms > 7000 && ms < 7100 && i == 2) continue; // Hasta la primera ancla tras el relanzamiento
+                if (error > maxError) maxError = error;
+            }
+        }
+    }
+    const uint32_t relayBytes = anchors * (METER_FRAME_OVERHEAD + 4);
+    const ClipPositionEstimator::Stats& positionStats = positions.getStats();
+    Serial.printf("  Posiciones (10 s, canción + 4 clips): %lu anclas → %lu bytes reenviando una a una, "
+                  "%lu frames → %lu bytes, %lu correcciones, error máx. %.2f ticks | %s\n",
+                  static_cast<unsigned long>(anchors), static_cast<unsigned long>(relayBytes),
+                  static_cast<unsigned long>(positionStats.frames), static_cast<unsigned long>(positionBytes),
+                  static_cast<unsigned long>(positionStats.corrections), maxError,
+                  positionStats.corrections == 1 && maxError <= LIVE_POSITION_TOLERANCE_TICKS + 1 &&
+                          positionBytes < relayBytes ? "OK" : "FAIL");
+}
+
+// Nombres del ring en un set de 16 pistas × 8 escenas, el ring lo recorre
+// Los clips repiten un vocabulario de 12 nombres, como en un set real
+// ("Kick", "Bass"...). Cada posición del ring trae sus 8 + 32 + 4
+// nombres; solo cuentan los que cambian en su slot. Texto: frame con el
+// nombre entero; IDs: CMD_NAME_DEFINE la primera vez y CMD_NAME_REF
+void benchNames() {
+    static const char* const VOCABULARY[] = {"Kick", "Snare", "Hats", "Bass", "Pad", "Lead",
+                                             "Vox Chop", "FX Rise", "Perc Loop", "Chords", "Arp", "Sub"};
+    const uint8_t HEADER = BinaryProtocol::HEADER_SIZE;
+    const uint8_t SLOTS = GRID_TRACKS + TOTAL_KEYS + GRID_SCENES;
+    const uint16_t RING_PATH[][2] = {{0, 0}, {0, 4}, {8, 4}, {8, 0}, {0, 0}, {4, 2}, {8, 4}, {0, 0}};
+    NamePool pool;
+    uint16_t slotId[SLOTS];
+    memset(slotId, 0xFF, sizeof(slotId));
+    uint32_t textBytes = 0;
+    uint32_t idBytes = 0;
+    bool namesOk = true;
+    char name[16];
+    for (const auto& ring : RING_PATH) {
+        for (uint8_t slot = 0; slot < SLOTS; slot++) {
+            uint8_t slotBytes = 1;
+            if (slot < GRID_TRACKS) {
+                snprintf(name, sizeof(name), "Track %u", ring[0] + slot + 1);
+            } else if (slot < GRID_TRACKS + TOTAL_KEYS) {
+                const uint8_t pad = slot - GRID_TRACKS;
+                const uint16_t track = ring[0] + pad % GRID_TRACKS;
+                const uint16_t scene = ring[1] + pad / GRID_TRACKS;
+                snprintf(name, sizeof(name), "%s", VOCABULARY[(track * 5 + scene * 3) % 12]);
+                slotBytes = 2;
+            } else {
+                snprintf(name, sizeof(name), "Scene %u", ring[1] + slot - GRID_TRACKS - TOTAL_KEYS + 1);
+            }
+            const uint8_t length = static_cast<uint8_t>(strlen(name));
+            const uint16_t id = pool.intern(name, length);
+            if (id == slotId[slot]) {
+                continue; // El GUI ya lo muestra en ese slot
+            }
+            pool.retain(id);
+            pool.release(slotId[slot]);
+            slotId[slot] = id;
+            textBytes += HEADER + slotBytes + length;
+            if (!pool.defined(id)) {
+                idBytes += HEADER + 2 + length;
+                pool.markDefined(id);
+            }
+            idBytes += HEADER + 5;
+            uint8_t stored = 0;
+            const char* text = pool.text(id, stored);
+            namesOk &= text && stored == length && memcmp(text, name, length) == 0;
+        }
+    }
+    const uint32_t oldArrays = (GRID_TRACKS + TOTAL_KEYS) * 64;
+    Serial.printf("  Nombres (8 posiciones del ring): texto %lu bytes, IDs %lu bytes, %u nombres en el pool, "
+                  "%lu desalojados; memoria %u bytes (antes %lu) | %s\n",
+                  static_cast<unsigned long>(textBytes), static_cast<unsigned long>(idBytes),
+                  pool.entriesUsed(), static_cast<unsigned long>(pool.getStats().evictions),
+                  static_cast<unsigned>(sizeof(NamePool) + sizeof(slotId) * 2), static_cast<unsigned long>(oldArrays),
+                  namesOk && idBytes < textBytes ? "OK" : "FAIL");
+}
+
+// NamePool directo: solo desaloja nombres sin slot, el ID de una entrada
+// reutilizada cambia de generación y con todo retenido devuelve NONE
+bool checkNamePool() {
+    static NamePool pool;
+    uint16_t ids[NamePool::ENTRIES];
+    char name[8];
+    for (uint8_t i = 0; i < NamePool::ENTRIES; i++) {
+        snprintf(name, sizeof(name), "N%u", i);
+        ids[i] = pool.intern(name, static_cast<uint8_t>(strlen(name)));
+        if (i % 2 == 0) {
+            pool.retain(ids[i]); // Pares en un slot
+        }
+        pool.markDefined(ids[i]);
+    }
+
+    // Lleno: el nuevo ocupa la entrada del impar más antiguo (N1), no la de N0
+    const uint16_t fresh = pool.intern("Fresh", 5);
+    uint8_t length = 0;
+    bool evictOk = fresh != NamePool::NONE && pool.text(ids[1], length) == nullptr;
+    for (uint8_t i = 0; i < NamePool::ENTRIES; i += 2) {
+        evictOk &= pool.text(ids[i], length) != nullptr;
+    }
+    const bool generationOk = (fresh & 0x3F) == (ids[1] & 0x3F) && fresh != ids[1] &&
+                              !pool.defined(fresh) && !pool.defined(ids[1]);
+
+    // Con todas las entradas retenidas no queda sitio
+    pool.retain(fresh);
+    for (uint8_t i = 3; i < NamePool::ENTRIES; i += 2) {
+        pool.retain(ids[i]);
+    }
+    const uint32_t fullBefore = pool.getStats().full;
+    const bool fullOk = pool.intern("Nope", 4) == NamePool::NONE && pool.getStats().full == fullBefore + 1 &&
+                        pool.text(fresh, length) != nullptr;
+
+    // Al soltar uno vuelve a haber sitio, en su entrada
+    pool.release(ids[5]);
+    const uint16_t again = pool.intern("Nope", 4);
+    const bool reuseOk = again != NamePool::NONE && (again & 0x3F) == (ids[5] & 0x3F);
+
+    const bool ok = evictOk && generationOk && fullOk && reuseOk;
+    Serial.printf("  NamePool: desaloja solo sin slot %s, generación nueva %s, NONE lleno %s, reutiliza %s | %s\n",
+                  evictOk ? "sí" : "no", generationOk ? "sí" : "no", fullOk ? "sí" : "no",
+                  reuseOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Frame de Live completo (F0 7F 00 7F CMD SEQ LEN LEN payload CHK F7); devuelve su longitud
+uint16_t buildLiveFrame(uint8_t* out, uint8_t command, uint8_t sequence, uint16_t payloadLen) {
+    uint16_t n = 0;
+    out[n++] = SYSEX_START;
+    out[n++] = MANUFACTURER_ID;
+    out[n++] = DEVICE_ID;
+    out[n++] = 0x7F;
+    out[n++] = command;
+    out[n++] = sequence;
+    out[n++] = static_cast<uint8_t>(payloadLen >> 7);
+    out[n++] = static_cast<uint8_t>(payloadLen & 0x7F);
+    uint8_t checksum = command ^ sequence;
+    for (uint16_t i = 0; i < payloadLen; i++) {
+        out[n] = static_cast<uint8_t>((i * 13 + sequence) & 0x7F);
+        checksum ^= out[n++];
+    }
+    out[n++] = checksum & 0x7F;
+    out[n++] = SYSEX_END;
+    return n;
+}
+
+// LiveSysExAssembler con un buffer de 64 bytes: frame en trozos de 7 bytes,
+// frame truncado por el driver y frame más grande que el buffer. Tras cada
+// rechazo el siguiente frame bueno debe pasar
+bool checkSysExAssembler() {
+    static uint8_t storage[64];
+    static uint8_t wire[128];
+    LiveSysExAssembler assembler(storage, sizeof(storage));
+    uint16_t completed = 0;
+    uint16_t lastPayload = 0;
+    auto onMessage = [&]() {
+        completed += assembler.isLiveFrame();
+        lastPayload = assembler.payloadLength();
+    };
+
+    // Partido: el driver lo entrega en trozos, solo el último marca el final
+    const uint16_t splitLen = buildLiveFrame(wire, CMD_CLIP_NAME, 1, 40);
+    for (uint16_t at = 0; at < splitLen; at += 7) {
+        const uint16_t piece = splitLen - at < 7 ? splitLen - at : 7;
+        assembler.feed(&wire[at], piece, at + piece == splitLen, onMessage);
+    }
+    const bool splitOk = completed == 1 && lastPayload == 40 && assembler.command() == CMD_CLIP_NAME &&
+                         assembler.sequence() == 1 && assembler.payload()[3] == ((3 * 13 + 1) & 0x7F);
+
+    // Truncado: el driver da el mensaje por terminado sin F7
+    const uint16_t fullLen = buildLiveFrame(wire, CMD_TRACK_NAME, 2, 12);
+    const uint8_t truncRejected = assembler.feed(wire, fullLen / 2, true, onMessage);
+    const bool truncReasonOk = assembler.lastRejectReason() == LiveSysExAssembler::Reason::TRUNCATED;
+    assembler.feed(wire, fullLen, true, onMessage);
+    const bool truncOk = truncRejected == 1 && truncReasonOk && completed == 2 && lastPayload == 12;
+
+    // Más grande que el buffer: se descarta hasta su F7, sin tocar al siguiente
+    const uint16_t bigLen = buildLiveFrame(wire, CMD_CLIP_NAME, 3, 80);
+    const uint8_t bigRejected = assembler.feed(wire, bigLen, true, onMessage);
+    const bool bigReasonOk = assembler.lastRejectReason() == LiveSysExAssembler::Reason::TOO_LARGE;
+    const uint16_t nextLen = buildLiveFrame(wire, CMD_TRACK_NAME, 4, 8);
+    assembler.feed(wire, nextLen, true, onMessage);
+    const bool bigOk = bigRejected == 1 && bigReasonOk && completed == 3 && lastPayload == 8;
+
+    const bool ok = splitOk && truncOk && bigOk && assembler.getStats().rejected == 2;
+    Serial.printf("  SysEx: partido en trozos %s, truncado %s, mayor que el buffer %s | %s\n",
+                  splitOk ? "sí" : "no", truncOk ? "sí" : "no", bigOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// LiveSequenceTracker: SEQ que pasa de 127 a 0, un duplicado y un hueco
+// que cruza la vuelta, culpado a las áreas de sus vecinos
+bool checkSequenceTracker() {
+    LiveSequenceTracker tracker;
+    uint8_t resyncs = 0;
+    for (uint16_t seq = 120; seq < 136; seq++) {
+        resyncs |= tracker.received(CMD_CLIP_STATE, static_cast<uint8_t>(seq & 0x7F));
+    }
+    const bool wrapOk = resyncs == 0 && tracker.getStats().gaps == 0;
+
+    const uint8_t duplicate = tracker.received(CMD_CLIP_STATE, 7);
+    const bool duplicateOk = duplicate == 0 && tracker.getStats().duplicates == 1 && tracker.getStats().gaps == 0;
+
+    // 7 → 125 y 125 → 2 (se pierden 126, 127, 0 y 1)
+    for (uint8_t seq = 8; seq != 126; seq++) {
+        tracker.received(CMD_CLIP_STATE, seq);
+    }
+    const uint8_t areas = tracker.received(CMD_MIXER_VOLUME, 2);
+    const LiveSequenceTracker::Stats& stats = tracker.getStats();
+    const bool gapOk = areas == (LiveSequenceTracker::AREA_GRID | LiveSequenceTracker::AREA_MIXER) &&
+                       stats.gaps == 1 && stats.missing == 4;
+
+    const uint8_t first = tracker.nextOutbound();
+    for (uint8_t i = 1; i < 128; i++) {
+        tracker.nextOutbound();
+    }
+    const bool outboundOk = tracker.nextOutbound() == first;
+
+    const bool ok = wrapOk && duplicateOk && gapOk && outboundOk;
+    Serial.printf("  SEQ: vuelta 127→0 %s, duplicado %s, hueco de %lu (áreas 0x%02X) %s, salida cíclica %s | %s\n",
+                  wrapOk ? "sí" : "no", duplicateOk ? "sí" : "no", static_cast<unsigned long>(stats.missing),
+                  areas, gapOk ? "sí" : "no", outboundOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// CMD_SESSION_RING_METADATA con 2 pistas (la primera con un nombre de 100
+// caracteres) y 1 escena: el nombre largo se corta a 63 y lo que sigue se lee
+// en su sitio
+bool checkRingMetadata() {
+    static uint8_t payload[160];
+    uint16_t n = 0;
+    payload[n++] = 2;
+    payload[n++] = 100;
+    for (uint8_t i = 0; i < 100; i++) payload[n++] = static_cast<uint8_t>('a' + i % 26);
+    payload[n++] = 10; payload[n++] = 20; payload[n++] = 30;
+    payload[n++] = 4;
+    memcpy(&payload[n], "Bass", 4); n += 4;
+    payload[n++] = 40; payload[n++] = 50; payload[n++] = 60;
+    payload[n++] = 1;
+    payload[n++] = 5;
+    memcpy(&payload[n], "Intro", 5); n += 5;
+    payload[n++] = 70; payload[n++] = 80; payload[n++] = 90;
+
+    RingMetadataReader reader(payload, n);
+    char name[64];
+    memset(name, 0x55, sizeof(name));
+    uint8_t count = 0, nameLen = 0, r = 0, g = 0, b = 0;
+    bool ok = reader.count(count) && count == 2 &&
+              reader.entry(name, sizeof(name), nameLen, r, g, b) && nameLen == 63 && name[63] == '\0' &&
+              name[62] == 'a' + 62 % 26 && r == 10 && g == 20 && b == 30;
+    const bool longOk = ok;
+    const uint8_t longLen = nameLen;
+    ok &= reader.entry(name, sizeof(name), nameLen, r, g, b) && nameLen == 4 && strcmp(name, "Bass") == 0 &&
+          r == 40 && b == 60;
+    ok &= reader.count(count) && count == 1 &&
+          reader.entry(name, sizeof(name), nameLen, r, g, b) && strcmp(name, "Intro") == 0 && b == 90;
+    ok &= !reader.count(count);
+
+    // Cortado a media entrada: no se lee nada fuera del payload
+    RingMetadataReader cut(payload, 50);
+    ok &= cut.count(count) && !cut.entry(name, sizeof(name), nameLen, r, g, b);
+    Serial.printf("  Ring metadata: nombre de 100 → %u caracteres %s, entradas siguientes en su sitio | %s\n",
+                  longLen, longOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ========== SETUP ==========
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000);
+    delay(1000);
+
+    Serial.println();
+    Serial.println("╔══════════════════════════════════════════╗");
+    Serial.println("║  TEST: LIVE DISPATCH BENCH (Teensy)     ║");
+    Serial.println("╚══════════════════════════════════════════╝");
+    Serial.println();
+
+    // Habilitar contador de ciclos DWT
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+
+    buildSetLoadStream();
+    Serial.printf("CPU: %lu MHz, %u mensajes (%u bytes de payload) × %u pasadas\n\n",
+                  static_cast<unsigned long>(F_CPU_ACTUAL / 1000000UL),
+                  messageCount, streamLen, ITERATIONS);
+    benchDispatch();
+
+    Serial.println();
+    benchModel();
+    benchAutomation();
+    benchMeters();
+    checkMeterDecay();
+    checkSteadyMeters();
+    benchPositions();
+    benchNames();
+    checkNamePool();
+    checkSysExAssembler();
+    checkSequenceTracker();
+    checkRingMetadata();
+    Serial.println("\n✓ Benchmark completo");
+}
+
+// ========== LOOP PRINCIPAL ==========
+void loop() {
+}
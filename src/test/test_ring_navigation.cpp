@@ -0,0 +1,221 @@
+/*
+ * TEST: SESSION RING NAVIGATION (MENSAJES Y BYTES)
+ * ================================================
+ *
+ * PROPÓSITO:
+ * Contar los SysEx y los bytes en cable que cuesta cada gesto de navegación
+ * del session ring, antes y después de RingNavigator:
+ * - Antes: un CMD_RING_NAVIGATE por paso, y Live responde a cada uno con
+ *   CMD_RING_POSITION y el grid entero (CMD_SESSION_RING_CLIPS).
+ * - Después: las pulsaciones dentro de LIVE_RING_NAV_MERGE_MS se funden en
+ *   un solo CMD_RING_POSITION absoluto, y Live responde con un solo grid.
+ * El tiempo es simulado (pasos de 1 ms) y Live contesta al instante, así que
+ * lo medido es el número de mensajes, no la latencia del USB.
+ * Después, pulsaciones más allá del borde derecho del set: Live recorta la
+ * posición y su respuesta debe cerrar la espera sin timeout. Por último, la
+ * ventana que ClipPrefetchCache pide a Live (missingBounds) al moverse.
+ *
+ * HARDWARE:
+ * - Solo la Teensy 4.1 (no necesita Live, M4 ni GUI conectados)
+ *
+ * CÓMO COMPILAR Y EJECUTAR:
+ * pio run -e test_ring_navigation_teensy -t upload && pio device monitor
+ *
+ * AUTOR: Push Clone Project
+ */
+
+#include <Arduino.h>
+#include "MidiCommands.h"
+#include "LiveController/RingNavigator.h"
+#include "LiveStateModel/ClipPrefetchCache.h"
+
+// ========== CONFIGURACIÓN ==========
+// Frame de Live: F0 7F 00 7F CMD SEQ LEN LEN [payload] CHK F7
+const uint16_t FRAME_OVERHEAD = 10;
+const uint16_t NAVIGATE_PAYLOAD = 1;
+const uint16_t POSITION_PAYLOAD = 7;
+const uint16_t RING_CLIPS_PAYLOAD = TOTAL_KEYS * 4;
+
+struct Press {
+    uint16_t at;      // ms desde el inicio del gesto
+    int8_t dx;
+    int8_t dy;
+};
+
+struct Gesture {
+    const char* name;
+    const Press* presses;
+    uint8_t count;
+};
+
+const Press SINGLE[] = {{0, 1, 0}};
+const Press BANK[] = {{0, 0, GRID_SCENES}};                  // CMD_GRID_BANK_UP
+const Press BURST[] = {{0, 1, 0}, {15, 1, 0}, {30, 1, 0}};   // Tres pulsaciones rápidas
+const Press HOLD[] = {{0, 0, 1}, {10, 0, 1}, {20, 0, 1}, {30, 0, 1}, {35, 1, 0}, {38, 1, 0}};
+const Press SLOW[] = {{0, 1, 0}, {120, 1, 0}, {240, 1, 0}};  // Más lentas que la ventana
+
+const Gesture GESTURES[] = {
+    {"1 paso", SINGLE, 1},
+    {"Bank (4 escenas)", BANK, 1},
+    {"3 pulsaciones / 15 ms", BURST, 3},
+    {"6 pulsaciones / 38 ms", HOLD, 6},
+    {"3 pulsaciones / 120 ms", SLOW, 3},
+};
+
+struct Traffic {
+    uint16_t messages = 0;
+    uint32_t bytes = 0;
+
+    void frame(uint16_t payload) {
+        messages++;
+        bytes += FRAME_OVERHEAD + payload;
+    }
+};
+
+// Set de SET_TRACKS pistas: Live recorta el origen del ring a SET_TRACKS - GRID_TRACKS
+const uint16_t SET_TRACKS = 16;
+
+// Pulsaciones hacia la derecha desde el borde; Live contesta con la posición recortada
+bool checkEdgeClamp(RingNavigator& nav, uint32_t& now) {
+    const uint16_t edge = SET_TRACKS - GRID_TRACKS;
+    nav.reported(edge, 0);
+    const uint32_t timeoutsBefore = nav.getStats().timeouts;
+    nav.move(1, 0, now);
+    nav.move(1, 0, now + 10);
+    bool clamped = false;
+    while (nav.moving() && now < 100000) {
+        if (nav.takeDue(now)) {
+            const uint16_t answer = nav.track() > edge ? edge : nav.track();
+            clamped = nav.reported(answer, nav.scene());
+        }
+        if (nav.takeTimeout(now)) {
+            break;
+        }
+        now++;
+    }
+    const bool ok = clamped && !nav.moving() && nav.track() == edge && nav.liveTrack() == edge &&
+                    nav.getStats().timeouts == timeoutsBefore;
+    Serial.printf("  Borde derecho (origen %u, 2 pasos): respuesta recortada %s, objetivo %u, sin timeout | %s\n",
+                  edge, clamped ? "aceptada" : "ignorada", nav.track(), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Ventana 8×4 en (8, 4): missingBounds la reduce a lo que falta en la caché
+bool checkMissingBounds() {
+    static ClipPrefetchCache cache;
+    const uint16_t originTrack = 8;
+    const uint16_t originScene = 4;
+    uint16_t track = originTrack, scene = originScene;
+    uint8_t width = GRID_TRACKS, height = GRID_SCENES;
+    const bool emptyOk = cache.missingBounds(track, scene, width, height) && track == originTrack &&
+                         scene == originScene && width == GRID_TRACKS && height == GRID_SCENES;
+
+    // Todo guardado salvo la pista 10 en las escenas 5 y 6
+    for (uint16_t s = originScene; s < originScene + GRID_SCENES; s++) {
+        for (uint16_t t = originTrack; t < originTrack + GRID_TRACKS; t++) {
+            if (t != 10 || (s != 5 && s != 6)) {
+                cache.store(t, s, 1, 10, 20, 30);
+            }
+        }
+    }
+    track = originTrack, scene = originScene, width = GRID_TRACKS, height = GRID_SCENES;
+    const bool holeOk = cache.missingBounds(track, scene, width, height) && track == 10 && scene == 5 &&
+                        width == 1 && height == 2;
+
+    cache.store(10, 5, 1, 10, 20, 30);
+    cache.store(10, 6, 1, 10, 20, 30);
+    track = originTrack, scene = originScene, width = GRID_TRACKS, height = GRID_SCENES;
+    const bool fullOk = !cache.missingBounds(track, scene, width, height);
+
+    // Mismo slot una ventana de caché más allá: desplaza al clip (8, 4)
+    cache.store(originTrack + ClipPrefetchCache::WIDTH, originScene, 1, 0, 0, 0);
+    track = originTrack, scene = originScene, width = GRID_TRACKS, height = GRID_SCENES;
+    const bool displacedOk = cache.missingBounds(track, scene, width, height) && track == originTrack &&
+                             scene == originScene && width == 1 && height == 1;
+
+    const bool ok = emptyOk && holeOk && fullOk && displacedOk;
+    Serial.printf("  ClipPrefetchCache::missingBounds: vacía %s, hueco 1×2 %s, completa %s, slot desplazado %s | %s\n",
+                  emptyOk ? "sí" : "no", holeOk ? "sí" : "no", fullOk ? "sí" : "no",
+                  displacedOk ? "sí" : "no", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ========== SETUP ==========
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000);
+    delay(1000);
+
+    Serial.println();
+    Serial.println("╔══════════════════════════════════════════╗");
+    Serial.println("║  TEST: RING NAVIGATION (Teensy)         ║");
+    Serial.println("╚══════════════════════════════════════════╝");
+    Serial.println();
+    Serial.printf("Ventana de fusión: %u ms. Bytes = frames SysEx completos (HW → Live + Live → HW)\n\n",
+                  LIVE_RING_NAV_MERGE_MS);
+    Serial.println(" Gesto                     Antes: msgs  bytes   Después: msgs  bytes");
+
+    bool allOk = true;
+    uint32_t now = 1000;
+    RingNavigator nav;
+    nav.reported(8, 8); // Lejos del borde: ningún paso se recorta en 0
+
+    for (const Gesture& gesture : GESTURES) {
+        Traffic before;
+        Traffic after;
+        int track = nav.track();
+        int scene = nav.scene();
+        const uint32_t start = now;
+        uint8_t next = 0;
+
+        // Pulsaciones y ventanas de fusión, en pasos de 1 ms
+        while (next < gesture.count || nav.moving()) {
+            while (next < gesture.count && now - start >= gesture.presses[next].at) {
+                const Press& press = gesture.presses[next++];
+                nav.move(press.dx, press.dy, now);
+                track += press.dx;
+                scene += press.dy;
+
+                // Antes: un CMD_RING_NAVIGATE por paso, y por cada uno posición + grid de Live
+                const uint16_t steps = static_cast<uint16_t>(abs(press.dx) + abs(press.dy));
+                for (uint16_t s = 0; s < steps; ++s) {
+                    before.frame(NAVIGATE_PAYLOAD);
+                    before.frame(POSITION_PAYLOAD);
+                    before.frame(RING_CLIPS_PAYLOAD);
+                }
+            }
+            if (nav.takeDue(now)) {
+                // Después: una posición absoluta; Live la confirma con posición + grid
+                after.frame(POSITION_PAYLOAD);
+                after.frame(POSITION_PAYLOAD);
+                after.frame(RING_CLIPS_PAYLOAD);
+                nav.reported(nav.track(), nav.scene());
+            }
+            now++;
+        }
+        now += 500; // Pausa entre gestos
+
+        const bool ok = nav.track() == track && nav.scene() == scene && after.messages <= before.messages;
+        allOk &= ok;
+        Serial.printf(" %-24s %8u %7lu %14u %7lu  %s\n", gesture.name,
+                      before.messages, static_cast<unsigned long>(before.bytes),
+                      after.messages, static_cast<unsigned long>(after.bytes),
+                      ok ? "OK" : "FAIL");
+    }
+
+    Serial.println();
+    allOk &= checkEdgeClamp(nav, now);
+    allOk &= checkMissingBounds();
+
+    const RingNavigator::Stats& stats = nav.getStats();
+    Serial.printf("\n  %lu pulsaciones enviadas como %lu posiciones, %lu sin confirmar | %s\n",
+                  static_cast<unsigned long>(stats.moves),
+                  static_cast<unsigned long>(stats.positions),
+                  static_cast<unsigned long>(stats.timeouts),
+                  allOk && stats.timeouts == 0 ? "OK" : "FAIL");
+    Serial.println("\n✓ Test completo");
+}
+
+// ========== LOOP PRINCIPAL ==========
+void loop() {
+}